@@ -0,0 +1,288 @@
+/// \file bench.cpp
+///
+/// \brief This file implements `ispd_bench`, the microbenchmarks of the model's
+/// hot paths, which are measured outside of the ROSS' event loop.
+///
+/// The benchmarks cover the route lookups, the machine's core selection, the
+/// workload and interarrival generators, the service configurations' timing
+/// functions and the message's construction and copy. ROSS is initialized so
+/// that the generators can draw from a reversible random number stream, but
+/// the simulation is never run.
+///
+/// Usage: ispd_bench [--bench-filter=routing] [--bench-json=bench.json]
+///
+#include <array>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+#include <ross.h>
+#include <ispd/log/log.hpp>
+#include <ispd/model/builder.hpp>
+#include <ispd/routing/routing.hpp>
+#include <ispd/message/message.hpp>
+#include <ispd/services/machine.hpp>
+#include <ispd/workload/workload.hpp>
+#include <ispd/workload/interarrival.hpp>
+#include <ispd/configuration/link.hpp>
+#include <ispd/configuration/machine.hpp>
+#include "harness.hpp"
+
+using ispd::bench::clobberMemory;
+using ispd::bench::doNotOptimize;
+using ispd::bench::Harness;
+
+static char g_bench_filter[128] = "";
+static char g_bench_json[256] = "";
+static double g_bench_min_time = 0.1;
+static unsigned g_bench_samples = 5;
+
+const tw_optdef opt[] = {
+    TWOPT_GROUP("iSPD Benchmarks"),
+    TWOPT_CHAR("bench-filter", g_bench_filter,
+               "only run the benchmarks whose name contains this text"),
+    TWOPT_CHAR("bench-json", g_bench_json,
+               "file to which the results are written as JSON"),
+    TWOPT_DOUBLE("bench-min-time", g_bench_min_time,
+                 "minimum duration (in seconds) of each sample"),
+    TWOPT_UINT("bench-samples", g_bench_samples,
+               "amount of samples of each benchmark"),
+    TWOPT_END(),
+};
+
+/// \brief The amount of precomputed inputs of each benchmark, which is a power
+///        of two so that they can be cycled through by a mask.
+static constexpr std::size_t INPUTS = 4096;
+
+/// \brief Returns a deterministic sequence of pseudorandom inputs.
+static std::vector<std::uint64_t> makeInputs(const std::uint64_t bound) {
+  std::vector<std::uint64_t> inputs(INPUTS);
+  std::uint64_t state = 0x9E3779B97F4A7C15ull;
+
+  for (auto &input : inputs) {
+    state = state * 6364136223846793005ull + 1442695040888963407ull;
+    input = (state >> 33) % bound;
+  }
+
+  return inputs;
+}
+
+/// \brief Registers the route lookups of tables with N x N routes.
+static void addRoutingBenchmarks(Harness &harness) {
+  for (const tw_lpid endpoints : {4, 32, 256}) {
+    auto table = std::make_shared<ispd::routing::RoutingTable>();
+
+    for (tw_lpid src = 0; src < endpoints; src++)
+      for (tw_lpid dest = 0; dest < endpoints; dest++)
+        table->registerRoute(src, dest, {src, endpoints + dest, dest});
+
+    const auto inputs = makeInputs(endpoints * endpoints);
+    harness.add("routing/get_route/" + std::to_string(endpoints * endpoints),
+                [table, inputs, endpoints](const std::uint64_t iterations) {
+                  for (std::uint64_t i = 0; i < iterations; i++) {
+                    const auto input = inputs[i & (INPUTS - 1)];
+                    doNotOptimize(table->getRoute(input / endpoints,
+                                                  input % endpoints));
+                  }
+                });
+  }
+}
+
+/// \brief Registers the machine's core selection across core counts.
+static void addMachineBenchmarks(Harness &harness) {
+  for (const unsigned cores : {1, 4, 16, 64, 256}) {
+    std::vector<double> freeTimes(cores);
+    const auto inputs = makeInputs(1000000);
+
+    harness.add(
+        "machine/least_core_time/" + std::to_string(cores),
+        [freeTimes, inputs](const std::uint64_t iterations) mutable {
+          for (std::uint64_t i = 0; i < iterations; i++) {
+            unsigned core;
+            const double least =
+                ispd::services::machine::least_core_time(freeTimes, core);
+
+            /// The selected core becomes busy, as in the machine's handler.
+            freeTimes[core] = least + inputs[i & (INPUTS - 1)];
+            doNotOptimize(core);
+          }
+        });
+  }
+}
+
+/// \brief Registers the generation of a workload's tasks.
+static void addWorkloadBenchmark(Harness &harness, const std::string &name,
+                                 ispd::workload::Workload *const workload,
+                                 tw_rng_stream *const rng) {
+  std::shared_ptr<ispd::workload::Workload> shared(workload);
+
+  harness.add("workload/" + name,
+              [shared, rng](const std::uint64_t iterations) {
+                double procSize, commSize;
+
+                for (std::uint64_t i = 0; i < iterations; i++) {
+                  shared->generateWorkload(rng, procSize, commSize);
+                  doNotOptimize(procSize);
+                  doNotOptimize(commSize);
+                }
+              });
+}
+
+/// \brief Registers the generation of interarrival times.
+static void addInterarrivalBenchmark(
+    Harness &harness, const std::string &name,
+    std::shared_ptr<ispd::workload::InterarrivalDistribution> dist,
+    tw_rng_stream *const rng) {
+  harness.add("interarrival/" + name,
+              [dist, rng](const std::uint64_t iterations) {
+                double offset;
+
+                for (std::uint64_t i = 0; i < iterations; i++) {
+                  dist->generateInterarrival(rng, offset);
+                  doNotOptimize(offset);
+                }
+              });
+}
+
+/// \brief Registers the workload and the interarrival generators.
+///
+/// \note The null workload is not measured, since it cannot generate tasks.
+static void addGeneratorBenchmarks(Harness &harness, tw_rng_stream *const rng) {
+  using namespace ispd::workload;
+
+  /// The tasks are never exhausted by the benchmarks.
+  const unsigned tasks = std::numeric_limits<unsigned>::max();
+  ispd::this_model::registerUser("bench", 0.0);
+
+  addWorkloadBenchmark(
+      harness, "constant",
+      constant("bench", tasks, 200.0, 80.0, 0.0,
+               std::make_unique<FixedInterarrivalDistribution>(1.0)),
+      rng);
+  addWorkloadBenchmark(
+      harness, "uniform",
+      uniform("bench", tasks, 100.0, 300.0, 40.0, 120.0, 0.0,
+              std::make_unique<FixedInterarrivalDistribution>(1.0)),
+      rng);
+  addWorkloadBenchmark(
+      harness, "two_stage",
+      twoStage("bench", tasks, 0.0, {100.0, 200.0, 300.0, 0.5},
+               {40.0, 80.0, 120.0, 0.5},
+               std::make_unique<FixedInterarrivalDistribution>(1.0)),
+      rng);
+
+  addInterarrivalBenchmark(
+      harness, "fixed", std::make_shared<FixedInterarrivalDistribution>(1.0),
+      rng);
+  addInterarrivalBenchmark(
+      harness, "exponential",
+      std::make_shared<ExponentialInterarrivalDistribution>(0.5), rng);
+  addInterarrivalBenchmark(
+      harness, "poisson",
+      std::make_shared<PoissonInterarrivalDistribution>(0.5), rng);
+  addInterarrivalBenchmark(
+      harness, "weibull",
+      std::make_shared<WeibullInterarrivalDistribution>(2.0, 1.5), rng);
+}
+
+/// \brief Registers the service configurations' timing functions.
+static void addConfigurationBenchmarks(Harness &harness) {
+  const auto inputs = makeInputs(1000);
+
+  harness.add("configuration/time_to_process",
+              [inputs](const std::uint64_t iterations) {
+                ispd::configuration::MachineConfiguration conf(
+                    2000.0, 0.1, 8, 8000.0, 64, 16.0, 50.0, 200.0);
+                doNotOptimize(conf);
+
+                for (std::uint64_t i = 0; i < iterations; i++) {
+                  const double size = inputs[i & (INPUTS - 1)];
+                  doNotOptimize(conf.timeToProcess(size, size, 0.25));
+                }
+              });
+
+  harness.add("configuration/time_to_communicate",
+              [inputs](const std::uint64_t iterations) {
+                ispd::configuration::LinkConfiguration conf(1000.0, 0.1, 1e-4);
+                doNotOptimize(conf);
+
+                for (std::uint64_t i = 0; i < iterations; i++)
+                  doNotOptimize(conf.timeToCommunicate(inputs[i & (INPUTS - 1)]));
+              });
+}
+
+/// \brief Registers the message's construction and copy into event buffers.
+static void addMessageBenchmarks(Harness &harness) {
+  /// The messages are written into a ring of buffers, as they would be
+  /// written into the events' data.
+  static constexpr std::size_t BUFFERS = 64;
+
+  harness.add("message/construct", [](const std::uint64_t iterations) {
+    std::array<ispd_message, BUFFERS> buffers;
+
+    for (std::uint64_t i = 0; i < iterations; i++) {
+      ispd_message *const m = &buffers[i & (BUFFERS - 1)];
+
+      *m = ispd_message{};
+      m->type = message_type::ARRIVAL;
+      m->task.m_ProcSize = static_cast<double>(i);
+      m->task.m_Origin = i;
+      m->previous_service_id = i;
+      m->downward_direction = 1;
+      doNotOptimize(m);
+      clobberMemory();
+    }
+  });
+
+  harness.add("message/copy", [](const std::uint64_t iterations) {
+    std::array<ispd_message, BUFFERS> buffers{};
+
+    for (std::uint64_t i = 0; i < iterations; i++) {
+      const ispd_message *const msg = &buffers[i & (BUFFERS - 1)];
+      ispd_message *const m = &buffers[(i + 1) & (BUFFERS - 1)];
+
+      *m = *msg;
+      m->route_offset++;
+      doNotOptimize(m);
+      clobberMemory();
+    }
+  });
+}
+
+int main(int argc, char **argv) {
+  ispd::log::setOutputFile(nullptr);
+
+  tw_opt_add(opt);
+  tw_init(&argc, &argv);
+
+  /// A single logical process is defined so that its random number stream is
+  /// seeded as in a simulation.
+  tw_define_lps(1, sizeof(ispd_message));
+  tw_rand_init_streams(g_tw_lp[0], 1, 0);
+
+  Harness harness(g_bench_min_time, g_bench_samples);
+  addRoutingBenchmarks(harness);
+  addMachineBenchmarks(harness);
+  addGeneratorBenchmarks(harness, g_tw_lp[0]->rng);
+  addConfigurationBenchmarks(harness);
+  addMessageBenchmarks(harness);
+
+  /// The benchmarks are single-threaded and are only run by the master node.
+  if (g_tw_mynode == 0) {
+    harness.run(g_bench_filter);
+
+    if (g_bench_json[0] != '\0') {
+      std::FILE *file = std::fopen(g_bench_json, "w");
+      if (!file)
+        ispd_error("Benchmark results %s could not be opened.", g_bench_json);
+
+      harness.write(file);
+      std::fclose(file);
+      ispd_info("The benchmark results have been written to %s.",
+                g_bench_json);
+    }
+  }
+
+  tw_end();
+  return 0;
+}
@@ -0,0 +1,155 @@
+/// \file harness.hpp
+///
+/// \brief This file defines a small in-tree microbenchmark harness, which is
+/// used by `ispd_bench` instead of an external benchmark library.
+///
+/// Each benchmark is a function that runs its body for a given amount of
+/// iterations. The harness calibrates the amount of iterations so that a
+/// sample lasts at least the requested time, takes several samples and keeps
+/// the minimum, the median and the maximum time per iteration, which are
+/// written as JSON so that the results can be tracked over time.
+///
+#ifndef ISPD_BENCH_HARNESS_HPP
+#define ISPD_BENCH_HARNESS_HPP
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdint>
+#include <algorithm>
+#include <functional>
+#include <ispd/report/json.hpp>
+
+namespace ispd::bench {
+
+/// \brief Prevents the compiler from optimizing the specified value away.
+template <typename T> inline void doNotOptimize(const T &value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/// \brief Prevents the compiler from caching memory across this point.
+inline void clobberMemory() { asm volatile("" : : : "memory"); }
+
+/// \struct Benchmark
+///
+/// \brief A registered benchmark.
+struct Benchmark final {
+  std::string m_Name; ///< The benchmark's name.
+
+  /// \brief The benchmark's body, which runs the specified amount of
+  ///        iterations.
+  std::function<void(std::uint64_t)> m_Run;
+};
+
+/// \struct BenchmarkResult
+///
+/// \brief The measured times of a benchmark.
+struct BenchmarkResult final {
+  std::string m_Name;         ///< The benchmark's name.
+  std::uint64_t m_Iterations; ///< The amount of iterations per sample.
+  double m_Min;               ///< The fastest sample (in ns per iteration).
+  double m_Median;            ///< The median sample (in ns per iteration).
+  double m_Max;               ///< The slowest sample (in ns per iteration).
+};
+
+/// \class Harness
+///
+/// \brief Registers, runs and reports the benchmarks.
+class Harness final {
+public:
+  /// \brief Constructor for Harness.
+  ///
+  /// \param minTime The minimum duration (in seconds) of each sample.
+  /// \param samples The amount of samples of each benchmark.
+  explicit Harness(const double minTime, const unsigned samples) noexcept
+      : m_MinTime(minTime), m_Samples(std::max(samples, 1u)) {}
+
+  /// \brief Registers a benchmark.
+  void add(std::string name, std::function<void(std::uint64_t)> run) {
+    m_Benchmarks.push_back(Benchmark{std::move(name), std::move(run)});
+  }
+
+  /// \brief Runs the benchmarks whose name contains the filter.
+  void run(const std::string &filter) {
+    std::printf("%-48s %14s %12s %12s %12s\n", "Benchmark", "Iterations",
+                "Min (ns)", "Median (ns)", "Max (ns)");
+
+    for (const auto &benchmark : m_Benchmarks) {
+      if (benchmark.m_Name.find(filter) == std::string::npos)
+        continue;
+
+      const auto &result = m_Results.emplace_back(measure(benchmark));
+      std::printf("%-48s %14lu %12.2lf %12.2lf %12.2lf\n",
+                  result.m_Name.c_str(),
+                  static_cast<unsigned long>(result.m_Iterations),
+                  result.m_Min, result.m_Median, result.m_Max);
+    }
+  }
+
+  /// \brief Writes the results as JSON.
+  void write(std::FILE *file) const {
+    ispd::report::JsonWriter json(file);
+
+    json.beginObject();
+    json.field("version", std::uint64_t{1});
+    json.field("min_time", m_MinTime);
+    json.field("samples", m_Samples);
+
+    json.beginArray("benchmarks");
+    for (const auto &result : m_Results) {
+      json.beginObject();
+      json.field("name", result.m_Name);
+      json.field("iterations", result.m_Iterations);
+      json.field("min_ns", result.m_Min);
+      json.field("median_ns", result.m_Median);
+      json.field("max_ns", result.m_Max);
+      json.endObject();
+    }
+    json.endArray();
+
+    json.endObject();
+    std::fputc('\n', file);
+  }
+
+private:
+  /// \brief Returns the duration (in seconds) of the specified iterations.
+  static double time(const Benchmark &benchmark,
+                     const std::uint64_t iterations) {
+    const auto start = std::chrono::steady_clock::now();
+    benchmark.m_Run(iterations);
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+  }
+
+  /// \brief Calibrates the amount of iterations and samples the benchmark.
+  BenchmarkResult measure(const Benchmark &benchmark) const {
+    /// The amount of iterations grows until a sample lasts at least the
+    /// minimum time, which also warms the caches and the branch predictors.
+    std::uint64_t iterations = 1;
+    for (double elapsed = time(benchmark, iterations); elapsed < m_MinTime;
+         elapsed = time(benchmark, iterations)) {
+      const double growth = elapsed > 0.0 ? 1.5 * m_MinTime / elapsed : 10.0;
+      iterations = static_cast<std::uint64_t>(
+          iterations * std::clamp(growth, 2.0, 10.0));
+    }
+
+    std::vector<double> samples(m_Samples);
+    for (auto &sample : samples)
+      sample = time(benchmark, iterations) * 1e9 / iterations;
+
+    std::sort(samples.begin(), samples.end());
+    return BenchmarkResult{benchmark.m_Name, iterations, samples.front(),
+                           samples[samples.size() / 2], samples.back()};
+  }
+
+  double m_MinTime;
+  unsigned m_Samples;
+  std::vector<Benchmark> m_Benchmarks;
+  std::vector<BenchmarkResult> m_Results;
+};
+
+}; // namespace ispd::bench
+
+#endif // ISPD_BENCH_HARNESS_HPP
@@ -0,0 +1,262 @@
+#!/usr/bin/env python3
+"""Strong and weak scaling sweeps of ispd on a single Linux box.
+
+Each run executes ispd through the local mpirun with one of the generated
+topologies (star or tree), a rank count and a synchronization protocol, and
+reads its JSON run report (--report). The runs are summarized as scaling
+curves, in which the speedup and the scaling efficiency of each point are
+relative to the sequential run of the same model or, if there is none, to the
+run with the fewest ranks.
+
+Strong scaling keeps the model fixed while the ranks grow. Weak scaling grows
+the model with the ranks: the star's machines are multiplied by the ranks and
+the tree's fanout by the depth-th root of the ranks, so that both keep about
+the same machines per rank.
+
+Usage: scaling.py --ispd ./ispd --ranks 1,2,4 --output scaling
+
+The results are written to <output>.csv, with a row per run, and to
+<output>.json, with the runs and the curves.
+"""
+
+import argparse
+import csv
+import json
+import os
+import statistics
+import subprocess
+import sys
+import tempfile
+import time
+
+# The ROSS' synchronization protocols, indexed by --synch.
+SYNCH_NAMES = {1: "sequential", 2: "conservative", 3: "optimistic"}
+
+CSV_FIELDS = [
+    "scaling", "topology", "size", "machines", "ranks", "synch",
+    "wall_time_s", "run_time_s", "committed_events", "event_rate",
+    "speedup", "scaling_efficiency", "engine_efficiency", "rollbacks",
+    "remote_event_ratio", "max_peak_rss_kib", "total_peak_rss_kib",
+]
+
+
+def parse_list(text, kind=int):
+    return [kind(item) for item in text.split(",") if item]
+
+
+def parse_trees(text):
+    """Parses a list of tree sizes, each written as FANOUTxDEPTH."""
+    trees = []
+    for item in text.split(","):
+        if item:
+            fanout, depth = item.lower().split("x")
+            trees.append((int(fanout), int(depth)))
+    return trees
+
+
+def make_models(args, scaling, ranks):
+    """Returns the (topology, size, machines, ispd arguments) of each model."""
+    models = []
+    factor = ranks if scaling == "weak" else 1
+
+    for size in args.star:
+        machines = size * factor
+        models.append(("star", str(size), machines, [
+            "--topology=star",
+            f"--machine-amount={machines}",
+            f"--task-amount={machines * args.tasks_per_machine}",
+        ]))
+
+    for fanout, depth in args.tree:
+        size = f"{fanout}x{depth}"
+        fanout = max(fanout, round(fanout * factor ** (1.0 / depth)))
+        machines = fanout ** depth
+        models.append(("tree", size, machines, [
+            "--topology=tree",
+            f"--tree-fanout={fanout}",
+            f"--tree-depth={depth}",
+            f"--task-amount={machines * args.tasks_per_machine}",
+        ]))
+
+    return models
+
+
+def run_once(args, ranks, synch, model_args):
+    """Runs ispd once and returns its wall time and its run report."""
+    with tempfile.TemporaryDirectory() as directory:
+        report = os.path.join(directory, "report.json")
+        command = [args.mpirun, "-n", str(ranks), *args.mpirun_args.split(),
+                   args.ispd, f"--synch={synch}", f"--report={report}",
+                   "--log-level=error", *model_args,
+                   *args.ispd_args.split()]
+
+        start = time.perf_counter()
+        result = subprocess.run(command, stdout=subprocess.DEVNULL,
+                                stderr=subprocess.PIPE, text=True,
+                                timeout=args.timeout)
+        wall_time = time.perf_counter() - start
+
+        if result.returncode != 0 or not os.path.exists(report):
+            sys.stderr.write(" ".join(command) + " has failed:\n" +
+                             result.stderr[-2000:] + "\n")
+            return None
+
+        with open(report) as file:
+            return wall_time, json.load(file)
+
+
+def measure(args, scaling, topology, size, machines, ranks, synch,
+            model_args):
+    """Runs a point of the sweep and returns its row, with the median wall
+    time of its repetitions."""
+    runs = [run_once(args, ranks, synch, model_args)
+            for _ in range(args.repeat)]
+    runs = [run for run in runs if run is not None]
+    if not runs:
+        return None
+
+    runs.sort(key=lambda run: run[0])
+    report = runs[len(runs) // 2][1]
+    engine = report["engine"]
+    memory = report.get("memory", {})
+
+    return {
+        "scaling": scaling,
+        "topology": topology,
+        "size": size,
+        "machines": machines,
+        "ranks": ranks,
+        "synch": SYNCH_NAMES[synch],
+        "wall_time_s": statistics.median(run[0] for run in runs),
+        "run_time_s": report["phases"]["run"]["max"],
+        "committed_events": engine["net_events"],
+        "event_rate": engine["event_rate"],
+        "engine_efficiency": engine["efficiency"],
+        "rollbacks": engine["primary_rollbacks"] +
+        engine["secondary_rollbacks"],
+        "remote_event_ratio": engine["remote_event_ratio"],
+        "max_peak_rss_kib": memory.get("max_peak_rss_kib", 0),
+        "total_peak_rss_kib": memory.get("total_peak_rss_kib", 0),
+    }
+
+
+def add_curves(rows):
+    """Groups the rows into curves and computes their speedup and scaling
+    efficiency relative to the curve's baseline."""
+    curves = {}
+    for row in rows:
+        key = (row["scaling"], row["topology"], row["size"])
+        curves.setdefault(key, []).append(row)
+
+    summary = []
+    for (scaling, topology, size), points in curves.items():
+        sequential = [p for p in points if p["synch"] == "sequential"]
+        baseline = sequential[0] if sequential else min(
+            points, key=lambda p: p["ranks"])
+
+        for point in points:
+            ratio = baseline["run_time_s"] / point["run_time_s"]
+            if scaling == "weak":
+                # The ideal weak scaling keeps the run time constant.
+                point["speedup"] = ratio * point["ranks"] / baseline["ranks"]
+                point["scaling_efficiency"] = ratio
+            else:
+                point["speedup"] = ratio
+                point["scaling_efficiency"] = (
+                    ratio * baseline["ranks"] / point["ranks"])
+
+        for synch in SYNCH_NAMES.values():
+            curve = sorted((p for p in points if p["synch"] == synch),
+                           key=lambda p: p["ranks"])
+            if curve:
+                summary.append({
+                    "scaling": scaling,
+                    "topology": topology,
+                    "size": size,
+                    "synch": synch,
+                    "baseline": f"{baseline['synch']}@{baseline['ranks']}",
+                    "points": [{
+                        "ranks": p["ranks"],
+                        "run_time_s": p["run_time_s"],
+                        "event_rate": p["event_rate"],
+                        "speedup": p["speedup"],
+                        "scaling_efficiency": p["scaling_efficiency"],
+                    } for p in curve],
+                })
+
+    return summary
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Runs strong and weak scaling sweeps of ispd.")
+    parser.add_argument("--ispd", required=True, help="ispd executable")
+    parser.add_argument("--mpirun", default="mpirun", help="mpirun executable")
+    parser.add_argument("--mpirun-args", default="",
+                        help="extra mpirun arguments, e.g. --oversubscribe")
+    parser.add_argument("--ispd-args", default="",
+                        help="extra ispd arguments, e.g. --end=1000")
+    parser.add_argument("--ranks", type=parse_list, default=[1, 2, 4],
+                        help="comma-separated rank counts")
+    parser.add_argument("--synch", type=parse_list, default=[1, 2, 3],
+                        help="comma-separated ROSS --synch modes (1, 2, 3)")
+    parser.add_argument("--star", type=parse_list, default=[64, 256],
+                        help="comma-separated star machine counts (per rank "
+                        "for weak scaling)")
+    parser.add_argument("--tree", type=parse_trees, default=[(4, 3)],
+                        help="comma-separated tree sizes as FANOUTxDEPTH "
+                        "(at one rank for weak scaling)")
+    parser.add_argument("--scaling", type=lambda t: parse_list(t, str),
+                        default=["strong", "weak"],
+                        help="comma-separated scaling kinds (strong, weak)")
+    parser.add_argument("--tasks-per-machine", type=int, default=100)
+    parser.add_argument("--repeat", type=int, default=1,
+                        help="repetitions of each run, of which the median "
+                        "is kept")
+    parser.add_argument("--timeout", type=float, default=3600.0,
+                        help="timeout (in seconds) of each run")
+    parser.add_argument("--output", default="scaling",
+                        help="prefix of the CSV and the JSON results")
+    args = parser.parse_args()
+
+    for synch in args.synch:
+        if synch not in SYNCH_NAMES:
+            parser.error(f"--synch={synch} is not 1, 2 or 3")
+
+    rows = []
+    for scaling in args.scaling:
+        for ranks in args.ranks:
+            for topology, size, machines, model_args in make_models(
+                    args, scaling, ranks):
+                for synch in args.synch:
+                    # The sequential protocol only runs on a single rank.
+                    if synch == 1 and ranks != 1:
+                        continue
+
+                    print(f"{scaling} {topology} {size} ({machines} machines)"
+                          f" ranks={ranks} synch={SYNCH_NAMES[synch]}",
+                          flush=True)
+                    row = measure(args, scaling, topology, size, machines,
+                                  ranks, synch, model_args)
+                    if row:
+                        rows.append(row)
+
+    curves = add_curves(rows)
+
+    with open(args.output + ".csv", "w", newline="") as file:
+        writer = csv.DictWriter(file, fieldnames=CSV_FIELDS)
+        writer.writeheader()
+        writer.writerows(rows)
+
+    with open(args.output + ".json", "w") as file:
+        json.dump({"version": 1, "runs": rows, "curves": curves}, file,
+                  indent=2)
+        file.write("\n")
+
+    print(f"{len(rows)} runs have been written to {args.output}.csv and "
+          f"{args.output}.json.")
+    return 0 if rows else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,26 @@
+#ifndef ISPD_CUSTOMER_LATENCY_HPP
+#define ISPD_CUSTOMER_LATENCY_HPP
+
+namespace ispd::customer {
+
+/// \struct TaskLatency
+///
+/// \brief Represents the breakdown of a task's turnaround time along its route.
+///
+/// Each service that the task passes through adds its delays to the breakdown
+/// carried by the message that it sends forward. Therefore, the breakdown
+/// costs no extra event and is never rolled back, since the delays are only
+/// written to the new message.
+///
+/// \note The lookahead added by each hop is not part of any component.
+struct TaskLatency final {
+  double m_LinkWait;       ///< The waiting time at the links' queues.
+  double m_LinkTransfer;   ///< The communication time at the links.
+  double m_SwitchTransit;  ///< The communication time at the switches.
+  double m_MachineWait;    ///< The waiting time at the machine's queue.
+  double m_MachineService; ///< The processing time at the machine.
+};
+
+} // namespace ispd::customer
+
+#endif // ISPD_CUSTOMER_LATENCY_HPP
@@ -1,8 +1,9 @@
 #ifndef ISPD_DEBUG_HPP
 #define ISPD_DEBUG_HPP
 
-#define DEBUG_ON
-
+/// \note DEBUG_ON is defined by the build system when the ISPD_DEBUG option is
+///       enabled, so that the release builds pay nothing for the debug
+///       messages and checks.
 #ifdef DEBUG_ON
 # define DEBUG(CODE) CODE
 #else
@@ -0,0 +1,79 @@
+/// \file model_stats.hpp
+///
+/// \brief This file defines the per-LP model statistics that are serialized
+/// into ROSS' binary instrumentation output.
+///
+/// ROSS samples the model statistics at each GVT computation (`--model-stats=1`)
+/// or at each real time interval (`--model-stats=2`), by calling the
+/// `model_stat_fn` callback of each logical process' `st_model_types`. Every
+/// callback writes the same fixed-width record, so that the samples of all
+/// logical process types can be decoded by the same reader and correlated
+/// with the engine's statistics, such as rollbacks and remote events.
+///
+#ifndef ISPD_INSTRUMENTATION_MODEL_STATS_HPP
+#define ISPD_INSTRUMENTATION_MODEL_STATS_HPP
+
+#include <ross.h>
+#include <cstdint>
+#include <cstring>
+
+namespace ispd::instrumentation {
+
+/// \struct ModelStats
+///
+/// \brief A logical process' sampled model statistics.
+///
+/// \note Only the committed metrics are sampled, while the queueing state may
+///       include events that have not been committed yet.
+struct ModelStats final {
+  /// \brief The logical process' service type (see `ServiceType`).
+  std::uint32_t m_Type;
+
+  /// \brief The amount of busy servers, that is, the busy cores of a machine,
+  ///        the busy directions of a link or the outstanding tasks of a master.
+  std::uint32_t m_QueueDepth;
+
+  /// \brief The simulation time in which the service will be free again.
+  double m_NextFreeTime;
+
+  /// \brief The amount of committed packets handled by the service.
+  std::uint64_t m_Packets;
+
+  /// \brief The fraction of the elapsed simulation time in which the service's
+  ///        servers have been busy.
+  double m_Utilization;
+};
+
+template <auto Sampler> struct ModelStat;
+
+/// \brief Serializes the model statistics sampled by the specified sampler
+///        into ROSS' instrumentation buffer.
+///
+/// The record is built aside and copied, since ROSS' buffer may be unaligned.
+template <typename State, void (*Sampler)(State *, tw_lp *, ModelStats *)>
+struct ModelStat<Sampler> {
+  static void handle(State *s, tw_lp *lp, char *buffer) {
+    ModelStats stats;
+    std::memset(&stats, 0, sizeof(stats));
+
+    Sampler(s, lp, &stats);
+    std::memcpy(buffer, &stats, sizeof(stats));
+  }
+};
+
+/// \brief Returns the busy fraction of the elapsed simulation time.
+///
+/// \param busyTime The total busy time of the service's servers.
+/// \param servers The amount of servers.
+/// \param now The current simulation time.
+[[nodiscard]] inline double utilization(const double busyTime,
+                                        const unsigned servers,
+                                        const double now) {
+  if (servers == 0 || now <= 0.0)
+    return 0.0;
+  return busyTime / (servers * now);
+}
+
+}; // namespace ispd::instrumentation
+
+#endif // ISPD_INSTRUMENTATION_MODEL_STATS_HPP
@@ -0,0 +1,52 @@
+/// \file binary_log.hpp
+///
+/// \brief This file defines the binary log's file format, which is written by
+/// `ispd` and read by the `ispd_log_decode` tool.
+///
+/// A binary log starts with a header, which is followed by records. A record
+/// starts with its kind, which is one of:
+///
+/// - `SITE`: the site's identifier (uint32), log level (uint8), line (uint32),
+///   source file and format string.
+/// - `MESSAGE`: the site's identifier (uint32), the nanoseconds elapsed since
+///   the log has been opened (uint64), the argument count (uint8) and the
+///   arguments. Each argument is its tag (uint8) followed by its string, if it
+///   is a string, or by its 8 bytes otherwise.
+///
+/// The strings are their length (uint16) followed by their characters. A site
+/// record always precedes the site's first message record.
+///
+#ifndef ISPD_LOG_BINARY_LOG_HPP
+#define ISPD_LOG_BINARY_LOG_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ispd::log {
+
+/// \brief The binary log file format version.
+static constexpr std::uint32_t BINARY_LOG_VERSION = 1;
+
+/// \brief The maximum size of a record. The strings that would not fit in a
+///        record are truncated, and their length is the truncated length, so
+///        that a record always holds every one of its arguments.
+static constexpr std::size_t BINARY_LOG_MAX_RECORD_SIZE = 4096;
+
+/// \brief The kind of a binary log record.
+enum class BinaryLogRecord : std::uint8_t {
+  SITE = 1,    ///< A call site's definition.
+  MESSAGE = 2, ///< A logged message.
+};
+
+/// \struct BinaryLogHeader
+///
+/// \brief The header of a binary log file.
+struct BinaryLogHeader final {
+  char m_Magic[8];         ///< Always "ISPDLOG".
+  std::uint32_t m_Version; ///< The file format version.
+  std::uint32_t m_Rank;    ///< The rank that has written the file.
+};
+
+}; // namespace ispd::log
+
+#endif // ISPD_LOG_BINARY_LOG_HPP
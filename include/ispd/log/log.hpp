@@ -1,35 +1,46 @@
 #pragma once
 
 #include <cstdio>
+#include <string>
+#include <cstdint>
 #include <string_view>
+#include <type_traits>
 #include <ispd/debug/debug.hpp>
 
 // The ispd_log macro provides a concise way to log messages with different log
-// levels.
+// levels. A message whose level is filtered out costs a single branch, since
+// its arguments are not even evaluated.
 #define ispd_log(level, ...)                                                   \
-  ispd::log::log(level, __FILE__, __LINE__, __VA_ARGS__);
+  do {                                                                         \
+    if (ispd::log::isEnabled(level)) {                                         \
+      static ispd::log::LogSite ispd_log_site = {level, __FILE__, __LINE__,    \
+                                                 0};                           \
+      ispd::log::emit(ispd_log_site, __VA_ARGS__);                             \
+    }                                                                          \
+  } while (0)
 
 // The ispd_info macro logs messages at the INFO log level.
-#define ispd_info(...)                                                         \
-  ispd::log::log(ispd::log::LogLevel::LOG_INFO, __FILE__, __LINE__,            \
-                 __VA_ARGS__);
+#define ispd_info(...) ispd_log(ispd::log::LogLevel::LOG_INFO, __VA_ARGS__)
 
 // The ispd_error macro logs messages at the ERROR log level.
-#define ispd_error(...)                                                        \
-  ispd::log::log(ispd::log::LogLevel::LOG_ERROR, __FILE__, __LINE__,           \
-                 __VA_ARGS__);
+#define ispd_error(...) ispd_log(ispd::log::LogLevel::LOG_ERROR, __VA_ARGS__)
 
 // The ispd_debug macro logs messages at the DEBUG log level, but only when
 // DEBUG_ON is defined.
 #ifdef DEBUG_ON
-#define ispd_debug(...)                                                        \
-  ispd::log::log(ispd::log::LogLevel::LOG_DEBUG, __FILE__, __LINE__,           \
-                 __VA_ARGS__);
+#define ispd_debug(...) ispd_log(ispd::log::LogLevel::LOG_DEBUG, __VA_ARGS__)
 #else
 #define ispd_debug(...)
 #endif // DEBUG_ON
 
 /// The ispd::log namespace contains utilities for logging messages.
+///
+/// The messages are either formatted right away and written as text, or, once
+/// a binary log has been opened, their format string identifiers and raw
+/// arguments are pushed into a lock-free ring buffer. In the latter case, a
+/// background thread drains the ring buffer into a per-rank binary file, which
+/// is rendered as text by the `ispd_log_decode` tool. Therefore, the formatting
+/// and the write system calls are taken off the simulation's thread.
 namespace ispd::log {
 
 /// The LogLevel enum class represents different log levels.
@@ -51,22 +62,146 @@ constexpr static const struct {
               [static_cast<int>(LogLevel::LOG_ERROR)] = {.name = "ERROR",
                                                          .color = "\x1b[31m"}};
 
-/// The log function is used to log messages at different log levels.
+/// The LogSite struct describes a call site of the logging macros.
+///
+/// \note Each call site has a static site, whose identifier is given the first
+///       time that a message is logged by it into the binary log.
+struct LogSite {
+  LogLevel m_Level;    ///< The messages' log level.
+  const char *m_File;  ///< The source file of the call site.
+  unsigned m_Line;     ///< The line of the call site.
+  std::uint32_t m_Id;  ///< The site's identifier, or 0 if not yet given.
+};
+
+/// The LogArgumentTag enum class represents the type of a message argument in
+/// the binary log.
+enum class LogArgumentTag : std::uint8_t {
+  SIGNED,   ///< A signed integer (or enumeration), widened to 64 bits.
+  UNSIGNED, ///< An unsigned integer, widened to 64 bits.
+  DOUBLE,   ///< A floating-point number.
+  STRING,   ///< A null-terminated string, which is copied.
+  POINTER,  ///< A pointer, of which only the address is kept.
+};
+
+/// The LogArgument struct holds a raw message argument.
+struct LogArgument {
+  LogArgumentTag m_Tag; ///< The argument's type.
+  union {
+    std::int64_t m_Signed;
+    std::uint64_t m_Unsigned;
+    double m_Double;
+    const char *m_String;
+    const void *m_Pointer;
+  };
+};
+
+/// \brief The lowest enabled log level.
+///
+/// \note It is exposed so that the level filter can be inlined in the logging
+///       macros.
+extern int g_MinLevel;
+
+/// \brief Whether a binary log has been opened.
+extern bool g_BinaryLog;
+
+/// \brief Returns whether the messages of the specified level are logged.
+inline bool isEnabled(const LogLevel level) noexcept {
+  return static_cast<int>(level) >= g_MinLevel;
+}
+
+/// \brief Sets the lowest enabled log level. The errors are always logged.
+void setLevel(const LogLevel level) noexcept;
+
+/// \brief Parses a log level's name, such as "debug", "info" or "error".
 ///
-/// \param level The log level of the message.
-/// \param filepath The path of the source file where the log message is
-///		    generated.
-/// \param line The line number in the source file where the log
-///		message is generated. \param fmt The format string for the log
-///		message.
-/// \param ... Additional arguments to be formatted according to the format
-///	       string.
-void log(const LogLevel level, std::string_view filepath, const unsigned line,
-         const std::string_view fmt, ...) noexcept;
+/// \return Whether the name is a valid log level's name.
+bool parseLevel(std::string_view name, LogLevel &level) noexcept;
+
+/// \brief Formats and writes a message as text.
+void writeText(const LogSite &site, const char *fmt, ...) noexcept;
+
+/// \brief Pushes a message into the binary log's ring buffer.
+void writeBinary(LogSite &site, const char *fmt, const LogArgument *args,
+                 const std::size_t count) noexcept;
+
+/// \brief Returns the raw argument of a message argument.
+template <typename T> inline LogArgument makeArgument(const T &value) noexcept {
+  LogArgument arg;
+
+  if constexpr (std::is_floating_point_v<T>) {
+    arg.m_Tag = LogArgumentTag::DOUBLE;
+    arg.m_Double = value;
+  } else if constexpr (std::is_enum_v<T>) {
+    arg.m_Tag = LogArgumentTag::SIGNED;
+    arg.m_Signed = static_cast<std::int64_t>(value);
+  } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+    arg.m_Tag = LogArgumentTag::SIGNED;
+    arg.m_Signed = value;
+  } else if constexpr (std::is_integral_v<T>) {
+    arg.m_Tag = LogArgumentTag::UNSIGNED;
+    arg.m_Unsigned = value;
+  } else if constexpr (std::is_convertible_v<T, const char *>) {
+    arg.m_Tag = LogArgumentTag::STRING;
+    arg.m_String = value;
+  } else {
+    static_assert(std::is_pointer_v<T>, "The argument cannot be logged.");
+    arg.m_Tag = LogArgumentTag::POINTER;
+    arg.m_Pointer = value;
+  }
+
+  return arg;
+}
+
+/// \brief Returns a message argument as it is passed to the text formatting.
+template <typename T> inline auto toVararg(const T &value) noexcept {
+  if constexpr (std::is_enum_v<T>)
+    return static_cast<std::underlying_type_t<T>>(value);
+  else if constexpr (std::is_array_v<T>)
+    return static_cast<const std::remove_extent_t<T> *>(value);
+  else
+    return value;
+}
+
+/// \brief Logs a message from the specified call site.
+///
+/// \param site The call site.
+/// \param fmt The printf-style format string for the log message, which must
+///            be a string literal.
+/// \param args Additional arguments to be formatted according to the format
+///             string.
+///
+/// \note If the log level is LOG_ERROR, the program will be aborted after
+///       logging the message.
+template <typename... Args>
+inline void emit(LogSite &site, const char *fmt, const Args &...args) noexcept {
+  /// The binary log records the argument count as a single byte.
+  static_assert(sizeof...(Args) <= UINT8_MAX,
+                "A message can have at most 255 arguments.");
+
+  if (g_BinaryLog) {
+    const LogArgument raw[sizeof...(Args) + 1] = {makeArgument(args)...};
+    writeBinary(site, fmt, raw, sizeof...(Args));
+  } else {
+    writeText(site, fmt, toVararg(args)...);
+  }
+}
 
 /// The setOutputFile function is used to set the output file for log messages.
 ///
 /// \param f A pointer to the output file where log messages will be written.
 void setOutputFile(FILE *const f) noexcept;
 
+/// \brief Opens the binary log of this rank, `<prefix>.<rank>.log`, and starts
+///        the background thread that writes it.
+///
+/// \param prefix The binary log's prefix.
+/// \param rank This rank.
+/// \param capacity The ring buffer's capacity (in bytes), which is rounded up
+///                 to a power of two.
+void openBinary(const std::string &prefix, const unsigned rank,
+                const std::size_t capacity) noexcept;
+
+/// \brief Drains and closes the binary log, if any, and flushes the text log.
+void close() noexcept;
+
 } // namespace ispd::log
@@ -0,0 +1,182 @@
+/// \file mapping.hpp
+///
+/// \brief This file defines the LpMapping class, which describes the mapping of
+/// logical processes (LPs) to processing elements (PEs), and the functions that
+/// install it as the ROSS' custom mapping.
+///
+/// ROSS' linear mapping requires every PE to hold the same amount of LPs, and
+/// the LPs held by a PE must have contiguous global identifiers (GIDs). The
+/// custom mapping lifts both restrictions, so that the LPs can be placed
+/// following the partition computed from the service graph.
+///
+#ifndef ISPD_MAPPING_HPP
+#define ISPD_MAPPING_HPP
+
+#include <ross.h>
+#include <vector>
+#include <algorithm>
+#include <ispd/debug/debug.hpp>
+#include <ispd/partitioning/graph.hpp>
+
+namespace ispd::mapping {
+
+/// \class LpMapping
+///
+/// \brief Describes in which PE each LP is simulated and the LP's local index
+///        at that PE.
+///
+/// The mapping has two representations:
+///
+///   1. Block: each PE holds a contiguous range of GIDs, whose sizes may differ
+///      among the PEs. Only the prefix sum of the PEs' LP counts is kept, and
+///      the PE of a GID is found by a binary search on it.
+///
+///   2. Partitioned: each PE holds an arbitrary set of GIDs. The GID-to-PE and
+///      GID-to-local tables are kept for every LP in the model, so that both
+///      queries are answered with a single array access.
+///
+/// Both queries are important since ROSS performs them for every sent event.
+class LpMapping final {
+public:
+  /// \brief Constructor for a partitioned LpMapping.
+  ///
+  /// \param partition The PE of each LP, indexed by the LP's GID.
+  /// \param self The PE in which this process is running.
+  ///
+  /// \note At each PE, the local indices follow the increasing order of the
+  ///       GIDs held by it.
+  [[nodiscard]] explicit LpMapping(std::vector<tw_peid> &&partition,
+                                   const tw_peid self);
+
+  /// \brief Constructor for a block LpMapping.
+  ///
+  /// \param counts The amount of LPs held by each PE. The PE `i` holds the
+  ///               LPs whose GIDs follow the ones held by the PE `i - 1`.
+  /// \param self The PE in which this process is running.
+  [[nodiscard]] explicit LpMapping(const std::vector<tw_lpid> &counts,
+                                   const tw_peid self);
+
+  /// \brief Returns the PE in which the LP with the specified GID is
+  ///        simulated.
+  [[nodiscard]] inline tw_peid getPe(const tw_lpid gid) const noexcept {
+    if (!m_Offsets.empty())
+      return static_cast<tw_peid>(
+          std::upper_bound(m_Offsets.begin(), m_Offsets.end(), gid) -
+          m_Offsets.begin() - 1);
+    return m_GidToPe[gid];
+  }
+
+  /// \brief Returns the local index of the LP with the specified GID at the
+  ///        PE in which it is simulated.
+  [[nodiscard]] inline tw_lpid getLocalIndex(const tw_lpid gid) const noexcept {
+    if (!m_Offsets.empty())
+      return gid - m_Offsets[getPe(gid)];
+    return m_GidToLocal[gid];
+  }
+
+  /// \brief Returns the GID of the LP with the specified local index at this
+  ///        PE.
+  [[nodiscard]] inline tw_lpid getLocalGid(const tw_lpid index) const noexcept {
+    return m_LocalToGid[index];
+  }
+
+  /// \brief Returns the KP of the LP with the specified local index at this
+  ///        PE.
+  ///
+  /// If no KP assignment has been set, the local LPs are spread through the
+  /// KPs in contiguous blocks of local indices.
+  [[nodiscard]] inline tw_kpid getLocalKp(const tw_lpid index,
+                                          const tw_kpid kpCount) const noexcept {
+    if (!m_LocalToKp.empty())
+      return m_LocalToKp[index];
+    return index * kpCount / getLocalCount();
+  }
+
+  /// \brief Sets the KP of each local LP, indexed by the LP's local index.
+  inline void setLocalKps(std::vector<tw_kpid> &&kps) noexcept {
+    m_LocalToKp = std::move(kps);
+  }
+
+  /// \brief Returns the amount of LPs simulated at this PE.
+  [[nodiscard]] inline tw_lpid getLocalCount() const noexcept {
+    return static_cast<tw_lpid>(m_LocalToGid.size());
+  }
+
+  /// \brief Returns the amount of LPs in the model.
+  [[nodiscard]] inline tw_lpid getGlobalCount() const noexcept {
+    if (!m_Offsets.empty())
+      return m_Offsets.back();
+    return static_cast<tw_lpid>(m_GidToPe.size());
+  }
+
+  /// \brief Returns the PE in which this process is running.
+  [[nodiscard]] inline tw_peid getSelf() const noexcept { return m_Self; }
+
+private:
+  tw_peid m_Self;
+
+  /// \brief The prefix sum of the PEs' LP counts (block mapping only).
+  ///
+  /// The PE `i` holds the GIDs in `[m_Offsets[i], m_Offsets[i + 1])`.
+  std::vector<tw_lpid> m_Offsets;
+
+  std::vector<tw_peid> m_GidToPe;
+  std::vector<tw_lpid> m_GidToLocal;
+  std::vector<tw_lpid> m_LocalToGid;
+  std::vector<tw_kpid> m_LocalToKp;
+};
+
+}; // namespace ispd::mapping
+
+namespace ispd::lp_mapping {
+
+/// \brief Installs the mapping described by the specified partition as the
+///        ROSS' custom mapping.
+///
+/// Unless `groupKps` is called, the local LPs are spread through the kernel
+/// processes (KPs) in contiguous blocks of local indices.
+///
+/// \param partition The PE of each LP, indexed by the LP's GID.
+///
+/// \note This function must be called after `tw_init` and before
+///       `tw_define_lps`, which must be called with `getLocalCount()` LPs.
+void install(std::vector<tw_peid> &&partition);
+
+/// \brief Installs a block mapping as the ROSS' custom mapping.
+///
+/// The LPs are distributed in contiguous ranges of GIDs. The first
+/// `globalCount % tw_nnodes()` PEs hold one more LP than the remaining ones,
+/// so that no PE needs to be padded.
+///
+/// \param globalCount The amount of LPs in the model.
+///
+/// \note This function must be called after `tw_init` and before
+///       `tw_define_lps`, which must be called with `getLocalCount()` LPs.
+void installBlock(const tw_lpid globalCount);
+
+/// \brief Groups the local LPs into KPs following the topology.
+///
+/// ROSS rolls back all the LPs of a KP together. Therefore, the LPs that
+/// exchange many events (e.g., a master's subtree or a rack with its links)
+/// should be in the same KP, so that a rollback caused by one of them does not
+/// roll back unrelated LPs. To that end, the subgraph of the service graph
+/// induced by the local LPs is partitioned into `g_tw_nkp` parts.
+///
+/// \param graph The service graph.
+///
+/// \note This function must be called after `install` or `installBlock`,
+///       after `g_tw_nkp` has been set and before `tw_define_lps`.
+void groupKps(const ispd::partitioning::ServiceGraph &graph);
+
+/// \brief Returns the PE in which the LP with the specified GID is simulated.
+[[nodiscard]] tw_peid getPe(const tw_lpid gid);
+
+/// \brief Returns the GID of the LP with the specified local index.
+[[nodiscard]] tw_lpid getLocalGid(const tw_lpid index);
+
+/// \brief Returns the amount of LPs simulated at this PE.
+[[nodiscard]] tw_lpid getLocalCount();
+
+}; // namespace ispd::lp_mapping
+
+#endif // ISPD_MAPPING_HPP
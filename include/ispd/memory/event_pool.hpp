@@ -0,0 +1,71 @@
+/// \file event_pool.hpp
+///
+/// \brief This file declares the event pool sizing, which estimates how many
+/// events each processing element (PE) needs from the model's description.
+///
+/// ROSS allocates a fixed pool of events at each PE and aborts the simulation
+/// if it is exhausted. The model knows in advance which routes each task will
+/// travel and how many tasks each master will generate, therefore, the pool
+/// can be sized from it instead of being over-provisioned by hand.
+///
+#ifndef ISPD_MEMORY_EVENT_POOL_HPP
+#define ISPD_MEMORY_EVENT_POOL_HPP
+
+#include <ross.h>
+#include <cstddef>
+
+namespace ispd::memory {
+
+/// \struct EventPoolEstimate
+///
+/// \brief The estimated event requirement of a processing element.
+struct EventPoolEstimate final {
+  /// \brief The maximum amount of pending events, that is, one event for each
+  ///        task whose route touches this PE and one generate event for each
+  ///        master simulated at this PE.
+  std::size_t m_Pending;
+
+  /// \brief The amount of processed events that are retained until they are
+  ///        fossil collected, which is only non-zero in optimistic runs.
+  std::size_t m_Retained;
+
+  /// \brief The total amount of events to be allocated, including a margin
+  ///        for rollbacks, anti-messages and network buffers.
+  std::size_t m_Total;
+};
+
+}; // namespace ispd::memory
+
+namespace ispd::event_pool {
+
+/// \brief The fewest free events observed at this PE.
+///
+/// \note It is exposed so that the observation can be inlined in the handlers.
+extern std::size_t g_LowestFree;
+
+/// \brief Estimates the event requirement of this PE.
+///
+/// \note This function must be called after the model has been built and the
+///       mapping has been installed.
+[[nodiscard]] ispd::memory::EventPoolEstimate estimate();
+
+/// \brief Sets `g_tw_events_per_pe` to the specified estimate.
+///
+/// \note This function must be called before `tw_define_lps`.
+void apply(const ispd::memory::EventPoolEstimate &estimate);
+
+/// \brief Observes the current amount of free events at this PE.
+inline void observe() {
+  if (g_tw_pe->free_q.size < g_LowestFree)
+    g_LowestFree = g_tw_pe->free_q.size;
+}
+
+/// \brief Reports the estimate against the observed high-water mark, that is,
+///        the most events that have been simultaneously in use.
+///
+/// \note This function is collective and must be called after `tw_run`.
+void report(const ispd::memory::EventPoolEstimate &estimate);
+
+}; // namespace ispd::event_pool
+
+#endif // ISPD_MEMORY_EVENT_POOL_HPP
@@ -2,6 +2,8 @@
 #define ISPD_MESSAGE_H
 
 #include <ispd/customer/task.hpp>
+#include <ispd/customer/latency.hpp>
+#include <ispd/reverse/reverse.hpp>
 
 enum class message_type {
   GENERATE,
@@ -15,13 +17,31 @@ struct ispd_message {
   /// \brief The message payload.
   ispd::customer::Task task;
 
+  /// \brief The task's latency breakdown accumulated along the route.
+  ispd::customer::TaskLatency latency;
+
   /// \brief Reverse Computational Fields.
+  ///
+  /// \note They are compiled out in the sequential-only build, since no
+  ///       event is ever rolled back.
+#ifndef ISPD_SEQUENTIAL_ONLY
   double saved_link_next_available_time;
   unsigned saved_core_index;
   double saved_core_next_available_time;
+#endif // ISPD_SEQUENTIAL_ONLY
+
+  /// \brief Commit Fields.
   double saved_waiting_time;
+  double saved_arrival_time;
 
   /// \brief Route's descriptor.
+  ///
+  /// The routes alternate links and nodes (switches and machines), starting
+  /// with a link and ending with the destination machine. The offset is the
+  /// index, within the route, of the node at the end of the link being
+  /// crossed. Links pass it through unchanged, while the nodes send to their
+  /// adjacent link (offset + 1 downward, offset - 1 upward) and move the
+  /// offset to the next node (offset + 2 downward, offset - 2 upward).
   int route_offset;
   tw_lpid previous_service_id;
 
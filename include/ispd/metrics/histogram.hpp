@@ -0,0 +1,143 @@
+/// \file histogram.hpp
+///
+/// \brief This file defines the log-bucketed histograms, which keep the
+/// distribution of the tasks' latencies so that their percentiles can be
+/// reported.
+///
+/// The histograms follow the HDR (high dynamic range) layout: each power of two
+/// is split into a fixed amount of linear sub-buckets. Therefore, every
+/// recorded value is kept with the same relative precision, regardless of its
+/// magnitude, and the histogram's memory is bounded regardless of how many
+/// values are recorded.
+///
+#ifndef ISPD_METRICS_HISTOGRAM_HPP
+#define ISPD_METRICS_HISTOGRAM_HPP
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <ispd/report/json.hpp>
+
+namespace ispd::metrics {
+
+/// \class LogHistogram
+///
+/// \brief A log-bucketed histogram of non-negative values.
+///
+/// The values below `2^MIN_EXPONENT` are counted in the first bucket and the
+/// values from `2^MAX_EXPONENT` on are counted in the last bucket. With the
+/// chosen constants, the values between a microsecond and about six months
+/// are kept with a relative error of at most 1/32 (about 3%).
+class LogHistogram final {
+public:
+  static constexpr int MIN_EXPONENT = -20;  ///< The first tracked power of two.
+  static constexpr int MAX_EXPONENT = 24;   ///< The first untracked power of two.
+  static constexpr int SUB_BUCKETS = 32;    ///< The sub-buckets of each power of two.
+
+  /// \brief The amount of buckets, including the underflow and the overflow.
+  static constexpr std::size_t BUCKET_COUNT =
+      (MAX_EXPONENT - MIN_EXPONENT) * SUB_BUCKETS + 2;
+
+  /// \brief Records a value.
+  inline void record(const double value) noexcept {
+    m_Buckets[getBucket(value)]++;
+  }
+
+  /// \brief Adds the counts of the specified histogram to this histogram.
+  inline void merge(const LogHistogram &other) noexcept {
+    for (std::size_t i = 0; i < BUCKET_COUNT; i++)
+      m_Buckets[i] += other.m_Buckets[i];
+  }
+
+  /// \brief Returns the amount of recorded values.
+  [[nodiscard]] std::uint64_t getCount() const noexcept;
+
+  /// \brief Returns the value at the specified percentile.
+  ///
+  /// The returned value is the upper bound of the bucket in which the
+  /// percentile falls, so it never underestimates the percentile by more than
+  /// the histogram's precision.
+  ///
+  /// \param percentile The percentile, between 0 and 100.
+  [[nodiscard]] double getPercentile(const double percentile) const noexcept;
+
+  /// \brief Returns the bucket counts, so that histograms can be reduced.
+  [[nodiscard]] inline std::uint64_t *data() noexcept {
+    return m_Buckets.data();
+  }
+
+  /// \brief Returns the bucket counts, so that histograms can be reduced.
+  [[nodiscard]] inline const std::uint64_t *data() const noexcept {
+    return m_Buckets.data();
+  }
+
+  /// \brief Returns the bucket in which the specified value is counted.
+  [[nodiscard]] static inline std::size_t getBucket(const double value) noexcept {
+    int exponent;
+
+    /// The value is decomposed as `mantissa * 2^exponent`, with the mantissa
+    /// in [0.5, 1). Therefore, the value's power of two is `exponent - 1`.
+    const double mantissa = std::frexp(value, &exponent);
+    const int power = exponent - 1;
+
+    if (!(value > 0.0) || power < MIN_EXPONENT)
+      return 0;
+    if (power >= MAX_EXPONENT)
+      return BUCKET_COUNT - 1;
+
+    const int subBucket = static_cast<int>((2.0 * mantissa - 1.0) * SUB_BUCKETS);
+    return 1 + (power - MIN_EXPONENT) * SUB_BUCKETS + subBucket;
+  }
+
+  /// \brief Returns the upper bound of the values counted in the specified
+  ///        bucket.
+  [[nodiscard]] static double getBucketUpperBound(const std::size_t bucket) noexcept;
+
+private:
+  std::array<std::uint64_t, BUCKET_COUNT> m_Buckets{}; ///< The bucket counts.
+};
+
+/// \struct TaskHistograms
+///
+/// \brief The latency histograms of the tasks of a user.
+struct TaskHistograms final {
+  LogHistogram m_Turnaround;     ///< The tasks' turnaround times.
+  LogHistogram m_MachineWaiting; ///< The tasks' waiting times at machines.
+  LogHistogram m_LinkWaiting;    ///< The packets' waiting times at links.
+
+  /// \brief The tasks' turnaround time breakdown, recorded per completed task.
+  LogHistogram m_LinkWait;       ///< The waiting times at the route's links.
+  LogHistogram m_LinkTransfer;   ///< The communication times at the links.
+  LogHistogram m_SwitchTransit;  ///< The communication times at the switches.
+  LogHistogram m_MachineWait;    ///< The waiting times at the machine.
+  LogHistogram m_MachineService; ///< The processing times at the machine.
+
+  /// \brief The amount of histograms of a user.
+  static constexpr std::size_t COUNT = 8;
+};
+
+}; // namespace ispd::metrics
+
+namespace ispd::task_histograms {
+
+/// \brief Reduces the users' histograms of every node to the master node in a
+///        single vector reduction.
+///
+/// \note This function is collective and must be called before `tw_end`.
+void reduce();
+
+/// \brief Reports the percentiles of the reduced histograms, per user and
+///        globally.
+///
+/// \note This function only reports at the master node.
+void report();
+
+/// \brief Writes the percentiles of the reduced histograms, per user and
+///        globally, to the run report.
+///
+/// \note This function must only be called at the master node.
+void write(ispd::report::JsonWriter &json);
+
+}; // namespace ispd::task_histograms
+
+#endif // ISPD_METRICS_HISTOGRAM_HPP
@@ -0,0 +1,113 @@
+/// \file lp_metrics.hpp
+///
+/// \brief This file defines the per-LP metrics file, which replaces the
+/// per-LP reports that the services used to print when finishing.
+///
+/// Each logical process (LP) records its metrics into a fixed-width record
+/// when it finishes. After the simulation, every rank writes its records with
+/// a single collective MPI-IO write into a single file, which begins with a
+/// header describing the schema of the records. The `ispd_lp_metrics` tool
+/// converts the file to CSV.
+///
+/// The file layout is:
+///
+///   +------------------+---------------------------+
+///   | LpMetricsHeader  | LpMetricsRecord * m_Count |
+///   +------------------+---------------------------+
+///
+/// The records are grouped by rank, in rank order.
+///
+#ifndef ISPD_METRICS_LP_METRICS_HPP
+#define ISPD_METRICS_LP_METRICS_HPP
+
+#include <cstdint>
+#include <string>
+#include <iterator>
+#include <initializer_list>
+#include <ispd/services/services.hpp>
+
+namespace ispd::metrics {
+
+/// \brief The maximum amount of metrics of a logical process.
+constexpr std::size_t LP_METRICS_COLUMNS = 10;
+
+/// \brief The maximum length of a column name, including the terminator.
+constexpr std::size_t LP_METRICS_COLUMN_NAME = 32;
+
+/// \brief The name of each metric recorded by each service type, indexed by
+///        the service type. The unused columns have empty names.
+inline constexpr const char *g_LpMetricsColumns[][LP_METRICS_COLUMNS] = {
+    /// Master.
+    {"completed_tasks", "avg_turnaround_time", "issued_tasks"},
+    /// Link.
+    {"downward_comm_mbits", "downward_comm_packets", "downward_waiting_time",
+     "downward_idleness", "downward_next_avail_time", "upward_comm_mbits",
+     "upward_comm_packets", "upward_waiting_time", "upward_idleness",
+     "upward_next_avail_time"},
+    /// Machine.
+    {"last_activity_time", "processed_mflops", "processed_tasks",
+     "forwarded_packets", "waiting_time", "avg_processing_time", "idleness",
+     "non_idle_energy"},
+    /// Switch.
+    {"downward_comm_mbits", "downward_comm_packets", "upward_comm_mbits",
+     "upward_comm_packets"},
+};
+
+/// \brief The amount of service types described by the schema.
+constexpr std::size_t LP_METRICS_TYPES = std::size(g_LpMetricsColumns);
+
+/// \struct LpMetricsHeader
+///
+/// \brief The header of a per-LP metrics file.
+struct LpMetricsHeader final {
+  char m_Magic[8];              ///< Always "ISPDLPM".
+  std::uint32_t m_Version;      ///< The file format version.
+  std::uint32_t m_RecordSize;   ///< The size of a record (in bytes).
+  std::uint64_t m_Count;        ///< The amount of records.
+  std::uint32_t m_TypeCount;    ///< The amount of service types.
+  std::uint32_t m_ColumnCount;  ///< The amount of columns of a record.
+
+  /// \brief The column names of each service type.
+  char m_Columns[LP_METRICS_TYPES][LP_METRICS_COLUMNS][LP_METRICS_COLUMN_NAME];
+};
+
+/// \struct LpMetricsRecord
+///
+/// \brief The metrics of a logical process.
+///
+/// The meaning of each value depends on the logical process' service type and
+/// is described by the header.
+struct LpMetricsRecord final {
+  std::uint64_t m_Gid;                    ///< The logical process' GID.
+  std::uint32_t m_Type;                   ///< The service type.
+  std::uint32_t m_ColumnCount;            ///< The amount of used columns.
+  double m_Values[LP_METRICS_COLUMNS];    ///< The metrics' values.
+};
+
+/// \brief The per-LP metrics file format version.
+constexpr std::uint32_t LP_METRICS_VERSION = 1;
+
+}; // namespace ispd::metrics
+
+namespace ispd::lp_metrics {
+
+/// \brief Records the metrics of a logical process.
+///
+/// \param gid The logical process' global identifier.
+/// \param type The logical process' service type.
+/// \param values The metrics' values, in the order of the schema's columns.
+///
+/// \note This function is called by the services' finish handlers.
+void record(const std::uint64_t gid, const ispd::services::ServiceType type,
+            const std::initializer_list<double> values);
+
+/// \brief Writes the recorded metrics of every rank into the specified file.
+///
+/// \param filepath The file path. If it is empty, nothing is written.
+///
+/// \note This function is collective and must be called after `tw_run`.
+void write(const std::string &filepath);
+
+}; // namespace ispd::lp_metrics
+
+#endif // ISPD_METRICS_LP_METRICS_HPP
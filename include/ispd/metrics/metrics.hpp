@@ -1,13 +1,17 @@
 #ifndef ISPD_METRICS_HPP
 #define ISPD_METRICS_HPP
 
-#include <unordered_map>
+#include <map>
+#include <array>
+#include <cstdint>
+#include <iterator>
+#include <algorithm>
+#include <type_traits>
+#include <ispd/debug/debug.hpp>
 #include <ispd/model/user.hpp>
-
-#ifdef DEBUG_ON
-  #include <cstdint>
-  #include <ispd/services/services.hpp>
-#endif // DEBUG_ON
+#include <ispd/metrics/user_metrics.hpp>
+#include <ispd/report/json.hpp>
+#include <ispd/services/services.hpp>
 
 namespace ispd::metrics {
 
@@ -69,32 +73,124 @@ enum class NodeMetricsFlag {
 
   /// \brief The simulation time in this node.
   NODE_SIMULATION_TIME,
+};
 
-#ifdef DEBUG_ON
-  /// \brief The accumulation of the real time taken (ns) to process forwarding an event in a master.
-  NODE_MASTER_FORWARD_TIME,
+/// \brief Enumeration class representing how a node-level metric is accumulated and reduced.
+///
+/// The kind of a metric determines its value type and in which storage array it is kept. Every
+/// double-valued metric is kept in the doubles array, and every counted metric is kept in the
+/// counters array.
+enum class MetricKind {
+  SUM,     ///< A double-valued metric that is summed up.
+  MAX,     ///< A double-valued metric whose maximum is kept.
+  COUNT,   ///< An unsigned metric that is summed up.
+};
 
-  /// \brief The accumulation of the real time taken (ns) to reverse the process of an event in a master.
-  NODE_MASTER_REVERSE_TIME,
+/// \brief The kind of each node-level metric, indexed by its flag.
+///
+/// \note The order MUST follow the order of the NodeMetricsFlag enumeration, which is checked at
+///       compile time by the MetricTraits structure.
+inline constexpr MetricKind g_NodeMetricsKinds[] = {
+  MetricKind::SUM,     ///< NODE_TOTAL_COMMUNICATED_MBITS
+  MetricKind::SUM,     ///< NODE_TOTAL_PROCESSED_MFLOPS
+  MetricKind::SUM,     ///< NODE_TOTAL_PROCESSING_TIME
+  MetricKind::SUM,     ///< NODE_TOTAL_PROCESSING_WAITING_TIME
+  MetricKind::SUM,     ///< NODE_TOTAL_COMMUNICATION_TIME
+  MetricKind::SUM,     ///< NODE_TOTAL_COMMUNICATION_WAITING_TIME
+  MetricKind::COUNT,   ///< NODE_TOTAL_MASTER_SERVICES
+  MetricKind::COUNT,   ///< NODE_TOTAL_LINK_SERVICES
+  MetricKind::COUNT,   ///< NODE_TOTAL_MACHINE_SERVICES
+  MetricKind::COUNT,   ///< NODE_TOTAL_SWITCH_SERVICES
+  MetricKind::COUNT,   ///< NODE_TOTAL_COMPLETED_TASKS
+  MetricKind::SUM,     ///< NODE_TOTAL_COMPUTATIONAL_POWER
+  MetricKind::COUNT,   ///< NODE_TOTAL_CPU_CORES
+  MetricKind::COUNT,   ///< NODE_TOTAL_GPU_CORES
+  MetricKind::SUM,     ///< NODE_TOTAL_TURNAROUND_TIME
+  MetricKind::SUM,     ///< NODE_TOTAL_NON_IDLE_ENERGY_CONSUMPTION
+  MetricKind::SUM,     ///< NODE_TOTAL_POWER_IDLE
+  MetricKind::MAX,     ///< NODE_SIMULATION_TIME
+};
 
-  /// \brief The accumulation of the real time taken (ns) to process forwarding an event in a link.
-  NODE_LINK_FORWARD_TIME,
+/// \brief The amount of node-level metrics.
+inline constexpr std::size_t g_NodeMetricsCount = std::size(g_NodeMetricsKinds);
+
+/// \brief Returns whether a metric of the specified kind is kept in the doubles array.
+constexpr bool hasDoubleSlot(const MetricKind kind) {
+  return kind != MetricKind::COUNT;
+}
+
+/// \brief Returns whether a metric of the specified kind is kept in the counters array.
+constexpr bool hasCounterSlot(const MetricKind kind) {
+  return kind == MetricKind::COUNT;
+}
+
+/// \brief Returns the index of the specified metric in the doubles array.
+constexpr std::size_t getDoubleSlot(const NodeMetricsFlag flag) {
+  std::size_t slot = 0;
+  for (std::size_t i = 0; i < static_cast<std::size_t>(flag); i++)
+    slot += hasDoubleSlot(g_NodeMetricsKinds[i]);
+  return slot;
+}
+
+/// \brief Returns the index of the specified metric in the counters array.
+constexpr std::size_t getCounterSlot(const NodeMetricsFlag flag) {
+  std::size_t slot = 0;
+  for (std::size_t i = 0; i < static_cast<std::size_t>(flag); i++)
+    slot += hasCounterSlot(g_NodeMetricsKinds[i]);
+  return slot;
+}
+
+/// \brief The size of the doubles array.
+inline constexpr std::size_t g_NodeMetricsDoubleCount =
+    getDoubleSlot(static_cast<NodeMetricsFlag>(g_NodeMetricsCount));
+
+/// \brief The size of the counters array.
+inline constexpr std::size_t g_NodeMetricsCounterCount =
+    getCounterSlot(static_cast<NodeMetricsFlag>(g_NodeMetricsCount));
+
+/// \brief The compile-time description of a node-level metric.
+///
+/// \tparam Flag The metric's flag, which is its compile-time identifier.
+template <NodeMetricsFlag Flag>
+struct MetricTraits final {
+  static_assert(static_cast<std::size_t>(Flag) < g_NodeMetricsCount,
+                "The metric has no registered kind.");
 
-  /// \brief The accumulation of the real time taken (ns) to reverse the process of an event in a link.
-  NODE_LINK_REVERSE_TIME,
+  /// \brief The metric's kind.
+  static constexpr MetricKind kind = g_NodeMetricsKinds[static_cast<std::size_t>(Flag)];
 
-  /// \brief The accumulation of the real time taken (ns) to process forwarding an event in a machine.
-  NODE_MACHINE_FORWARD_TIME,
-  
-  /// \brief The accumulation of the real time taken (ns) to reverse the process of an event in a machine.
-  NODE_MACHINE_REVERSE_TIME,
+  /// \brief The type of the values notified for the metric.
+  using value_type = std::conditional_t<kind == MetricKind::COUNT, std::uint64_t, double>;
 
-  /// \brief The accumulation of the real time taken (ns) to process forwarding an event in a switch.
-  NODE_SWITCH_FORWARD_TIME,
-  
-  /// \brief The accumulation of the real time taken (ns) to reverse the process of an event in a switch.
-  NODE_SWITCH_REVERSE_TIME,
-#endif // DEBUG_ON
+  /// \brief The metric's index in the doubles array.
+  static constexpr std::size_t double_slot = getDoubleSlot(Flag);
+
+  /// \brief The metric's index in the counters array.
+  static constexpr std::size_t counter_slot = getCounterSlot(Flag);
+};
+
+/// \brief Keeps the node-level metrics in a structure of arrays.
+///
+/// The metrics are indexed by slots that are computed at compile time from their flags. Hence,
+/// notifying a metric is a single array update, and all metrics can be reduced among the nodes
+/// at once.
+struct MetricsRegistry {
+  std::array<double, g_NodeMetricsDoubleCount> m_Doubles{};          ///< The double-valued metrics.
+  std::array<std::uint64_t, g_NodeMetricsCounterCount> m_Counters{}; ///< The counted metrics.
+
+  /// \brief Returns the value of the specified double-valued metric.
+  template <NodeMetricsFlag Flag>
+  [[nodiscard]] inline double getValue() const noexcept {
+    static_assert(hasDoubleSlot(MetricTraits<Flag>::kind), "The metric is not double-valued.");
+    return m_Doubles[MetricTraits<Flag>::double_slot];
+  }
+
+  /// \brief Returns the count of the specified counted metric.
+  template <NodeMetricsFlag Flag>
+  [[nodiscard]] inline std::uint64_t getCount() const noexcept {
+    static_assert(hasCounterSlot(MetricTraits<Flag>::kind), "The metric is not counted.");
+    return m_Counters[MetricTraits<Flag>::counter_slot];
+  }
 };
 
 /// \brief Collects and reports various node-level metrics related to simulation components within a node.
@@ -102,108 +198,97 @@ enum class NodeMetricsFlag {
 /// The NodeMetricsCollector class provides a mechanism for collecting and reporting a variety of node-level metrics
 /// related to different simulation components within a node. These metrics help track and analyze the performance,
 /// behavior, and resource utilization of the simulated system at a granular level.
-class NodeMetricsCollector {
-private:
-  unsigned m_NodeTotalMasterServices;           ///< Total count of master services simulated in this node.
-  unsigned m_NodeTotalLinkServices;             ///< Total count of link services simulated in this node.
-  unsigned m_NodeTotalMachineServices;          ///< Total count of machine services simulated in this node.
-  unsigned m_NodeTotalSwitchServices;           ///< Total count of switch services simulated in this node.
-  unsigned m_NodeTotalCompletedTasks;           ///< Total count of completed tasks simulated in this node.
-
-  double m_NodeTotalComputationalPower;         ///< Total computational power simulatted in this node.
-  unsigned m_NodeTotalCpuCores;                 ///< Total count of CPU cores simulated in this node.
-  unsigned m_NodeTotalGpuCores;                 ///< Total count of GPU cores simulated in this node.
-
-  double m_NodeTotalCommunicatedMBits;          ///< Total communicated MBits simulated in this node.
-  double m_NodeTotalProcessedMFlops;            ///< Total processed MFLOPS simulated in this node.
-  double m_NodeTotalProcessingTime;             ///< Total processing time simulated in this node.
-  double m_NodeTotalProcessingWaitingTime;      ///< Total waiting time for processing simulated in this node.
-  double m_NodeTotalCommunicationTime;          ///< Total communication time simulated in this node.
-  double m_NodeTotalCommunicationWaitingTime;   ///< Total waiting time for communication simulated in this node.
-  double m_NodeTotalTurnaroundTime;             ///< Total turnaround time simulated in this node.
-  double m_NodeTotalNonIdleEnergyConsumption;   ///< Total non idle energy consumption (in Joules) in this node.
-  double m_NodeTotalPowerIdle;                  ///< Total idle power consumption from the services in this node.
-  double m_NodeSimulationTime;                  ///< The highest last activity time of a service center simulated in this node.
-
-#ifdef DEBUG_ON
-  std::unordered_map<ispd::services::ServiceType, double> m_NodeTotalForwardTime;
-  std::unordered_map<ispd::services::ServiceType, uint64_t> m_NodeTotalForwardEventsCount;
-  std::unordered_map<ispd::services::ServiceType, double> m_NodeTotalReverseTime;
-  std::unordered_map<ispd::services::ServiceType, uint64_t> m_NodeTotalReverseEventsCount;
-#endif // DEBUG_ON
-
-  void reportNodeUserMetrics();
+class NodeMetricsCollector : public MetricsRegistry {
 public:
-    /// \brief Notify the NodeMetricsCollector about a node-level metric with a flag.
+    /// \brief Notify the NodeMetricsCollector about a node-level metric.
     ///
-    /// This method allows notifying the NodeMetricsCollector about a specific node-level metric using the provided flag.
-    /// The corresponding metric value will be updated based on the flag provided.
+    /// The corresponding metric is updated following its kind, which is resolved at compile time. Therefore, there is
+    /// no run-time dispatch and notifying a metric with a value of the wrong type does not compile.
     ///
-    /// \param flag The flag indicating the type of metric to be notified.
-    void notifyMetric(const NodeMetricsFlag flag);
-
-    /// \brief Notify the NodeMetricsCollector about a node-level metric with a flag and a value.
-    ///
-    /// This templated method allows notifying the NodeMetricsCollector about a specific node-level metric using the
-    /// provided flag and associated value. The corresponding metric value will be updated based on the flag and value
-    /// provided.
-    ///
-    /// \tparam T The type of the metric value.
-    /// \param flag The flag indicating the type of metric to be notified.
-    /// \param value The value of the metric to be updated.
-    template <typename T>
-    void notifyMetric(const NodeMetricsFlag flag, const T value);
+    /// \tparam Flag The flag indicating the type of metric to be notified.
+    /// \param value The value of the metric to be updated. The counted metrics are incremented by one by default.
+    template <NodeMetricsFlag Flag>
+    inline void notifyMetric(const typename MetricTraits<Flag>::value_type value = 1) {
+      using Traits = MetricTraits<Flag>;
+
+      if constexpr (Traits::kind == MetricKind::SUM) {
+        m_Doubles[Traits::double_slot] += value;
+      } else if constexpr (Traits::kind == MetricKind::MAX) {
+        m_Doubles[Traits::double_slot] = std::max(m_Doubles[Traits::double_slot], value);
+      } else {
+        m_Counters[Traits::counter_slot] += value;
+      }
+    }
 
     /// \brief Report the collected node-level metrics to the master node.
     ///
-    /// This method is responsible for reporting the collected node-level metrics to the master node.
-    /// It performs communication and aggregation of metrics as required by the simulation setup.
+    /// All node-level metrics and all users' metrics are packed into a single buffer, which is reduced to the master
+    /// node by a single collective with a custom reduction operation that sums or takes the maximum of each packed
+    /// metric following its kind.
     void reportNodeMetrics();
 };
 
+/// \struct GlobalMetricsSummary
+///
+/// \brief The global-level metrics along with the metrics derived from them, such as the averages, the efficiency
+///        and the energy consumption.
+struct GlobalMetricsSummary final {
+  double m_SimulationTime;
+  double m_TotalProcessedMFlops;
+  double m_TotalCommunicatedMBits;
+  double m_TotalProcessingTime;
+  double m_TotalProcessingWaitingTime;
+  double m_TotalCommunicationTime;
+  double m_TotalCommunicationWaitingTime;
+  double m_TotalTurnaroundTime;
+  double m_TotalComputationalPower;
+  double m_TotalNonIdleEnergyConsumption;
+  double m_TotalPowerIdle;
+  std::uint64_t m_TotalMasterServices;
+  std::uint64_t m_TotalLinkServices;
+  std::uint64_t m_TotalMachineServices;
+  std::uint64_t m_TotalSwitchServices;
+  std::uint64_t m_TotalCompletedTasks;
+  std::uint64_t m_TotalCpuCores;
+  std::uint64_t m_TotalGpuCores;
+
+  double m_AvgProcessingTime;
+  double m_AvgProcessingWaitingTime;
+  double m_AvgCommunicationTime;
+  double m_AvgCommunicationWaitingTime;
+  double m_AvgTurnaroundTime;
+  double m_MaxComputationalPower;   ///< The achieved computational power (Rmax).
+  double m_Efficiency;              ///< The ratio between Rmax and Rpeak.
+  double m_TotalEnergyConsumption;  ///< The dynamic and static energy consumption.
+  double m_AvgPower;
+  double m_EnergyEfficiency;
+};
+
 /// \brief Collects and reports global-level metrics aggregated from multiple nodes within the simulation.
 ///
 /// The GlobalMetricsCollector class is responsible for collecting and reporting global-level metrics that are aggregated
 /// from multiple nodes within the simulation. These metrics provide a high-level overview of the entire simulated system's
 /// performance, resource utilization, and behavior.
-class GlobalMetricsCollector {
+class GlobalMetricsCollector : public MetricsRegistry {
     friend NodeMetricsCollector;  ///< Allows NodeMetricsCollector to access private members.
 
 private:
-    unsigned m_GlobalTotalMasterServices;           ///< Total count of master services across all nodes.
-    unsigned m_GlobalTotalLinkServices;             ///< Total count of link services across all nodes.
-    unsigned m_GlobalTotalMachineServices;          ///< Total count of machine services across all nodes.
-    unsigned m_GlobalTotalSwitchServices;           ///< Total count of switch services across all nodes.
-    unsigned m_GlobalTotalCompletedTasks;           ///< Total count of completed tasks across all nodes.
-
-    double m_GlobalTotalComputationalPower;         ///< Total computational power across all nodes.
-    unsigned m_GlobalTotalCpuCores;                 ///< Total count of CPU cores across all nodes.
-    unsigned m_GlobalTotalGpuCores;                 ///< Total count of GPU cores across all nodes.
-
-    double m_GlobalTotalCommunicatedMBits;          ///< Total communicated MBits across all nodes.
-    double m_GlobalTotalProcessedMFlops;            ///< Total processed MFLOPS across all nodes.
-    double m_GlobalTotalProcessingTime;             ///< Total processing time across all nodes.
-    double m_GlobalTotalProcessingWaitingTime;      ///< Total waiting time for processing across all nodes.
-    double m_GlobalTotalCommunicationTime;          ///< Total communication time across all nodes.
-    double m_GlobalTotalCommunicationWaitingTime;   ///< Total waiting time for communication across all nodes.
-    double m_GlobalTotalTurnaroundTime;             ///< Total turnaround time across all nodes.
-    double m_GlobalTotalNonIdleEnergyConsumption;   ///< Total non idle energy consumption across all nodes.
-    double m_GlobalTotalPowerIdle;                  ///< Total power idle across all nodes.
-    double m_GlobalSimulationTime;                  ///< Total simulation time.
-
-    std::unordered_map<ispd::model::User::uid_t, ispd::metrics::UserMetrics> m_GlobalUserMetrics; ///< Total user metrics.
-#ifdef DEBUG_ON
-  std::unordered_map<ispd::services::ServiceType, double> m_GlobalTotalForwardTime;
-  std::unordered_map<ispd::services::ServiceType, uint64_t> m_GlobalTotalForwardEventsCount;
-  std::unordered_map<ispd::services::ServiceType, double> m_GlobalTotalReverseTime;
-  std::unordered_map<ispd::services::ServiceType, uint64_t> m_GlobalTotalReverseEventsCount;
-#endif // DEBUG_ON
+    std::map<ispd::model::User::uid_t, ispd::metrics::UserMetrics> m_GlobalUserMetrics; ///< Total user metrics.
+
+    /// \brief Derives the summary of the aggregated global-level metrics.
+    [[nodiscard]] GlobalMetricsSummary summarize() const;
+
 public:
     /// \brief Report the aggregated global-level metrics to an external source.
     ///
     /// This method is responsible for reporting the aggregated global-level metrics and some other calculated
     /// metrics to the standard output.
     void reportGlobalMetrics();
+
+    /// \brief Write the aggregated global-level and user-level metrics to the JSON run report.
+    ///
+    /// \param json The run report's writer, positioned where the metrics' object should be written.
+    void writeGlobalMetrics(ispd::report::JsonWriter &json) const;
 };
 
 }; // namespace ispd::metrics
@@ -218,24 +303,18 @@ namespace ispd::node_metrics {
     /// Pointer to the global instance of the NodeMetricsCollector responsible for tracking node-level metrics.
     extern ispd::metrics::NodeMetricsCollector *g_NodeMetricsCollector;
 
-    /// \brief Notify the metrics collector about a node-level metric without a value.
+    /// \brief Notify the metrics collector about a node-level metric.
     ///
-    /// This function is used to notify the metrics collector about a specific node-level metric that does not require
-    /// an associated value. The provided metric flag indicates the type of metric being reported.
+    /// This function is used to notify the metrics collector about a specific node-level metric. The metric flag is a
+    /// template parameter, therefore, the metric's storage slot and the way it is updated are resolved at compile time.
     ///
-    /// \param flag The flag representing the specific node-level metric to notify.
-    void notifyMetric(const ispd::metrics::NodeMetricsFlag flag);
-
-    /// \brief Notify the metrics collector about a node-level metric with a value.
-    ///
-    /// This function is used to notify the metrics collector about a specific node-level metric along with an associated value.
-    /// The provided metric flag indicates the type of metric being reported, and the value parameter holds the corresponding value.
-    ///
-    /// \tparam T The data type of the metric value.
-    /// \param flag The flag representing the specific node-level metric to notify.
-    /// \param value The value associated with the reported metric.
-    template <typename T>
-    void notifyMetric(const ispd::metrics::NodeMetricsFlag flag, const T value);
+    /// \tparam Flag The flag representing the specific node-level metric to notify.
+    /// \param value The value associated with the reported metric. The counted metrics are incremented by one by default.
+    template <ispd::metrics::NodeMetricsFlag Flag>
+    inline void notifyMetric(const typename ispd::metrics::MetricTraits<Flag>::value_type value = 1) {
+      /// Forward the notification to the node metrics collector.
+      g_NodeMetricsCollector->notifyMetric<Flag>(value);
+    }
 
     /// \brief Report the aggregated node-level metrics to an external source.
     ///
@@ -262,6 +341,11 @@ namespace ispd::global_metrics {
     /// It facilitates the communication and analysis of metrics collected from across the entire simulation setup.
     void reportGlobalMetrics();
 
+    /// \brief Write the aggregated global-level metrics to the JSON run report.
+    ///
+    /// This function must only be called at the master node, after the metrics have been reduced.
+    void writeGlobalMetrics(ispd::report::JsonWriter &json);
+
 } // namespace ispd::global_metrics
 
 #endif // ISPD_METRICS_HPP
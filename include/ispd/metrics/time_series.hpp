@@ -0,0 +1,199 @@
+/// \file time_series.hpp
+///
+/// \brief This file defines the windowed time series, which keep the
+/// evolution of the system's metrics along the simulated time, so that the
+/// warm-up, the saturation onset and the drain of a run can be observed.
+///
+/// The simulated time is split into windows of fixed width, and each window
+/// accumulates the metrics of the events committed within it. Since only
+/// committed events are accounted, the rolled back events never corrupt the
+/// series.
+///
+/// The series of each rank are kept under a memory cap. Whenever a committed
+/// event falls beyond the last window that fits in the cap, every pair of
+/// adjacent windows is merged and the window width is doubled.
+///
+#ifndef ISPD_METRICS_TIME_SERIES_HPP
+#define ISPD_METRICS_TIME_SERIES_HPP
+
+#include <ross.h>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace ispd::metrics {
+
+/// \struct SeriesWindow
+///
+/// \brief The metrics accumulated in a window of simulated time.
+struct SeriesWindow final {
+  std::uint64_t m_CompletedTasks;    ///< The completed tasks (throughput).
+  std::uint64_t m_MachineWaits;      ///< The tasks that have waited at machines.
+  std::uint64_t m_LinkWaits;         ///< The packets that have waited at links.
+  double m_MachineBusyTime;          ///< The machines' processing time.
+  double m_LinkBusyTime;             ///< The links' communication time.
+  double m_MachineWaitingTime;       ///< The tasks' waiting time at machines.
+  double m_LinkWaitingTime;          ///< The packets' waiting time at links.
+
+  /// \brief Adds the metrics of the specified window to this window.
+  void merge(const SeriesWindow &other) noexcept;
+};
+
+/// \struct SeriesMachine
+///
+/// \brief A machine whose utilization is kept by the time series.
+struct SeriesMachine final {
+  std::uint64_t m_Gid;   ///< The machine's global identifier.
+  std::uint64_t m_Cores; ///< The machine's amount of cores.
+};
+
+/// \struct SeriesHeader
+///
+/// \brief The header of a rank's time series file.
+///
+/// The header is followed by `m_MachineCount` machines, by `m_Count` windows
+/// and by the machines' busy time in each window, which is laid out window by
+/// window in the machines' order.
+///
+/// The utilization of a machine in a window is its busy time divided by the
+/// product of the window's width and its amount of cores. Similarly, the
+/// links' utilization is the window's links busy time divided by the product
+/// of the window's width and the amount of link directions of the rank.
+struct SeriesHeader final {
+  char m_Magic[8];              ///< Always "ISPDTS".
+  std::uint32_t m_Version;      ///< The file format version.
+  std::uint32_t m_Rank;         ///< The rank that has written the file.
+  std::uint64_t m_Count;        ///< The amount of windows.
+  double m_Width;               ///< The windows' width (in simulated time).
+  std::uint64_t m_MachineCount; ///< The amount of the rank's machines.
+  std::uint64_t m_LinkChannels; ///< The directions of the rank's links.
+};
+
+/// \class TimeSeries
+///
+/// \brief The windowed time series of a rank.
+class TimeSeries final {
+public:
+  /// \brief Constructs the time series.
+  ///
+  /// \param width The initial windows' width (in simulated time).
+  /// \param maxWindows The maximum amount of windows to be kept.
+  explicit TimeSeries(const double width, const std::size_t maxWindows);
+
+  /// \brief Returns the index of the window that contains the specified
+  ///        simulated time, downsampling the series if it does not fit in the
+  ///        memory cap.
+  [[nodiscard]] std::size_t locate(const double time);
+
+  /// \brief Returns the window at the specified index.
+  [[nodiscard]] inline SeriesWindow &getWindow(const std::size_t index) {
+    return m_Windows[index];
+  }
+
+  /// \brief Returns the busy time of a machine in the window at the specified
+  ///        index.
+  [[nodiscard]] inline double &getMachineBusyTime(const std::size_t index,
+                                                  const unsigned slot) {
+    return m_MachineBusyTime[index * m_Machines.size() + slot];
+  }
+
+  /// \brief Accounts a simulated machine.
+  ///
+  /// \return The machine's slot in the time series.
+  [[nodiscard]] unsigned addMachine(const tw_lpid gid, const unsigned cores);
+
+  /// \brief Accounts the capacity of a simulated link.
+  inline void addLink() noexcept { m_LinkChannels += 2; }
+
+  /// \brief Returns the amount of link directions accounted so far.
+  [[nodiscard]] inline std::uint64_t getLinkChannels() const noexcept {
+    return m_LinkChannels;
+  }
+
+  /// \brief Writes the series to the specified file.
+  void write(const std::string &filepath) const;
+
+private:
+  /// \brief Merges every pair of adjacent windows and doubles their width.
+  void downsample();
+
+  double m_Width;                        ///< The current windows' width.
+  std::size_t m_MaxWindows;              ///< The maximum amount of windows.
+  std::vector<SeriesWindow> m_Windows;   ///< The windows.
+  std::vector<SeriesMachine> m_Machines; ///< The rank's machines.
+  std::vector<double> m_MachineBusyTime; ///< The machines' busy time.
+  std::uint64_t m_LinkChannels = 0;      ///< The directions of the rank's links.
+};
+
+}; // namespace ispd::metrics
+
+namespace ispd::time_series {
+
+/// \brief The rank's time series, or `nullptr` if they are disabled.
+///
+/// \note It is exposed so that the accounting can be inlined in the commit
+///       handlers.
+extern ispd::metrics::TimeSeries *g_Series;
+
+/// \brief Enables the time series.
+///
+/// \param width The initial windows' width (in simulated time).
+/// \param maxWindows The maximum amount of windows to be kept by each rank.
+/// \param dumpPrefix The prefix of the files to be written.
+void init(const double width, const std::size_t maxWindows,
+          const std::string &dumpPrefix);
+
+/// \brief Accounts a completed task at the specified simulated time.
+inline void completeTask(const double time) {
+  if (g_Series)
+    g_Series->getWindow(g_Series->locate(time)).m_CompletedTasks++;
+}
+
+/// \brief Accounts a task processed by a machine at the specified time.
+///
+/// \param slot The machine's slot, as returned by `addMachine`.
+inline void processTask(const unsigned slot, const double time,
+                        const double procTime, const double waitingTime) {
+  if (g_Series) {
+    const auto index = g_Series->locate(time);
+    auto &window = g_Series->getWindow(index);
+    g_Series->getMachineBusyTime(index, slot) += procTime;
+    window.m_MachineBusyTime += procTime;
+    window.m_MachineWaitingTime += waitingTime;
+    window.m_MachineWaits++;
+  }
+}
+
+/// \brief Accounts a packet communicated by a link at the specified time.
+inline void communicatePacket(const double time, const double commTime,
+                              const double waitingTime) {
+  if (g_Series) {
+    auto &window = g_Series->getWindow(g_Series->locate(time));
+    window.m_LinkBusyTime += commTime;
+    window.m_LinkWaitingTime += waitingTime;
+    window.m_LinkWaits++;
+  }
+}
+
+/// \brief Accounts a machine with the specified cores.
+///
+/// \return The machine's slot in the time series, or zero if they are
+///         disabled.
+inline unsigned addMachine(const tw_lpid gid, const unsigned cores) {
+  return g_Series ? g_Series->addMachine(gid, cores) : 0;
+}
+
+/// \brief Accounts the capacity of a link.
+inline void addLink() {
+  if (g_Series)
+    g_Series->addLink();
+}
+
+/// \brief Writes the rank's time series to `<prefix>.<rank>.series`.
+///
+/// \note This function must be called after `tw_run`.
+void finish();
+
+}; // namespace ispd::time_series
+
+#endif // ISPD_METRICS_TIME_SERIES_HPP
@@ -7,15 +7,44 @@
 #include <unordered_map>
 #include <ispd/log/log.hpp>
 #include <ispd/model/user.hpp>
+#include <ispd/services/services.hpp>
 #include <ispd/workload/workload.hpp>
 #include <ispd/scheduler/scheduler.hpp>
 
 namespace ispd::model {
 
+/// \struct LinkDescriptor
+///
+/// \brief Describes the ends of a registered link.
+///
+/// The link descriptors are kept by the model so that the service graph (the
+/// graph whose vertices are the services and whose edges are the connections
+/// between them) can be reconstructed before the simulation starts.
+struct LinkDescriptor final {
+  tw_lpid m_Gid;  ///< The link's global identifier.
+  tw_lpid m_From; ///< The service at the link's upward end.
+  tw_lpid m_To;   ///< The service at the link's downward end.
+};
+
+/// \struct MasterDescriptor
+///
+/// \brief Describes a registered master, its slaves and its task count.
+///
+/// The master descriptors are kept by the model so that the expected traffic
+/// through each route starting from the master can be estimated before the
+/// simulation starts.
+struct MasterDescriptor final {
+  tw_lpid m_Gid;                 ///< The master's global identifier.
+  std::vector<tw_lpid> m_Slaves; ///< The master's slaves.
+  unsigned m_TaskCount;          ///< The amount of tasks to be generated.
+};
+
 class SimulationModel {
 public:
   using service_init_map_type =
       std::unordered_map<tw_lpid, std::function<void(void *)>>;
+  using service_type_map_type =
+      std::unordered_map<tw_lpid, ispd::services::ServiceType>;
   using user_map_type = std::unordered_map<User::uid_t, User>;
 
   void registerMachine(const tw_lpid gid, const double power, const double load,
@@ -41,6 +70,23 @@ public:
   [[nodiscard]] const std::function<void(void *)> &
   getServiceInitializer(const tw_lpid gid) noexcept;
 
+  [[nodiscard]] ispd::services::ServiceType
+  getServiceType(const tw_lpid gid) const noexcept;
+
+  [[nodiscard]] inline tw_lpid getServiceCount() const noexcept {
+    return static_cast<tw_lpid>(m_ServiceTypes.size());
+  }
+
+  [[nodiscard]] inline const std::vector<LinkDescriptor> &
+  getLinks() const noexcept {
+    return m_Links;
+  }
+
+  [[nodiscard]] inline const std::vector<MasterDescriptor> &
+  getMasters() const noexcept {
+    return m_Masters;
+  }
+
   [[nodiscard]] inline const user_map_type &getUsers() const noexcept {
     return m_Users;
   }
@@ -58,18 +104,23 @@ public:
 
 private:
   service_init_map_type service_initializers;
+  service_type_map_type m_ServiceTypes;
+  std::vector<LinkDescriptor> m_Links;
+  std::vector<MasterDescriptor> m_Masters;
   user_map_type m_Users;
 
   inline void
   registerServiceInitializer(const tw_lpid gid,
+                             const ispd::services::ServiceType type,
                              std::function<void(void *)> initializer) {
     /// Checks if a service with the specified global identifier has already
     /// been registered. If so, the program is immediately aborted.
     if (service_initializers.find(gid) != service_initializers.end())
       ispd_error("A service with GID %lu has already been registered.", gid);
 
-    /// Emplace the pair (gid, initializer).
+    /// Emplace the pair (gid, initializer) and the pair (gid, type).
     service_initializers.emplace(gid, initializer);
+    m_ServiceTypes.emplace(gid, type);
   }
 };
 
@@ -98,6 +149,14 @@ void registerUser(const std::string &name, const double energyConsumptionLimit);
 [[nodiscard]] const std::function<void(void *)> &
 getServiceInitializer(const tw_lpid gid);
 
+[[nodiscard]] ispd::services::ServiceType getServiceType(const tw_lpid gid);
+
+[[nodiscard]] tw_lpid getServiceCount();
+
+[[nodiscard]] const std::vector<ispd::model::LinkDescriptor> &getLinks();
+
+[[nodiscard]] const std::vector<ispd::model::MasterDescriptor> &getMasters();
+
 [[nodiscard]] const ispd::model::SimulationModel::user_map_type &getUsers();
 
 [[nodiscard]] ispd::model::User &getUserById(ispd::model::User::uid_t id);
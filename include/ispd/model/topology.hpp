@@ -0,0 +1,48 @@
+/// \file topology.hpp
+///
+/// \brief This file declares the topology generators, which register the
+/// services and the routes of synthetic models at the model builder and at the
+/// routing table.
+///
+/// The generated services receive global identifiers (GIDs) in depth-first
+/// order, so that every subtree of the topology has contiguous GIDs.
+///
+#ifndef ISPD_MODEL_TOPOLOGY_HPP
+#define ISPD_MODEL_TOPOLOGY_HPP
+
+#include <ross.h>
+#include <string>
+
+namespace ispd::topology {
+
+/// \brief Generates a star topology.
+///
+/// The master has GID 0 and is connected to each machine by a dedicated link.
+/// The links have odd GIDs and the machines have even GIDs, that is, the
+/// machine `2i` is connected to the master through the link `2i - 1`.
+///
+/// \param user The name of the user that owns the workload.
+/// \param machineCount The amount of machines.
+/// \param taskCount The amount of tasks to be generated by the master.
+void star(const std::string &user, const unsigned machineCount,
+          const unsigned taskCount);
+
+/// \brief Generates a tree topology.
+///
+/// The master is the tree's root. Each inner vertex (the master or a switch)
+/// has `fanout` children, each one connected to it by a dedicated link, and
+/// the leaves at the specified depth are machines. Therefore, there are
+/// `fanout^depth` machines and each switch at depth `depth - 1` along with its
+/// links and machines models a rack.
+///
+/// \param user The name of the user that owns the workload.
+/// \param fanout The amount of children of each inner vertex.
+/// \param depth The depth of the machines, which must be at least 1. A tree
+///              with depth 1 is a star.
+/// \param taskCount The amount of tasks to be generated by the master.
+void tree(const std::string &user, const unsigned fanout, const unsigned depth,
+          const unsigned taskCount);
+
+}; // namespace ispd::topology
+
+#endif // ISPD_MODEL_TOPOLOGY_HPP
@@ -2,6 +2,7 @@
 #define ISPD_MODEL_USER_HPP
 
 #include <cstdint>
+#include <ispd/metrics/histogram.hpp>
 #include <ispd/metrics/user_metrics.hpp>
 
 namespace ispd::model {
@@ -69,6 +70,15 @@ public:
     return m_Metrics;
   }
 
+  /// \brief Retrieve the node's view of the user's task latency histograms.
+  ///
+  /// \return A reference to the `TaskHistograms` object storing the user's
+  /// latency histograms.
+  [[nodiscard]] inline ispd::metrics::TaskHistograms &
+  getHistograms() noexcept {
+    return m_Histograms;
+  }
+
   /// \brief Get the energy consumption limit of the user.
   ///
   /// \return The energy consumption limit set for the user.
@@ -80,6 +90,7 @@ private:
   uid_t m_Id;                            ///< The user's unique identifier.
   std::string m_Name;                    ///< The user's name.
   ispd::metrics::UserMetrics m_Metrics;  ///< The node's view of user's metrics.
+  ispd::metrics::TaskHistograms m_Histograms; ///< The node's view of user's histograms.
   double m_EnergyConsumptionLimit = 0.0; ///< The energy consumption limit.
 };
 
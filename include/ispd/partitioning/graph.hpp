@@ -0,0 +1,165 @@
+/// \file graph.hpp
+///
+/// \brief This file defines the ServiceGraph class, the weighted graph whose
+/// vertices are the simulated services and whose edges are the connections
+/// between them.
+///
+/// The service graph is the input of the partitioners that decide in which
+/// processing element (PE) each logical process (LP) is going to be simulated.
+/// Vertex weights estimate how many events a service is going to process and
+/// edge weights estimate how many events are going to be exchanged between two
+/// services, so that cutting a heavy edge means many remote events.
+///
+#ifndef ISPD_PARTITIONING_GRAPH_HPP
+#define ISPD_PARTITIONING_GRAPH_HPP
+
+#include <ross.h>
+#include <vector>
+#include <cstdint>
+#include <utility>
+
+namespace ispd::partitioning {
+
+/// \class ServiceGraph
+///
+/// \brief An undirected weighted graph stored in the compressed sparse row
+///        (CSR) format.
+///
+/// The adjacency of the vertex `v` is stored at the positions
+/// `[m_Offsets[v], m_Offsets[v + 1])` of the `m_Adjacency` and `m_EdgeWeights`
+/// arrays. Every undirected edge is stored twice, once for each of its ends.
+/// For the graph built from the model, the vertex `v` is the service whose
+/// global identifier (GID) is `v`.
+class ServiceGraph final {
+public:
+  using vertex_type = std::uint64_t;
+  using weight_type = std::int64_t;
+
+  /// \brief Constructor for the ServiceGraph class.
+  ///
+  /// \param offsets The adjacency offsets of each vertex (vertex count + 1).
+  /// \param adjacency The concatenated adjacency lists.
+  /// \param edgeWeights The weight of each adjacency entry.
+  /// \param vertexWeights The weight of each vertex.
+  [[nodiscard]] explicit ServiceGraph(
+      std::vector<vertex_type> &&offsets, std::vector<vertex_type> &&adjacency,
+      std::vector<weight_type> &&edgeWeights,
+      std::vector<weight_type> &&vertexWeights) noexcept
+      : m_Offsets(std::move(offsets)), m_Adjacency(std::move(adjacency)),
+        m_EdgeWeights(std::move(edgeWeights)),
+        m_VertexWeights(std::move(vertexWeights)) {}
+
+  /// \brief Returns the amount of vertices in the graph.
+  [[nodiscard]] inline vertex_type getVertexCount() const noexcept {
+    return static_cast<vertex_type>(m_VertexWeights.size());
+  }
+
+  /// \brief Returns the adjacency offsets of each vertex.
+  [[nodiscard]] inline const std::vector<vertex_type> &
+  getOffsets() const noexcept {
+    return m_Offsets;
+  }
+
+  /// \brief Returns the concatenated adjacency lists.
+  [[nodiscard]] inline const std::vector<vertex_type> &
+  getAdjacency() const noexcept {
+    return m_Adjacency;
+  }
+
+  /// \brief Returns the weight of each adjacency entry.
+  [[nodiscard]] inline const std::vector<weight_type> &
+  getEdgeWeights() const noexcept {
+    return m_EdgeWeights;
+  }
+
+  /// \brief Returns the weight of each vertex.
+  [[nodiscard]] inline const std::vector<weight_type> &
+  getVertexWeights() const noexcept {
+    return m_VertexWeights;
+  }
+
+  /// \brief Sets the weight of the specified vertex.
+  ///
+  /// This allows the estimated weights to be replaced by measured ones, as
+  /// the event counts of a previous run.
+  inline void setVertexWeight(const vertex_type v,
+                              const weight_type weight) noexcept {
+    m_VertexWeights[v] = weight;
+  }
+
+  /// \brief Returns the sum of all vertices weights.
+  [[nodiscard]] weight_type getTotalVertexWeight() const noexcept;
+
+  /// \brief Returns the sum of the weights of the edges whose ends have been
+  ///        assigned to different parts.
+  ///
+  /// \param partition The part of each vertex.
+  [[nodiscard]] weight_type
+  computeEdgeCut(const std::vector<tw_peid> &partition) const noexcept;
+
+  /// \brief Returns the ratio between the heaviest part weight and the
+  ///        average part weight. A perfectly balanced partition has a ratio
+  ///        of 1.0.
+  ///
+  /// \param partition The part of each vertex.
+  /// \param partCount The amount of parts.
+  [[nodiscard]] double
+  computeImbalance(const std::vector<tw_peid> &partition,
+                   const tw_peid partCount) const noexcept;
+
+private:
+  std::vector<vertex_type> m_Offsets;
+  std::vector<vertex_type> m_Adjacency;
+  std::vector<weight_type> m_EdgeWeights;
+  std::vector<weight_type> m_VertexWeights;
+};
+
+/// \class ServiceGraphBuilder
+///
+/// \brief Accumulates vertex and edge weights and, then, builds a
+///        ServiceGraph.
+///
+/// Adding the same edge more than once accumulates its weight, which allows
+/// the traffic of every route that passes through an edge to be summed up.
+class ServiceGraphBuilder final {
+public:
+  using vertex_type = ServiceGraph::vertex_type;
+  using weight_type = ServiceGraph::weight_type;
+
+  /// \brief Constructor for the ServiceGraphBuilder class.
+  ///
+  /// \param vertexCount The amount of vertices of the graph to be built.
+  [[nodiscard]] explicit ServiceGraphBuilder(const vertex_type vertexCount)
+      : m_Edges(vertexCount), m_VertexWeights(vertexCount, 0) {}
+
+  /// \brief Adds the specified weight to the vertex weight.
+  void addVertexWeight(const vertex_type v, const weight_type weight);
+
+  /// \brief Adds the specified weight to the undirected edge (u, v).
+  void addEdge(const vertex_type u, const vertex_type v,
+               const weight_type weight);
+
+  /// \brief Builds the graph, merging the parallel edges.
+  [[nodiscard]] ServiceGraph build();
+
+private:
+  std::vector<std::vector<std::pair<vertex_type, weight_type>>> m_Edges;
+  std::vector<weight_type> m_VertexWeights;
+};
+
+/// \brief Builds the service graph of the registered model.
+///
+/// The links registered at the model builder give the graph's edges. Then, for
+/// each registered master, the amount of tasks that each slave is expected to
+/// receive is spread through the route that connects the master with the
+/// slave, since every task travels that route downward and its results travel
+/// it upward. Each edge and each vertex along the route is weighted by the
+/// amount of events expected to pass through it.
+///
+/// \note The routing table must have been loaded and all services must have
+///       been registered before calling this function.
+[[nodiscard]] ServiceGraph buildServiceGraph();
+
+}; // namespace ispd::partitioning
+
+#endif // ISPD_PARTITIONING_GRAPH_HPP
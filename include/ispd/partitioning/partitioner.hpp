@@ -0,0 +1,114 @@
+/// \file partitioner.hpp
+///
+/// \brief This file defines the partitioners used for mapping the logical
+/// processes (LPs) to the processing elements (PEs).
+///
+/// A partitioner splits the service graph into as many parts as there are
+/// processing elements, trying to minimize the weight of the cut edges (that
+/// approximates the amount of remote events) while keeping the parts' weights
+/// (that approximate the amount of processed events) balanced.
+///
+/// \note Every rank computes the same partition independently. Therefore, the
+///       partitioners must be deterministic.
+///
+#ifndef ISPD_PARTITIONING_PARTITIONER_HPP
+#define ISPD_PARTITIONING_PARTITIONER_HPP
+
+#include <ross.h>
+#include <vector>
+#include <ispd/partitioning/graph.hpp>
+
+namespace ispd::partitioning {
+
+/// \class Partitioner
+///
+/// \brief A base class representing a graph partitioner.
+class Partitioner {
+public:
+  virtual ~Partitioner() = default;
+
+  /// \brief Partitions the graph into the specified amount of parts.
+  ///
+  /// \param graph The graph to be partitioned.
+  /// \param partCount The amount of parts.
+  ///
+  /// \return The part of each vertex. Every part in `[0, partCount)` has at
+  ///         least one vertex, whenever the graph has at least `partCount`
+  ///         vertices.
+  [[nodiscard]] virtual std::vector<tw_peid>
+  partition(const ServiceGraph &graph, const tw_peid partCount) = 0;
+};
+
+/// \class MultilevelPartitioner
+///
+/// \brief A built-in multilevel k-way partitioner.
+///
+/// The graph is repeatedly coarsened by collapsing the vertices matched through
+/// their heaviest edges until it is small enough. Then, the coarsest graph is
+/// partitioned by growing each part from a seed vertex and, at last, the
+/// partition is projected back to the finer graphs, being refined at each
+/// level by greedily moving the boundary vertices that reduce the edge cut
+/// without breaking the balance constraint.
+///
+/// This is the same scheme used by METIS, although much simpler. It is meant
+/// to provide a good partition when METIS is not available.
+class MultilevelPartitioner final : public Partitioner {
+public:
+  /// \brief Constructor for the MultilevelPartitioner class.
+  ///
+  /// \param imbalance The allowed imbalance. For example, 0.03 allows the
+  ///                  heaviest part to weight 3% more than the average part.
+  [[nodiscard]] explicit MultilevelPartitioner(const double imbalance)
+      : m_Imbalance(imbalance) {}
+
+  [[nodiscard]] std::vector<tw_peid>
+  partition(const ServiceGraph &graph, const tw_peid partCount) override;
+
+private:
+  double m_Imbalance;
+};
+
+/// \class MetisPartitioner
+///
+/// \brief A partitioner that forwards the partitioning to METIS.
+///
+/// \note METIS is an optional dependency. If the simulator has been built
+///       without it (see the `ISPD_USE_METIS` option), using this partitioner
+///       aborts the program.
+class MetisPartitioner final : public Partitioner {
+public:
+  /// \brief Constructor for the MetisPartitioner class.
+  ///
+  /// \param imbalance The allowed imbalance. For example, 0.03 allows the
+  ///                  heaviest part to weight 3% more than the average part.
+  [[nodiscard]] explicit MetisPartitioner(const double imbalance)
+      : m_Imbalance(imbalance) {}
+
+  [[nodiscard]] std::vector<tw_peid>
+  partition(const ServiceGraph &graph, const tw_peid partCount) override;
+
+private:
+  double m_Imbalance;
+};
+
+/// \brief Create a new MultilevelPartitioner object.
+///
+/// \param imbalance The allowed imbalance.
+///
+/// \returns A pointer to the newly created MultilevelPartitioner object.
+///
+/// \note The caller is responsible for managing the object's memory.
+MultilevelPartitioner *multilevel(const double imbalance = 0.03);
+
+/// \brief Create a new MetisPartitioner object.
+///
+/// \param imbalance The allowed imbalance.
+///
+/// \returns A pointer to the newly created MetisPartitioner object.
+///
+/// \note The caller is responsible for managing the object's memory.
+MetisPartitioner *metis(const double imbalance = 0.03);
+
+}; // namespace ispd::partitioning
+
+#endif // ISPD_PARTITIONING_PARTITIONER_HPP
@@ -0,0 +1,177 @@
+/// \file handler_profile.hpp
+///
+/// \brief This file defines the handler profile, which measures how long the
+/// forward and reverse handlers of each service type take.
+///
+/// The handler profile is only compiled in the profiling build, in which
+/// ISPD_PROFILE_HANDLERS is defined, so that the other builds pay nothing for
+/// it. The handlers are measured by the handler wrappers, with the time stamp
+/// counter on x86 processors or with `CLOCK_MONOTONIC_RAW` otherwise, and the
+/// measurements are accumulated into fixed arrays indexed by service type.
+///
+/// Since reading a clock still costs tens of cycles, only one out of every
+/// `--handler-sample` calls of each handler may be measured.
+///
+/// On Linux, the measured calls are also measured by hardware performance
+/// counters (cycles, instructions, last-level cache misses and branch
+/// mispredictions), which are opened for the simulation's thread with
+/// `perf_event_open`. If the counters cannot be opened, as in containers that
+/// forbid them, only the time is measured.
+///
+#ifndef ISPD_PROFILING_HANDLER_PROFILE_HPP
+#define ISPD_PROFILING_HANDLER_PROFILE_HPP
+
+#include <cstdint>
+#include <ispd/services/services.hpp>
+#include <ispd/report/json.hpp>
+
+#ifdef ISPD_PROFILE_HANDLERS
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <time.h>
+#endif
+#endif // ISPD_PROFILE_HANDLERS
+
+namespace ispd::profiling {
+
+/// \brief The kinds of measured handlers.
+enum class HandlerKind { FORWARD, REVERSE };
+
+/// \brief The amount of measured service types and handler kinds.
+inline constexpr std::size_t g_ProfiledServiceTypes =
+    ispd::services::g_ServiceTypes.size();
+inline constexpr std::size_t g_ProfiledHandlerKinds = 2;
+
+/// \brief The hardware performance counters read around the measured calls.
+enum class HandlerCounter { CYCLES, INSTRUCTIONS, LLC_MISSES, BRANCH_MISSES };
+
+/// \brief The amount of hardware performance counters.
+inline constexpr std::size_t g_ProfiledCounters = 4;
+
+/// \struct HandlerTimes
+///
+/// \brief The measurements of the handlers, indexed by service type and by
+///        handler kind.
+struct HandlerTimes final {
+  /// \brief The amount of calls.
+  std::uint64_t m_Calls[g_ProfiledServiceTypes][g_ProfiledHandlerKinds];
+
+  /// \brief The amount of measured calls.
+  std::uint64_t m_Samples[g_ProfiledServiceTypes][g_ProfiledHandlerKinds];
+
+  /// \brief The clock ticks taken by the measured calls.
+  std::uint64_t m_Ticks[g_ProfiledServiceTypes][g_ProfiledHandlerKinds];
+
+  /// \brief The hardware performance counters' increments during the
+  ///        measured calls, indexed by `HandlerCounter`.
+  std::uint64_t m_Counters[g_ProfiledServiceTypes][g_ProfiledHandlerKinds]
+                          [g_ProfiledCounters];
+};
+
+/// \brief The service type of the logical processes with the specified state.
+///
+/// It is specialized next to each service's state, so that the handler
+/// wrappers resolve the service type of the wrapped handler at compile time.
+template <typename State> struct ServiceTypeOf;
+
+/// \brief Reads the profiling clock.
+///
+/// \return The time stamp counter on x86 processors, or the raw monotonic
+///         time in nanoseconds otherwise.
+#ifdef ISPD_PROFILE_HANDLERS
+inline std::uint64_t readClock() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+  return static_cast<std::uint64_t>(now.tv_sec) * 1000000000ull + now.tv_nsec;
+#endif
+}
+#endif // ISPD_PROFILE_HANDLERS
+
+}; // namespace ispd::profiling
+
+#ifdef ISPD_PROFILE_HANDLERS
+namespace ispd::handler_profile {
+
+/// \brief This node's handler measurements.
+///
+/// \note It is exposed so that the measurement can be inlined in the handler
+///       wrappers.
+extern ispd::profiling::HandlerTimes g_Times;
+
+/// \brief The mask of the call counter that selects the measured calls, that
+///        is, the sampling period minus one.
+extern std::uint64_t g_SampleMask;
+
+/// \brief Whether the hardware performance counters are read.
+extern bool g_CountersEnabled;
+
+/// \brief Starts the handler profile.
+///
+/// \param samplePeriod One out of every `samplePeriod` calls of each handler
+///                     is measured. It must be a power of two.
+/// \param counters Whether the hardware performance counters should be read,
+///                 if they are available.
+void init(const unsigned samplePeriod, const bool counters);
+
+/// \brief Reads the hardware performance counters.
+///
+/// \param values The counters' values, indexed by `HandlerCounter`.
+void readCounters(std::uint64_t (&values)[ispd::profiling::g_ProfiledCounters]);
+
+/// \brief Calls and measures a handler.
+template <ispd::services::ServiceType Type, ispd::profiling::HandlerKind Kind,
+          typename Call>
+inline void measure(Call &&call) {
+  constexpr auto type = static_cast<std::size_t>(Type);
+  constexpr auto kind = static_cast<std::size_t>(Kind);
+
+  /// Only the sampled calls are measured. The others are only counted.
+  if ((g_Times.m_Calls[type][kind]++ & g_SampleMask) != 0) {
+    call();
+    return;
+  }
+
+  /// The counters are read outside of the clock's readings, since reading
+  /// them takes a system call.
+  std::uint64_t before[ispd::profiling::g_ProfiledCounters];
+  if (g_CountersEnabled)
+    readCounters(before);
+
+  const std::uint64_t start = ispd::profiling::readClock();
+  call();
+  g_Times.m_Ticks[type][kind] += ispd::profiling::readClock() - start;
+  g_Times.m_Samples[type][kind]++;
+
+  if (g_CountersEnabled) {
+    std::uint64_t after[ispd::profiling::g_ProfiledCounters];
+    readCounters(after);
+
+    for (std::size_t i = 0; i < ispd::profiling::g_ProfiledCounters; i++)
+      g_Times.m_Counters[type][kind][i] += after[i] - before[i];
+  }
+}
+
+/// \brief Reduces the measurements of every node to the master node.
+///
+/// \note This function is collective and must be called after `tw_run` and
+///       before `tw_end`.
+void reduce();
+
+/// \brief Reports the average time and hardware performance counters of each
+///        handler.
+void report();
+
+/// \brief Writes the average time and hardware performance counters of each
+///        handler to the run report.
+///
+/// \note This function must only be called at the master node.
+void write(ispd::report::JsonWriter &json);
+
+}; // namespace ispd::handler_profile
+#endif // ISPD_PROFILE_HANDLERS
+
+#endif // ISPD_PROFILING_HANDLER_PROFILE_HPP
@@ -0,0 +1,114 @@
+/// \file handlers.hpp
+///
+/// \brief This file defines the handler wrappers, which instrument the
+/// services' handlers without changing them.
+///
+/// Each wrapper is specialized on the wrapped handler's function pointer, so
+/// that the call to the wrapped handler is resolved at compile time and can
+/// be inlined. For example, the master's forward handler is instrumented by
+/// registering `Forward<ispd::services::master::forward>::handle` in its LP
+/// type instead of the handler itself.
+///
+#ifndef ISPD_PROFILING_HANDLERS_HPP
+#define ISPD_PROFILING_HANDLERS_HPP
+
+#include <ross.h>
+#include <ispd/message/message.hpp>
+#include <ispd/report/report.hpp>
+#include <ispd/profiling/profile.hpp>
+#include <ispd/profiling/traffic.hpp>
+#include <ispd/memory/event_pool.hpp>
+#include <ispd/profiling/handler_profile.hpp>
+#include <ispd/profiling/trace.hpp>
+
+namespace ispd::profiling {
+
+template <auto Handler> struct Init;
+template <auto Handler> struct Forward;
+template <auto Handler> struct Reverse;
+template <auto Handler> struct Commit;
+template <auto Handler> struct Finish;
+
+/// \brief Calls a forward or reverse handler, which is measured by the
+///        handler profile and recorded by the trace in the builds that have
+///        them. Otherwise, the handler is simply called.
+template <ispd::services::ServiceType Type, HandlerKind Kind, typename Call>
+inline void invoke(Call &&call) {
+#ifdef ISPD_PROFILE_HANDLERS
+  const auto profiled = [&] { ispd::handler_profile::measure<Type, Kind>(call); };
+#else
+  const auto &profiled = call;
+#endif // ISPD_PROFILE_HANDLERS
+
+#ifdef ISPD_TRACE
+  ispd::trace::measure<Type, Kind>(profiled);
+#else
+  profiled();
+#endif // ISPD_TRACE
+}
+
+/// \brief The amount of local logical processes that have been initialized.
+inline tw_lpid g_InitializedLps = 0;
+
+/// \brief Instruments an initialization handler.
+///
+/// ROSS initializes every local logical process at the beginning of `tw_run`.
+/// Therefore, the initialization phase ends, and the run phase begins, once
+/// the last local logical process has been initialized.
+template <typename State, void (*Handler)(State *, tw_lp *)>
+struct Init<Handler> {
+  static void handle(State *s, tw_lp *lp) {
+    Handler(s, lp);
+
+    if (++g_InitializedLps == g_tw_nlp)
+      ispd::run_report::beginPhase("run");
+  }
+};
+
+/// \brief Instruments a forward event handler.
+template <typename State,
+          void (*Handler)(State *, tw_bf *, ispd_message *, tw_lp *)>
+struct Forward<Handler> {
+  static void handle(State *s, tw_bf *bf, ispd_message *msg, tw_lp *lp) {
+    ispd::lp_profile::countForward(lp);
+    ispd::event_pool::observe();
+
+    invoke<ServiceTypeOf<State>::value, HandlerKind::FORWARD>(
+        [&] { Handler(s, bf, msg, lp); });
+  }
+};
+
+/// \brief Instruments a reverse event handler.
+template <typename State,
+          void (*Handler)(State *, tw_bf *, ispd_message *, tw_lp *)>
+struct Reverse<Handler> {
+  static void handle(State *s, tw_bf *bf, ispd_message *msg, tw_lp *lp) {
+    ispd::lp_profile::countReverse(lp);
+
+    invoke<ServiceTypeOf<State>::value, HandlerKind::REVERSE>(
+        [&] { Handler(s, bf, msg, lp); });
+  }
+};
+
+/// \brief Instruments a commit handler.
+template <typename State,
+          void (*Handler)(State *, tw_bf *, ispd_message *, tw_lp *)>
+struct Commit<Handler> {
+  static void handle(State *s, tw_bf *bf, ispd_message *msg, tw_lp *lp) {
+    ispd::traffic::count<ServiceTypeOf<State>::value>(msg, lp);
+    Handler(s, bf, msg, lp);
+  }
+};
+
+/// \brief Instruments a finish handler.
+template <typename State, void (*Handler)(State *, tw_lp *)>
+struct Finish<Handler> {
+  static void handle(State *s, tw_lp *lp) {
+    Handler(s, lp);
+    ispd::lp_profile::record(lp);
+  }
+};
+
+}; // namespace ispd::profiling
+
+#endif // ISPD_PROFILING_HANDLERS_HPP
@@ -0,0 +1,141 @@
+/// \file profile.hpp
+///
+/// \brief This file defines the per-LP event profile, which counts how many
+/// events each logical process (LP) has processed and rolled back.
+///
+/// A profile dumped by a run can be loaded by a later run and used as the
+/// vertex weights of the service graph. Therefore, the partitioner balances
+/// the actual load of each processing element (PE), including the hot spots
+/// created by the workload and the scheduler, instead of an estimate of it.
+///
+#ifndef ISPD_PROFILING_PROFILE_HPP
+#define ISPD_PROFILING_PROFILE_HPP
+
+#include <ross.h>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <algorithm>
+#include <ispd/report/json.hpp>
+
+namespace ispd::profiling {
+
+/// \struct LpCounters
+///
+/// \brief The event counters of a logical process.
+struct LpCounters final {
+  std::uint64_t m_Forward; ///< The amount of forward handled events.
+  std::uint64_t m_Reverse; ///< The amount of reverse handled events.
+  double m_MaxWait;        ///< The maximum committed queueing delay.
+};
+
+/// \struct ProfileRecord
+///
+/// \brief A logical process' record in the profile file.
+///
+/// Since every rolled back event has been forward handled before, the amount
+/// of committed events is the difference between forward and reverse handled
+/// events.
+struct ProfileRecord final {
+  std::uint64_t m_Gid;        ///< The logical process' global identifier.
+  std::uint64_t m_Committed;  ///< The amount of committed events.
+  std::uint64_t m_RolledBack; ///< The amount of rolled back events.
+};
+
+/// \struct ProfileHeader
+///
+/// \brief The header of a profile file, which is followed by `m_Count`
+///        records.
+struct ProfileHeader final {
+  char m_Magic[8];           ///< Always "ISPDPRF".
+  std::uint32_t m_Version;   ///< The file format version.
+  std::uint32_t m_Rank;      ///< The rank that has written the file.
+  std::uint32_t m_RankCount; ///< The amount of ranks that have written files.
+  std::uint32_t m_Reserved;  ///< Always zero.
+  std::uint64_t m_Count;     ///< The amount of records.
+};
+
+/// \brief The metrics by which the hottest logical processes are ranked.
+enum class HotLpMetric { FORWARD, REVERSE, COMMITTED, MAX_WAIT };
+
+/// \brief The amount of metrics by which the logical processes are ranked.
+inline constexpr std::size_t g_HotLpMetrics = 4;
+
+/// \struct HotLp
+///
+/// \brief A logical process ranked by one of its metrics.
+struct HotLp final {
+  double m_Value;      ///< The metric's value.
+  std::uint64_t m_Gid; ///< The logical process' global identifier.
+};
+
+}; // namespace ispd::profiling
+
+namespace ispd::lp_profile {
+
+/// \brief The counters of each local logical process, indexed by the logical
+///        process' local identifier.
+///
+/// \note It is exposed so that the counting can be inlined in the handlers.
+extern ispd::profiling::LpCounters *g_Counters;
+
+/// \brief Allocates the counters of the local logical processes.
+///
+/// \param localCount The amount of local logical processes.
+/// \param dumpPrefix The prefix of the profile file to be dumped, or an empty
+///                   string if no profile should be dumped.
+/// \param hotLps The amount of hottest logical processes to be reported by
+///               each metric, or 0 if none should be reported.
+///
+/// \note This function must be called after `tw_define_lps`.
+void init(const tw_lpid localCount, const std::string &dumpPrefix,
+          const unsigned hotLps);
+
+/// \brief Counts a forward handled event at the specified logical process.
+inline void countForward(const tw_lp *lp) { g_Counters[lp->id].m_Forward++; }
+
+/// \brief Counts a reverse handled event at the specified logical process.
+inline void countReverse(const tw_lp *lp) { g_Counters[lp->id].m_Reverse++; }
+
+/// \brief Observes the queueing delay of a committed event at the specified
+///        logical process.
+inline void observeWait(const tw_lp *lp, const double wait) {
+  auto &counters = g_Counters[lp->id];
+  counters.m_MaxWait = std::max(counters.m_MaxWait, wait);
+}
+
+/// \brief Records the specified logical process' counters to be dumped.
+///
+/// This function is called by the logical processes' finish handlers and does
+/// nothing if no profile should be dumped.
+void record(const tw_lp *lp);
+
+/// \brief Dumps the recorded counters to the `<prefix>.<rank>.bin` file,
+///        reports the load imbalance among the processing elements and
+///        gathers the hottest logical processes of each metric.
+///
+/// \note This function is collective and must be called after `tw_run`.
+void finish();
+
+/// \brief Writes the hottest logical processes of each metric to the run
+///        report.
+///
+/// \note This function must only be called at the master node.
+void writeHotLps(ispd::report::JsonWriter &json);
+
+/// \brief Loads the profile dumped by a previous run, whose files are
+///        `<prefix>.0.bin`, `<prefix>.1.bin` and so on.
+///
+/// The previous run may have used a different amount of ranks, which is kept
+/// in every file's header. Exactly that amount of files is loaded, and the
+/// program is aborted if some file is missing or belongs to another run.
+///
+/// \param prefix The profile files' prefix.
+///
+/// \return The records of all logical processes in the profile.
+[[nodiscard]] std::vector<ispd::profiling::ProfileRecord>
+load(const std::string &prefix);
+
+}; // namespace ispd::lp_profile
+
+#endif // ISPD_PROFILING_PROFILE_HPP
@@ -0,0 +1,140 @@
+/// \file trace.hpp
+///
+/// \brief This file defines the engine trace, which records a timeline of
+/// each processing element (PE) in the Chrome trace format, which can be
+/// viewed locally by Perfetto's UI or by `chrome://tracing`.
+///
+/// The trace is only compiled in the tracing build, in which ISPD_TRACE is
+/// defined, so that the other builds pay nothing for it. In the tracing build,
+/// it is recorded if `--trace` is specified and it has the following spans:
+///
+/// - Forward batches: consecutive forward handler calls of the same service
+///   type, with the amount of handled events.
+/// - Rollbacks: consecutive reverse handler calls of the same service type,
+///   with the amount of rolled back events.
+/// - GVT rounds: the time spent outside the handlers by a PE whose global
+///   virtual time (GVT) has been computed meanwhile.
+/// - MPI waits: the blocking MPI calls made by ROSS or by the model, which
+///   are intercepted through MPI's profiling interface.
+///
+/// The spans are recorded into a preallocated per-rank buffer. Once the
+/// buffer is full, the remaining spans are dropped and counted.
+///
+#ifndef ISPD_PROFILING_TRACE_HPP
+#define ISPD_PROFILING_TRACE_HPP
+
+#ifdef ISPD_TRACE
+#include <ross.h>
+#include <chrono>
+#include <string>
+#include <cstdint>
+#include <ispd/services/services.hpp>
+#include <ispd/profiling/handler_profile.hpp>
+
+namespace ispd::profiling {
+
+/// \brief The lanes in which the spans are placed, which are shown as threads
+///        of each PE's process.
+enum class TraceLane : std::uint8_t { HANDLERS, ENGINE, MPI };
+
+/// \struct TraceSpan
+///
+/// \brief A recorded span.
+struct TraceSpan final {
+  const char *m_Name;   ///< The span's name, which must be a literal.
+  TraceLane m_Lane;     ///< The span's lane.
+  std::uint64_t m_Start; ///< The span's start (in nanoseconds).
+  std::uint64_t m_End;   ///< The span's end (in nanoseconds).
+  std::uint64_t m_Count; ///< The span's amount of events, if any.
+};
+
+/// \struct HandlerBatch
+///
+/// \brief The batch of consecutive handler calls being recorded.
+struct HandlerBatch final {
+  ispd::services::ServiceType m_Type; ///< The handlers' service type.
+  HandlerKind m_Kind;                 ///< The handlers' kind.
+  std::uint64_t m_Start;              ///< The first call's start.
+  std::uint64_t m_End;                ///< The last call's end.
+  std::uint64_t m_Count;              ///< The amount of calls, or 0 if none.
+};
+
+}; // namespace ispd::profiling
+
+namespace ispd::trace {
+
+/// \brief Whether the trace is being recorded.
+///
+/// \note It is exposed so that the recording can be inlined in the handler
+///       wrappers, as is the batch below.
+extern bool g_Enabled;
+
+/// \brief The batch of consecutive handler calls being recorded.
+extern ispd::profiling::HandlerBatch g_Batch;
+
+/// \brief The longest gap (in nanoseconds) between two handler calls of the
+///        same batch.
+extern std::uint64_t g_MaxGap;
+
+/// \brief The amount of GVT computations when the current batch has begun.
+extern unsigned long long g_GvtDone;
+
+/// \brief Starts recording the trace, if requested.
+///
+/// \param filepath The trace's file path, or an empty string if no trace
+///                 should be recorded.
+/// \param capacity The maximum amount of spans recorded by each rank.
+/// \param maxGap The longest gap (in microseconds) between two handler calls
+///               of the same batch.
+///
+/// \note This function is collective, since the ranks' clocks are aligned by
+///       a barrier.
+void init(const std::string &filepath, const unsigned capacity,
+          const double maxGap);
+
+/// \brief Returns the time (in nanoseconds) since the trace has been started.
+[[nodiscard]] std::uint64_t now() noexcept;
+
+/// \brief Records a span.
+void record(const char *name, const ispd::profiling::TraceLane lane,
+            const std::uint64_t start, const std::uint64_t end,
+            const std::uint64_t count = 0) noexcept;
+
+/// \brief Records the current batch and begins a new one.
+void flushBatch(const ispd::profiling::HandlerBatch &next) noexcept;
+
+/// \brief Calls and records a handler.
+template <ispd::services::ServiceType Type, ispd::profiling::HandlerKind Kind,
+          typename Call>
+inline void measure(Call &&call) {
+  if (!g_Enabled) {
+    call();
+    return;
+  }
+
+  const std::uint64_t start = now();
+  call();
+  const std::uint64_t end = now();
+
+  /// The call extends the current batch if it is a call of the same handler
+  /// that closely follows the batch, with no GVT computed in between.
+  /// Otherwise, the batch is recorded.
+  if (g_Batch.m_Count > 0 && g_Batch.m_Type == Type && g_Batch.m_Kind == Kind &&
+      start - g_Batch.m_End <= g_MaxGap && g_tw_gvt_done == g_GvtDone) {
+    g_Batch.m_End = end;
+    g_Batch.m_Count++;
+  } else {
+    flushBatch(ispd::profiling::HandlerBatch{Type, Kind, start, end, 1});
+  }
+}
+
+/// \brief Writes the trace of every rank into a single Chrome trace file.
+///
+/// \note This function is collective and must be called after `tw_run` and
+///       before `tw_end`.
+void finish();
+
+}; // namespace ispd::trace
+#endif // ISPD_TRACE
+
+#endif // ISPD_PROFILING_TRACE_HPP
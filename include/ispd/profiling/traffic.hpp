@@ -0,0 +1,120 @@
+/// \file traffic.hpp
+///
+/// \brief This file defines the traffic profile, which counts the committed
+/// events sent between the processing elements (PEs).
+///
+/// Each committed event is counted by its receiver, when it is committed, by
+/// the sender's PE and by the sender's and the receiver's service types.
+/// Since an event is only committed if the event that has sent it has been
+/// committed, these are exactly the committed sends. At the end, the counts
+/// are gathered into a sparse PE-by-PE traffic matrix and into the ratio of
+/// remote events sent by each service type, so that the partitioners can be
+/// evaluated by the traffic they actually cut.
+///
+/// The traffic profile is enabled by `--traffic`. Otherwise, it costs a single
+/// branch per committed event.
+///
+#ifndef ISPD_PROFILING_TRAFFIC_HPP
+#define ISPD_PROFILING_TRAFFIC_HPP
+
+#include <ross.h>
+#include <cstdint>
+#include <ispd/report/json.hpp>
+#include <ispd/model/builder.hpp>
+#include <ispd/mapping/mapping.hpp>
+#include <ispd/message/message.hpp>
+#include <ispd/services/services.hpp>
+
+namespace ispd::profiling {
+
+/// \brief The amount of service types whose traffic is counted.
+inline constexpr std::size_t g_TrafficServiceTypes =
+    ispd::services::g_ServiceTypes.size();
+
+/// \struct TypeTraffic
+///
+/// \brief The committed events sent from a service type to another.
+struct TypeTraffic final {
+  std::uint64_t m_Local;  ///< The events sent within a PE.
+  std::uint64_t m_Remote; ///< The events sent to another PE.
+};
+
+/// \struct TrafficEntry
+///
+/// \brief A non-zero entry of the PE-by-PE traffic matrix.
+struct TrafficEntry final {
+  std::uint64_t m_From;   ///< The sender's PE.
+  std::uint64_t m_To;     ///< The receiver's PE.
+  std::uint64_t m_Events; ///< The amount of committed events.
+};
+
+}; // namespace ispd::profiling
+
+namespace ispd::traffic {
+
+/// \brief Whether the traffic profile is enabled.
+///
+/// \note It is exposed so that the counting can be inlined in the handler
+///       wrappers, as are the counters below.
+extern bool g_Enabled;
+
+/// \brief The committed events received by this PE, indexed by the sender's
+///        PE.
+extern std::uint64_t *g_FromPe;
+
+/// \brief The committed events received by this PE, indexed by the sender's
+///        and by the receiver's service types.
+extern ispd::profiling::TypeTraffic
+    g_ByType[ispd::profiling::g_TrafficServiceTypes]
+            [ispd::profiling::g_TrafficServiceTypes];
+
+/// \brief Enables the traffic profile, if requested.
+///
+/// \param enabled Whether the traffic profile is enabled.
+///
+/// \note This function must be called after the LP-to-PE mapping has been
+///       installed.
+void init(const bool enabled);
+
+/// \brief Counts a committed event received by a logical process of the
+///        specified service type.
+template <ispd::services::ServiceType Type>
+inline void count(const ispd_message *msg, const tw_lp *lp) {
+  if (!g_Enabled)
+    return;
+
+  /// Every message carries the service that has sent it.
+  const tw_lpid sender = msg->previous_service_id;
+  const tw_peid senderPe = ispd::lp_mapping::getPe(sender);
+  const auto senderType =
+      static_cast<std::size_t>(ispd::this_model::getServiceType(sender));
+  auto &traffic = g_ByType[senderType][static_cast<std::size_t>(Type)];
+
+  g_FromPe[senderPe]++;
+
+  if (senderPe == g_tw_mynode)
+    traffic.m_Local++;
+  else
+    traffic.m_Remote++;
+}
+
+/// \brief Gathers the traffic matrix and reduces the service types' traffic
+///        to the master node.
+///
+/// \note This function is collective and must be called after `tw_run` and
+///       before `tw_end`.
+void reduce();
+
+/// \brief Reports the remote event ratio of each service type and the
+///        heaviest entries of the traffic matrix.
+void report();
+
+/// \brief Writes the traffic matrix and the service types' traffic to the run
+///        report.
+///
+/// \note This function must only be called at the master node.
+void write(ispd::report::JsonWriter &json);
+
+}; // namespace ispd::traffic
+
+#endif // ISPD_PROFILING_TRAFFIC_HPP
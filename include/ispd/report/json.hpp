@@ -0,0 +1,85 @@
+/// \file json.hpp
+///
+/// \brief This file defines a minimal streaming JSON writer, which is used to
+/// write the machine-readable run report.
+///
+/// The writer keeps track of the nesting and of the separators, so that the
+/// report's sections only have to state their keys and values.
+///
+#ifndef ISPD_REPORT_JSON_HPP
+#define ISPD_REPORT_JSON_HPP
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <string_view>
+
+namespace ispd::report {
+
+/// \class JsonWriter
+///
+/// \brief Writes an indented JSON document to a file.
+///
+/// The members of an object are written with the keyed overloads, while the
+/// elements of an array are written with the unkeyed ones.
+class JsonWriter final {
+public:
+  /// \brief Constructs the writer on an opened file, which is not closed by
+  ///        the writer.
+  explicit JsonWriter(std::FILE *file) noexcept : m_File(file) {}
+
+  void beginObject();
+  void beginObject(std::string_view key);
+  void endObject();
+
+  void beginArray();
+  void beginArray(std::string_view key);
+  void endArray();
+
+  void value(double value);
+  void value(std::uint64_t value);
+  void value(std::string_view value);
+  void value(bool value);
+
+  /// \brief Writes a member of the current object.
+  template <typename T> void field(std::string_view key, const T &value) {
+    writeKey(key);
+    this->value(value);
+  }
+
+  void field(std::string_view key, unsigned value) {
+    field(key, static_cast<std::uint64_t>(value));
+  }
+
+  void field(std::string_view key, const char *value) {
+    field(key, std::string_view(value));
+  }
+
+  void field(std::string_view key, const std::string &value) {
+    field(key, std::string_view(value));
+  }
+
+private:
+  /// \brief Writes the separator and the indentation of a new element.
+  void writeSeparator();
+
+  /// \brief Writes the key of a new member.
+  void writeKey(std::string_view key);
+
+  /// \brief Writes an escaped string.
+  void writeString(std::string_view value);
+
+  std::FILE *m_File;
+
+  /// \brief Whether each opened scope already has an element. The document's
+  ///        root is the bottom of the stack.
+  std::vector<bool> m_HasElements = {false};
+
+  /// \brief Whether the next element has its key already written.
+  bool m_AfterKey = false;
+};
+
+}; // namespace ispd::report
+
+#endif // ISPD_REPORT_JSON_HPP
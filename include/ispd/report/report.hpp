@@ -0,0 +1,96 @@
+/// \file report.hpp
+///
+/// \brief This file defines the run report, a machine-readable JSON document
+/// written by the master node at the end of the simulation.
+///
+/// The report gathers the run configuration, the wall-clock time of each
+/// phase, the peak memory usage, ROSS' engine statistics and the global and
+/// user metrics, so that the performance of different runs can be compared
+/// without scraping the text output.
+///
+/// Other modules may append their own sections to the report.
+///
+#ifndef ISPD_REPORT_REPORT_HPP
+#define ISPD_REPORT_REPORT_HPP
+
+#include <ross.h>
+#include <string>
+#include <cstdint>
+#include <functional>
+#include <ispd/report/json.hpp>
+
+namespace ispd::report {
+
+/// \struct EngineStatistics
+///
+/// \brief ROSS' engine statistics, reduced among the nodes.
+struct EngineStatistics final {
+  std::uint64_t m_ProcessedEvents;    ///< The forward handled events.
+  std::uint64_t m_NetEvents;          ///< The committed events.
+  std::uint64_t m_RolledBackEvents;   ///< The rolled back events.
+  std::uint64_t m_PrimaryRollbacks;   ///< The rollbacks caused by stragglers.
+  std::uint64_t m_SecondaryRollbacks; ///< The rollbacks caused by anti-messages.
+  std::uint64_t m_RemoteEvents;       ///< The events sent to other nodes.
+  std::uint64_t m_GvtComputations;    ///< The GVT computations.
+};
+
+/// \brief A section appended to the report by another module.
+///
+/// The section writes the members of its own object, which is keyed in the
+/// report's root object. It is only invoked at the master node.
+using ReportSection = std::function<void(JsonWriter &)>;
+
+}; // namespace ispd::report
+
+namespace ispd::run_report {
+
+/// \brief Records a run configuration entry.
+void setConfiguration(const std::string &key, const std::string &value);
+void setConfiguration(const std::string &key, const double value);
+void setConfiguration(const std::string &key, const std::uint64_t value);
+
+/// \brief Ends the current phase, if any, and begins a new one.
+///
+/// Both the wall-clock time and the growth of the peak resident set size
+/// (RSS) are measured for each phase.
+///
+/// \param name The phase's name.
+///
+/// \note Every node must begin the same phases in the same order.
+void beginPhase(const std::string &name);
+
+/// \brief Ends the current phase.
+void endPhase();
+
+/// \brief Appends a section to the report.
+///
+/// \param key The section's key in the report's root object.
+/// \param section The function that writes the section.
+void addSection(const std::string &key, ispd::report::ReportSection section);
+
+/// \brief Reduces the engine statistics, the phases' times and the peak memory
+///        usage of every node to the master node.
+///
+/// \note This function is collective and must be called after `tw_run` and
+///       before `tw_end`.
+void collect();
+
+/// \brief Reports the minimum, maximum and mean wall-clock time of each phase
+///        among the nodes, and its largest peak RSS growth, at the master
+///        node.
+///
+/// \note This function must be called after `collect`.
+void report();
+
+/// \brief Writes the report to the specified file at the master node.
+///
+/// \param filepath The report's file path, or an empty string if no report
+///                 should be written.
+///
+/// \note This function must be called after the global metrics have been
+///       reduced.
+void write(const std::string &filepath);
+
+}; // namespace ispd::run_report
+
+#endif // ISPD_REPORT_REPORT_HPP
@@ -0,0 +1,14 @@
+#ifndef ISPD_REVERSE_HPP
+#define ISPD_REVERSE_HPP
+
+/// The sequential-only build (see the `ISPD_SEQUENTIAL_ONLY` CMake option)
+/// never rolls back an event. Therefore, the code that only exists to support
+/// the reverse computation, such as the saved state writes and the bitfield
+/// bookkeeping, is wrapped by this macro so that it can be compiled out.
+#ifdef ISPD_SEQUENTIAL_ONLY
+# define REVERSE_COMPUTATION(CODE)
+#else
+# define REVERSE_COMPUTATION(CODE) CODE
+#endif // ISPD_SEQUENTIAL_ONLY
+
+#endif // ISPD_REVERSE_HPP
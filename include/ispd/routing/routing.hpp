@@ -265,6 +265,20 @@ public:
   ///       the corresponding source vertex.
   auto load(const std::string &filepath) -> void;
 
+  /// \brief Registers a route between the specified source and destination
+  ///        vertices.
+  ///
+  /// This function allows the routes to be built programmatically (e.g., by
+  /// a topology generator) instead of being loaded from a file.
+  ///
+  /// \param src The source vertex (`tw_lpid`) of the route.
+  /// \param dest The destination vertex (`tw_lpid`) of the route.
+  /// \param path The route's elements, following the same convention of the
+  ///             routing file: every service along the route in order,
+  ///             excluding the source and including the destination.
+  auto registerRoute(const tw_lpid src, const tw_lpid dest,
+                     const std::vector<tw_lpid> &path) -> void;
+
   /// \brief Retrieves the route between the specified source and destination
   ///        vertices from the routing table.
   ///
@@ -338,6 +352,16 @@ namespace ispd::routing_table {
 ///       the corresponding source vertex.
 auto load(const std::string &filepath) -> void;
 
+/// \brief Registers a route between the specified source and destination
+///        vertices at the global routing table.
+///
+/// \param src The source vertex (`tw_lpid`) of the route.
+/// \param dest The destination vertex (`tw_lpid`) of the route.
+/// \param path The route's elements, excluding the source and including the
+///             destination.
+auto registerRoute(const tw_lpid src, const tw_lpid dest,
+                   const std::vector<tw_lpid> &path) -> void;
+
 /// \brief Retrieves the route between the specified source and destination
 ///        vertices from the routing table.
 ///
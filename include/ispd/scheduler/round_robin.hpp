@@ -11,6 +11,7 @@
 #pragma once
 
 #include <cstdint>
+#include <ispd/reverse/reverse.hpp>
 #include <ispd/scheduler/scheduler.hpp>
 
 namespace ispd::scheduler {
@@ -36,7 +37,7 @@ public:
 
   [[nodiscard]] tw_lpid forwardSchedule(std::vector<tw_lpid> &slaves, tw_bf *bf,
                                         ispd_message *msg, tw_lp *lp) override {
-    bf->c0 = 0;
+    REVERSE_COMPUTATION(bf->c0 = 0;)
 
     /// Select the next slave.
     const tw_lpid slave_id = slaves[m_NextSlaveIndex];
@@ -52,7 +53,7 @@ public:
       /// has overflown and, therefore, has set back to 0.
       ///
       /// This is necessary for the reverse computation.
-      bf->c0 = 1;
+      REVERSE_COMPUTATION(bf->c0 = 1;)
 
       /// Set the next slave identifier back to 0.
       m_NextSlaveIndex = 0;
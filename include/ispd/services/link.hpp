@@ -2,11 +2,16 @@
 #define ISPD_SERVICE_LINK_HPP
 
 #include <ross.h>
-#include <chrono>
 #include <ispd/debug/debug.hpp>
 #include <ispd/model/builder.hpp>
 #include <ispd/message/message.hpp>
+#include <ispd/reverse/reverse.hpp>
 #include <ispd/metrics/metrics.hpp>
+#include <ispd/metrics/lp_metrics.hpp>
+#include <ispd/metrics/time_series.hpp>
+#include <ispd/instrumentation/model_stats.hpp>
+#include <ispd/profiling/profile.hpp>
+#include <ispd/profiling/handler_profile.hpp>
 #include <ispd/configuration/link.hpp>
 
 extern double g_NodeSimulationTime;
@@ -64,6 +69,9 @@ struct link {
 
     /// Call the service initializer for this logical process.
     service_initializer(s);
+
+    /// Register the link's directions in the time series.
+    ispd::time_series::addLink();
     
     /// Initialize link's metrics.
     s->metrics.upward_comm_time = 0;
@@ -86,10 +94,6 @@ struct link {
   static void forward(link_state *s, tw_bf *bf, ispd_message *msg, tw_lp *lp) {
     ispd_debug("[Forward] Link %lu received a message at %lf of type (%d).", lp->gid, tw_now(lp), msg->type);
 
-#ifdef DEBUG_ON
-  const auto start = std::chrono::high_resolution_clock::now();
-#endif // DEBUG_ON
-
     /// Fetch the communication size and calculates the communication time.
     const double comm_size = msg->task.m_CommSize;
     const double comm_time = s->conf.timeToCommunicate(comm_size);
@@ -100,33 +104,19 @@ struct link {
     /// is used, otherwise, if the slave is sent the results to the master,
     /// then the upward link is being used.
     double next_available_time;
-    double saved_next_available_time;
 
     if (msg->downward_direction)
       next_available_time = s->downward_next_available_time;
     else
       next_available_time = s->upward_next_available_time;
-    saved_next_available_time = next_available_time;
+
+    /// Save information (for reverse computation).
+    REVERSE_COMPUTATION(msg->saved_link_next_available_time = next_available_time;)
 
     /// Calculate the waiting delay and the departure delay.
     const double waiting_delay = ROSS_MAX(0.0, next_available_time - tw_now(lp));
     const double departure_delay = waiting_delay + comm_time;
 
-    /// Update the downward link's metrics.
-    if (msg->downward_direction) {
-      s->metrics.downward_comm_time += comm_time;
-      s->metrics.downward_comm_mbits += comm_size;
-      s->metrics.downward_comm_packets++;
-      s->metrics.downward_waiting_time += waiting_delay;
-    }
-    /// Update the upward link's metrics.
-    else {
-      s->metrics.upward_comm_time += comm_time;
-      s->metrics.upward_comm_mbits += comm_size;
-      s->metrics.upward_comm_packets++;
-      s->metrics.upward_waiting_time += waiting_delay;
-    }
-
     next_available_time = tw_now(lp) + departure_delay;
 
     tw_lpid send_to;
@@ -156,68 +146,79 @@ struct link {
 
     m->type = message_type::ARRIVAL;
     m->task = msg->task; /// Copy the task's information.
+    m->latency = msg->latency;
+    m->latency.m_LinkWait += waiting_delay;
+    m->latency.m_LinkTransfer += comm_time;
     m->downward_direction = msg->downward_direction;
     m->route_offset = msg->route_offset;
     m->previous_service_id = lp->gid;
 
-    /// Save information (for reverse computation).
-    msg->saved_link_next_available_time = saved_next_available_time;
+    /// Save information (for the commit handler).
     msg->saved_waiting_time = waiting_delay;
+    msg->saved_arrival_time = tw_now(lp);
 
     tw_event_send(e);
-
-#ifdef DEBUG_ON
-  const auto end = std::chrono::high_resolution_clock::now();
-  const auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
-  const auto timeTaken = static_cast<double>(duration.count());
-
-  ispd::node_metrics::notifyMetric(ispd::metrics::NodeMetricsFlag::NODE_LINK_FORWARD_TIME, timeTaken);
-#endif // DEBUG_ON
   }
 
+#ifndef ISPD_SEQUENTIAL_ONLY
   static void reverse(link_state *s, tw_bf *bf, ispd_message *msg, tw_lp *lp) {
     ispd_debug("[Reverse] Link %lu received a message at %lf of type (%d).", lp->gid, tw_now(lp), msg->type);
 
-#ifdef DEBUG_ON
-  const auto start = std::chrono::high_resolution_clock::now();
-#endif // DEBUG_ON
+    const double next_available_time = msg->saved_link_next_available_time;
 
+    /// Checks if the message is being sent from the master to the slave. Therefore,
+    /// the downward next available time should be reverse processed. Otherwise, the
+    /// message is being sent from the slave to the master and, therefore, the upward
+    /// next available time should be reverse processed.
+    ///
+    /// @Note: The link's metrics are only updated when the event is committed and,
+    ///        therefore, there is nothing else to be reversed.
+    if (msg->downward_direction)
+      s->downward_next_available_time = next_available_time;
+    else
+      s->upward_next_available_time = next_available_time;
+  }
+#endif // ISPD_SEQUENTIAL_ONLY
+
+  static void commit(link_state *s, tw_bf *bf, ispd_message *msg, tw_lp *lp) {
     /// Fetch the communication size and calculates the communication time.
     const double comm_size = msg->task.m_CommSize;
     const double comm_time = s->conf.timeToCommunicate(comm_size);
-    const double next_available_time = msg->saved_link_next_available_time;
     const double waiting_delay = msg->saved_waiting_time;
 
-    /// Checks if the message is being sent from the master to the slave. Therefore,
-    /// the downward next available time should be reverse processed.
+    /// Update the downward link's metrics.
     if (msg->downward_direction) {
-      s->downward_next_available_time = next_available_time;
-
-      /// Reverse the downward link's metrics.
-      s->metrics.downward_comm_time -= comm_time;
-      s->metrics.downward_comm_mbits -= comm_size;
-      s->metrics.downward_comm_packets--;
-      s->metrics.downward_waiting_time -= waiting_delay;
+      s->metrics.downward_comm_time += comm_time;
+      s->metrics.downward_comm_mbits += comm_size;
+      s->metrics.downward_comm_packets++;
+      s->metrics.downward_waiting_time += waiting_delay;
     }
-    /// Otherwise, if the message is being sent from the slae to the master. Therefore
-    /// the upward next available time should be reverse processed.
+    /// Update the upward link's metrics.
     else {
-      s->upward_next_available_time = next_available_time;
-
-      /// Reverse the upward link's metrics.
-      s->metrics.upward_comm_time -= comm_time;
-      s->metrics.upward_comm_mbits -= comm_size;
-      s->metrics.upward_comm_packets--;
-      s->metrics.upward_waiting_time -= waiting_delay;
+      s->metrics.upward_comm_time += comm_time;
+      s->metrics.upward_comm_mbits += comm_size;
+      s->metrics.upward_comm_packets++;
+      s->metrics.upward_waiting_time += waiting_delay;
     }
 
-#ifdef DEBUG_ON
-  const auto end = std::chrono::high_resolution_clock::now();
-  const auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
-  const auto timeTaken = static_cast<double>(duration.count());
+    ispd::lp_profile::observeWait(lp, waiting_delay);
+
+    /// Update the user's link waiting time distribution.
+    ispd::this_model::getUserById(msg->task.m_Owner).getHistograms().m_LinkWaiting.record(waiting_delay);
 
-  ispd::node_metrics::notifyMetric(ispd::metrics::NodeMetricsFlag::NODE_LINK_REVERSE_TIME, timeTaken);
-#endif // DEBUG_ON
+    /// Update the time series' window in which the packet has arrived.
+    ispd::time_series::communicatePacket(msg->saved_arrival_time, comm_time, waiting_delay);
+  }
+
+  static void stats(link_state *s, tw_lp *lp, ispd::instrumentation::ModelStats *stats) {
+    const double now = tw_now(lp);
+
+    stats->m_Type = static_cast<std::uint32_t>(ServiceType::LINK);
+    stats->m_QueueDepth = (s->upward_next_available_time > now) + (s->downward_next_available_time > now);
+    stats->m_NextFreeTime = ROSS_MAX(s->upward_next_available_time, s->downward_next_available_time);
+    stats->m_Packets = s->metrics.upward_comm_packets + s->metrics.downward_comm_packets;
+    stats->m_Utilization = ispd::instrumentation::utilization(
+        s->metrics.upward_comm_time + s->metrics.downward_comm_time, 2, now);
   }
 
   static void finish(link_state *s, tw_lp *lp) {
@@ -235,41 +236,34 @@ struct link {
 
     /// Report to the node`s metrics collector the last activity time
     /// of the machine in the simulation.
-    ispd::node_metrics::notifyMetric(ispd::metrics::NodeMetricsFlag::NODE_SIMULATION_TIME, lastActivityTime);
-    ispd::node_metrics::notifyMetric(ispd::metrics::NodeMetricsFlag::NODE_TOTAL_COMMUNICATED_MBITS, linkTotalCommunicatedMBits);
-    ispd::node_metrics::notifyMetric(ispd::metrics::NodeMetricsFlag::NODE_TOTAL_COMMUNICATION_WAITING_TIME, linkTotalCommunicationWaitingTime);
-    ispd::node_metrics::notifyMetric(ispd::metrics::NodeMetricsFlag::NODE_TOTAL_LINK_SERVICES);
-    ispd::node_metrics::notifyMetric(ispd::metrics::NodeMetricsFlag::NODE_TOTAL_COMMUNICATION_TIME, linkTotalCommunicationTime);
-
-    std::printf(
-        "Link Queue Info & Metrics (%lu)\n"
-        " - Downward Communicated Mbits..: %lf Mbits (%lu).\n"
-        " - Downward Communicated Packets: %u packets (%lu).\n"
-        " - Downward Waiting Time........: %lf seconds (%lu).\n"
-        " - Downward Idleness............: %lf% (%lu).\n"
-        " - Downward Next Avail. Time....: %lf seconds (%lu).\n"
-        " - Upward Communicated Mbits....: %lf Mbits (%lu).\n"
-        " - Upward Communicated Packets..: %u packets (%lu).\n"
-        " - Upward Waiting Time..........: %lf seconds (%lu).\n"
-        " - Upward Idleness..............: %lf% (%lu).\n"
-        " - Upward Next Avail. Time......: %lf seconds (%lu).\n"
-        "\n",
-        lp->gid, 
-        s->metrics.downward_comm_mbits, lp->gid,
-        s->metrics.downward_comm_packets, lp->gid,
-        s->metrics.downward_waiting_time, lp->gid,
-        downwardIdleness * 100.0, lp->gid,
-        s->downward_next_available_time, lp->gid,
-        s->metrics.upward_comm_mbits, lp->gid,
-        s->metrics.upward_comm_packets, lp->gid,
-        s->metrics.upward_waiting_time, lp->gid,
-        upwardIdleness * 100.0, lp->gid,
-        s->upward_next_available_time, lp->gid
-    );
+    ispd::node_metrics::notifyMetric<ispd::metrics::NodeMetricsFlag::NODE_SIMULATION_TIME>(lastActivityTime);
+    ispd::node_metrics::notifyMetric<ispd::metrics::NodeMetricsFlag::NODE_TOTAL_COMMUNICATED_MBITS>(linkTotalCommunicatedMBits);
+    ispd::node_metrics::notifyMetric<ispd::metrics::NodeMetricsFlag::NODE_TOTAL_COMMUNICATION_WAITING_TIME>(linkTotalCommunicationWaitingTime);
+    ispd::node_metrics::notifyMetric<ispd::metrics::NodeMetricsFlag::NODE_TOTAL_LINK_SERVICES>();
+    ispd::node_metrics::notifyMetric<ispd::metrics::NodeMetricsFlag::NODE_TOTAL_COMMUNICATION_TIME>(linkTotalCommunicationTime);
+
+    /// Record this link's metrics.
+    ispd::lp_metrics::record(lp->gid, ServiceType::LINK, {
+        s->metrics.downward_comm_mbits,
+        static_cast<double>(s->metrics.downward_comm_packets),
+        s->metrics.downward_waiting_time,
+        downwardIdleness,
+        s->downward_next_available_time,
+        s->metrics.upward_comm_mbits,
+        static_cast<double>(s->metrics.upward_comm_packets),
+        s->metrics.upward_waiting_time,
+        upwardIdleness,
+        s->upward_next_available_time,
+    });
   }
 };
 
 }; // namespace services
 }; // namespace ispd
 
+/// \brief The link's service type, which is resolved by the handler wrappers.
+template <> struct ispd::profiling::ServiceTypeOf<ispd::services::link_state> {
+  static constexpr auto value = ispd::services::ServiceType::LINK;
+};
+
 #endif // ISPD_SERVICE_LINK_HPP
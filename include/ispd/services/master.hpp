@@ -4,11 +4,14 @@
 #include <ross.h>
 #include <vector>
 #include <memory>
-#include <chrono>
 #include <ispd/debug/debug.hpp>
 #include <ispd/model/builder.hpp>
 #include <ispd/routing/routing.hpp>
 #include <ispd/metrics/metrics.hpp>
+#include <ispd/metrics/lp_metrics.hpp>
+#include <ispd/metrics/time_series.hpp>
+#include <ispd/instrumentation/model_stats.hpp>
+#include <ispd/profiling/handler_profile.hpp>
 #include <ispd/workload/workload.hpp>
 #include <ispd/scheduler/scheduler.hpp>
 #include <ispd/scheduler/round_robin.hpp>
@@ -17,6 +20,9 @@ namespace ispd {
 namespace services {
 
 struct master_metrics {
+  /// \brief Amount of tasks issued by the master.
+  unsigned issued_tasks;
+
   /// \brief Amount of cmpleted tasks scheduled by the master.
   unsigned completed_tasks;
   
@@ -58,6 +64,7 @@ struct master {
       ispd_error("There are %u registered routes starting from master with GID %lu but there are %lu slaves.", registered_routes_count, lp->gid, s->slaves.size());
 
     /// Initialize the metrics.
+    s->metrics.issued_tasks = 0;
     s->metrics.completed_tasks = 0;
     s->metrics.total_turnaround_time = 0;
 
@@ -75,6 +82,7 @@ struct master {
       ispd_message *const m = static_cast<ispd_message *>(tw_event_data(e));
 
       m->type = message_type::GENERATE;
+      m->previous_service_id = lp->gid;
 
       tw_event_send(e);
     }
@@ -101,6 +109,7 @@ struct master {
 
   }
 
+#ifndef ISPD_SEQUENTIAL_ONLY
   static void reverse(master_state *s, tw_bf *bf, ispd_message *msg, tw_lp *lp) {
     ispd_debug("[Reverse] Master %lu received a message at %lf of type (%d).", lp->gid, tw_now(lp), msg->type);
 
@@ -117,42 +126,66 @@ struct master {
         break;
     }
   }
+#endif // ISPD_SEQUENTIAL_ONLY
 
   static void commit(master_state *s, tw_bf *bf, ispd_message *msg, tw_lp *lp) {
     if (msg->type == message_type::GENERATE) {
-      auto& userMetrics = ispd::this_model::getUserById(msg->task.m_Owner).getMetrics();
+      /// @Note: The generate message carries no task, therefore, the owner is
+      ///        fetched from the workload that has generated the task.
+      auto& userMetrics = ispd::this_model::getUserById(s->workload->getOwner()).getMetrics();
 
-      /// Update the user's metrics.
+      /// Update the user's and the master's metrics.
       userMetrics.m_IssuedTasks++;
+      s->metrics.issued_tasks++;
+    } else if (msg->type == message_type::ARRIVAL) {
+      /// Calculate the task`s turnaround time.
+      const double turnaround_time = msg->task.m_EndTime - msg->task.m_SubmitTime;
+
+      /// Update the master's metrics.
+      s->metrics.completed_tasks++;
+      s->metrics.total_turnaround_time += turnaround_time;
+
+      /// Update the user's turnaround time distribution and its breakdown.
+      auto& histograms = ispd::this_model::getUserById(msg->task.m_Owner).getHistograms();
+      histograms.m_Turnaround.record(turnaround_time);
+      histograms.m_LinkWait.record(msg->latency.m_LinkWait);
+      histograms.m_LinkTransfer.record(msg->latency.m_LinkTransfer);
+      histograms.m_SwitchTransit.record(msg->latency.m_SwitchTransit);
+      histograms.m_MachineWait.record(msg->latency.m_MachineWait);
+      histograms.m_MachineService.record(msg->latency.m_MachineService);
+
+      /// Update the time series' window in which the task has completed.
+      ispd::time_series::completeTask(msg->task.m_EndTime);
     }
   }
 
   static void finish(master_state *s, tw_lp *lp) {
-    ispd::node_metrics::notifyMetric(ispd::metrics::NodeMetricsFlag::NODE_TOTAL_COMPLETED_TASKS, s->metrics.completed_tasks);
-    ispd::node_metrics::notifyMetric(ispd::metrics::NodeMetricsFlag::NODE_TOTAL_MASTER_SERVICES);
-    ispd::node_metrics::notifyMetric(ispd::metrics::NodeMetricsFlag::NODE_TOTAL_TURNAROUND_TIME, s->metrics.total_turnaround_time);
+    ispd::node_metrics::notifyMetric<ispd::metrics::NodeMetricsFlag::NODE_TOTAL_COMPLETED_TASKS>(s->metrics.completed_tasks);
+    ispd::node_metrics::notifyMetric<ispd::metrics::NodeMetricsFlag::NODE_TOTAL_MASTER_SERVICES>();
+    ispd::node_metrics::notifyMetric<ispd::metrics::NodeMetricsFlag::NODE_TOTAL_TURNAROUND_TIME>(s->metrics.total_turnaround_time);
 
     const double avgTurnaroundTime = s->metrics.total_turnaround_time / s->metrics.completed_tasks;
 
-    std::printf(
-        "Master Metrics (%lu)\n"
-        " - Completed Tasks.....: %u tasks (%lu).\n"
-        " - Avg. Turnaround Time: %lf seconds (%lu).\n"
-        "\n",
-        lp->gid,
-        s->metrics.completed_tasks, lp->gid,
-        avgTurnaroundTime, lp->gid
-    );
+    /// Record this master's metrics.
+    ispd::lp_metrics::record(lp->gid, ServiceType::MASTER, {
+        static_cast<double>(s->metrics.completed_tasks),
+        avgTurnaroundTime,
+        static_cast<double>(s->metrics.issued_tasks),
+    });
+  }
+
+  static void stats(master_state *s, tw_lp *lp, ispd::instrumentation::ModelStats *stats) {
+    /// @Note: The master has no queueing model, therefore, its queue depth is
+    ///        the amount of issued tasks whose results have not arrived yet.
+    stats->m_Type = static_cast<std::uint32_t>(ServiceType::MASTER);
+    stats->m_QueueDepth = s->metrics.issued_tasks - s->metrics.completed_tasks;
+    stats->m_Packets = s->metrics.issued_tasks + s->metrics.completed_tasks;
   }
 
 private:
   static void generate(master_state *s, tw_bf *bf, ispd_message *msg, tw_lp *lp) {
     ispd_debug("Master %lu will generate a task at %lf, remaining %u.", lp->gid, tw_now(lp), s->workload->getRemainingTasks());
 
-#ifdef DEBUG_ON
-  const auto start = std::chrono::high_resolution_clock::now();
-#endif // DEBUG_ON
-
     /// Use the master's scheduling policy to the schedule the next slave.
     const tw_lpid scheduled_slave_id = s->scheduler->forwardSchedule(s->slaves, bf, msg, lp);
 
@@ -177,6 +210,7 @@ private:
     m->task.m_Dest = scheduled_slave_id;
     m->task.m_SubmitTime = tw_now(lp);
     m->task.m_Owner = s->workload->getOwner();
+    m->latency = ispd::customer::TaskLatency{};
 
     m->route_offset = 1;
     m->previous_service_id = lp->gid;
@@ -197,68 +231,49 @@ private:
       ispd_message *const m = static_cast<ispd_message *>(tw_event_data(e));
 
       m->type = message_type::GENERATE;
+      m->previous_service_id = lp->gid;
 
      tw_event_send(e);    
     }
-
-#ifdef DEBUG_ON
-  const auto end = std::chrono::high_resolution_clock::now();
-  const auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
-  const auto timeTaken = static_cast<double>(duration.count());
-
-  ispd::node_metrics::notifyMetric(ispd::metrics::NodeMetricsFlag::NODE_MASTER_FORWARD_TIME, timeTaken);
-#endif // DEBUG_ON
   }
 
+#ifndef ISPD_SEQUENTIAL_ONLY
   static void generate_rc(master_state *s, tw_bf *bf, ispd_message *msg, tw_lp *lp) {
-#ifdef DEBUG_ON
-  const auto start = std::chrono::high_resolution_clock::now();
-#endif // DEBUG_ON
-
-    /// Reverse the schedule.
-    s->scheduler->reverseSchedule(s->slaves, bf, msg, lp);
-
-    /// Reverse the workload generator.
-    s->workload->reverseGenerateWorkload(lp->rng);
-
-    /// Checks if after reversing the workload generator, there are remaining tasks to be generated.
-    /// If so, the random number generator is reversed since it is used to generate the interarrival
-    /// time of the tasks.
+    /// Checks if there are remaining tasks to be generated BEFORE reversing the workload generator,
+    /// as the forward handler did after generating the task. If so, the interarrival time has been
+    /// generated and, therefore, its random number generator calls are reversed first.
     if (s->workload->getRemainingTasks() > 0)
       s->workload->reverseGenerateInterarrival(lp->rng);
 
-#ifdef DEBUG_ON
-  const auto end = std::chrono::high_resolution_clock::now();
-  const auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
-  const auto timeTaken = static_cast<double>(duration.count());
+    /// Reverse the workload generator.
+    s->workload->reverseGenerateWorkload(lp->rng);
 
-  ispd::node_metrics::notifyMetric(ispd::metrics::NodeMetricsFlag::NODE_MASTER_REVERSE_TIME, timeTaken);
-#endif // DEBUG_ON
+    /// Reverse the schedule.
+    s->scheduler->reverseSchedule(s->slaves, bf, msg, lp);
   }
 
+#endif // ISPD_SEQUENTIAL_ONLY
+
   static void arrival(master_state *s, tw_bf *bf, ispd_message *msg, tw_lp *lp) {
-    /// Calculate the end time of the task.
+    /// Calculate the end time of the task. The master's metrics are updated
+    /// when the event is committed, based on the task's end time.
     msg->task.m_EndTime = tw_now(lp);
-
-    /// Calculate the task`s turnaround time.
-    const double turnaround_time = msg->task.m_EndTime - msg->task.m_SubmitTime;
-
-    /// Update the master's metrics.
-    s->metrics.completed_tasks++;
-    s->metrics.total_turnaround_time += turnaround_time;
   }
 
+#ifndef ISPD_SEQUENTIAL_ONLY
   static void arrival_rc(master_state *s, tw_bf *bf, ispd_message *msg, tw_lp *lp) {
-    /// Calculate the task`s turnaround time.
-    const double turnaround_time = msg->task.m_EndTime - msg->task.m_SubmitTime;
-
-    /// Reverse the master's metrics.
-    s->metrics.completed_tasks--;
-    s->metrics.total_turnaround_time -= turnaround_time;
+    /// @Note: The master's metrics are only updated when the event is committed
+    ///        and, therefore, there is nothing to be reversed.
   }
+#endif // ISPD_SEQUENTIAL_ONLY
 
 };
 
 }; // namespace services
 }; // namespace ispd
+
+/// \brief The master's service type, which is resolved by the handler wrappers.
+template <> struct ispd::profiling::ServiceTypeOf<ispd::services::master_state> {
+  static constexpr auto value = ispd::services::ServiceType::MASTER;
+};
 #endif // ISPD_SERVICE_MASTER_HPP
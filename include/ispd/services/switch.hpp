@@ -2,12 +2,14 @@
 #define ISPD_SERVICE_SWITCH_HPP
 
 #include <ross.h>
-#include <chrono>
 #include <ispd/debug/debug.hpp>
 #include <ispd/model/builder.hpp>
 #include <ispd/message/message.hpp>
 #include <ispd/routing/routing.hpp>
 #include <ispd/metrics/metrics.hpp>
+#include <ispd/metrics/lp_metrics.hpp>
+#include <ispd/instrumentation/model_stats.hpp>
+#include <ispd/profiling/handler_profile.hpp>
 #include <ispd/configuration/switch.hpp>
 
 namespace ispd::services {
@@ -50,94 +52,86 @@ struct Switch {
                "and route offset (%u).",
                lp->gid, tw_now(lp), msg->type, msg->route_offset);
 
-#ifdef DEBUG_ON
-  const auto start = std::chrono::high_resolution_clock::now();
-#endif // DEBUG_ON
-
     /// Fetch the communication size and calculate the communication time.
     const double commSize = msg->task.m_CommSize;
     const double commTime = s->m_Conf.timeToCommunicate(commSize);
 
-    /// Update the switch's metrics.
-    if (msg->downward_direction) {
-      s->m_Metrics.m_DownwardCommMbits += commSize;
-      s->m_Metrics.m_DownwardCommPackets++;
-    } else {
-      s->m_Metrics.m_UpwardCommMbits += commSize;
-      s->m_Metrics.m_UpwardCommPackets++;
-    }
-
     const ispd::routing::Route *route =
         ispd::routing_table::getRoute(msg->task.m_Origin, msg->task.m_Dest);
 
+    /// The offset is this switch's index within the route and, therefore, the
+    /// packet is sent to the adjacent link in its direction.
+    const int next_hop = msg->downward_direction ? (msg->route_offset + 1)
+                                                 : (msg->route_offset - 1);
+
     tw_event *const e =
-        tw_event_new(route->get(msg->route_offset), g_tw_lookahead + commTime, lp);
+        tw_event_new(route->get(next_hop), g_tw_lookahead + commTime, lp);
     ispd_message *const m = static_cast<ispd_message *>(tw_event_data(e));
 
     m->type = message_type::ARRIVAL;
     m->task = msg->task; /// Copies the task information.
+    m->latency = msg->latency;
+    m->latency.m_SwitchTransit += commTime;
     m->task_processed = msg->task_processed;
     m->downward_direction = msg->downward_direction;
-    m->route_offset = msg->downward_direction ? (msg->route_offset + 1)
-                                              : (msg->route_offset - 1);
+    m->route_offset = msg->downward_direction ? (msg->route_offset + 2)
+                                              : (msg->route_offset - 2);
     m->previous_service_id = lp->gid;
 
     tw_event_send(e);
-
-#ifdef DEBUG_ON
-  const auto end = std::chrono::high_resolution_clock::now();
-  const auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
-  const auto timeTaken = static_cast<double>(duration.count());
-
-  ispd::node_metrics::notifyMetric(ispd::metrics::NodeMetricsFlag::NODE_SWITCH_FORWARD_TIME, timeTaken);
-#endif // DEBUG_ON
   }
 
+#ifndef ISPD_SEQUENTIAL_ONLY
   static void reverse(SwitchState *s, tw_bf *bf, ispd_message *msg, tw_lp *lp) {
     ispd_debug("[Reverse] Switch %lu received a message at %lf of type (%d).",
                lp->gid, tw_now(lp), msg->type);
 
-#ifdef DEBUG_ON
-  const auto start = std::chrono::high_resolution_clock::now();
-#endif // DEBUG_ON
+    /// @Note: The switch has no queueing model information and its metrics are
+    ///        only updated when the event is committed. Therefore, there is
+    ///        nothing to be reversed.
+  }
+#endif // ISPD_SEQUENTIAL_ONLY
 
+  static void commit(SwitchState *s, tw_bf *bf, ispd_message *msg, tw_lp *lp) {
     const double commSize = msg->task.m_CommSize;
-    const double commTime = s->m_Conf.timeToCommunicate(commSize);
 
-    /// Reverse the switch's metrics.
+    /// Update the switch's metrics.
     if (msg->downward_direction) {
-      s->m_Metrics.m_DownwardCommMbits -= commSize;
-      s->m_Metrics.m_DownwardCommPackets--;
+      s->m_Metrics.m_DownwardCommMbits += commSize;
+      s->m_Metrics.m_DownwardCommPackets++;
     } else {
-      s->m_Metrics.m_UpwardCommMbits -= commSize;
-      s->m_Metrics.m_UpwardCommPackets--;
+      s->m_Metrics.m_UpwardCommMbits += commSize;
+      s->m_Metrics.m_UpwardCommPackets++;
     }
+  }
 
-#ifdef DEBUG_ON
-  const auto end = std::chrono::high_resolution_clock::now();
-  const auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
-  const auto timeTaken = static_cast<double>(duration.count());
-
-  ispd::node_metrics::notifyMetric(ispd::metrics::NodeMetricsFlag::NODE_SWITCH_REVERSE_TIME, timeTaken);
-#endif // DEBUG_ON
+  static void stats(SwitchState *s, tw_lp *lp,
+                    ispd::instrumentation::ModelStats *stats) {
+    /// @Note: The switch has no queueing model information, therefore, only its
+    ///        packets are sampled.
+    stats->m_Type = static_cast<std::uint32_t>(ServiceType::SWITCH);
+    stats->m_Packets = s->m_Metrics.m_UpwardCommPackets +
+                       s->m_Metrics.m_DownwardCommPackets;
   }
 
   static void finish(SwitchState *s, tw_lp *lp) {
-    ispd::node_metrics::notifyMetric(ispd::metrics::NodeMetricsFlag::NODE_TOTAL_MASTER_SERVICES);
-
-    std::printf("Switch Queue Info & Metrics (%lu)\n"
-                " - Downward Communicated Mbits..: %lf Mbits (%lu).\n"
-                " - Downward Communicated Packets: %u packets (%lu).\n"
-                " - Upward Communicated Mbits....: %lf Mbits (%lu).\n"
-                " - Upward Communicated Packets..: %u packets (%lu).\n"
-                "\n",
-                lp->gid, s->m_Metrics.m_DownwardCommMbits, lp->gid,
-                s->m_Metrics.m_DownwardCommPackets, lp->gid,
-                s->m_Metrics.m_UpwardCommMbits, lp->gid,
-                s->m_Metrics.m_UpwardCommPackets, lp->gid);
+    ispd::node_metrics::notifyMetric<ispd::metrics::NodeMetricsFlag::NODE_TOTAL_SWITCH_SERVICES>();
+
+    /// Record this switch's metrics.
+    ispd::lp_metrics::record(
+        lp->gid, ServiceType::SWITCH,
+        {s->m_Metrics.m_DownwardCommMbits,
+         static_cast<double>(s->m_Metrics.m_DownwardCommPackets),
+         s->m_Metrics.m_UpwardCommMbits,
+         static_cast<double>(s->m_Metrics.m_UpwardCommPackets)});
   }
 };
 
 }; // namespace ispd::services
 
+/// \brief The switch's service type, which is resolved by the handler wrappers.
+template <> struct ispd::profiling::ServiceTypeOf<ispd::services::SwitchState> {
+  static constexpr auto value = ispd::services::ServiceType::SWITCH;
+};
+
 #endif // ISPD_SERVICE_SWITCH_HPP
@@ -1,52 +1,65 @@
-#include <fstream>
-#include <ispd/log/log.hpp>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <algorithm>
 #include <cstdarg>
+#include <cstring>
+#include <unistd.h>
+#include <ispd/log/log.hpp>
+#include <ispd/log/binary_log.hpp>
 
 namespace ispd::log {
 
 /// \brief The logging file in which the log will be stored.
 FILE *logfile;
 
-/// \brief The log function is used to log messages at different log levels.
-///
-/// This function logs messages with the specified log level, along with the
-/// source file location and additional formatted message content. The log
-/// messages are written to the output log file, which should be set using the
-/// setOutputFile function before calling this function.
-///
-/// \param level The log level of the message. Can be LOG_DEBUG, LOG_INFO, or
-/// LOG_ERROR. \param filepath The path of the source file where the log message
-/// is generated. \param line The line number in the source file where the log
-/// message is generated. \param fmt The format string for the log message,
-/// similar to printf-style formatting. \param ... Additional arguments to be
-/// formatted according to the format string.
-///
-/// \note For DEBUG_ON compilation, if the log level is LOG_DEBUG and DEBUG_ON
-/// is not defined, the log message will not be generated.
+/// \brief Whether the text log is written with ANSI colors, which is only the
+///        case when it is written to a terminal.
+static bool g_Colored = false;
+
+int g_MinLevel = static_cast<int>(LogLevel::LOG_DEBUG);
+bool g_BinaryLog = false;
+
+void setLevel(const LogLevel level) noexcept {
+  g_MinLevel = std::min(static_cast<int>(level),
+                        static_cast<int>(LogLevel::LOG_ERROR));
+}
+
+bool parseLevel(const std::string_view name, LogLevel &level) noexcept {
+  for (int i = 0; i < static_cast<int>(std::size(levels)); i++) {
+    if (name.size() == std::strlen(levels[i].name) &&
+        strncasecmp(name.data(), levels[i].name, name.size()) == 0) {
+      level = static_cast<LogLevel>(i);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/// \brief Writes a message's header, with its log level and its call site.
+static void writeHeader(FILE *const file, const LogLevel level,
+                        const char *const filepath, const unsigned line,
+                        const bool colored) noexcept {
+  const auto integerLevelValue = static_cast<int>(level);
+
+  if (colored)
+    fprintf(file, "%s%-5s\x1b[0m \x1b[90m%s:%u:\x1b[0m ",
+            levels[integerLevelValue].color, levels[integerLevelValue].name,
+            filepath, line);
+  else
+    fprintf(file, "%-5s %s:%u: ", levels[integerLevelValue].name, filepath,
+            line);
+}
+
+/// \brief Writes a message as text.
 ///
 /// \note If the log file has not been set using the setOutputFile function, an
 /// error message will be printed to stderr and the program will be aborted.
-///
-/// \note After logging the message, the log file will be flushed to ensure the
-/// message is written immediately.
-///
-/// \note If the log level is LOG_ERROR, the program will be aborted after
-/// logging the message.
-///
-/// \note The function uses variadic arguments for formatting the log message
-/// content.
-void log(const LogLevel level, std::string_view filepath, const unsigned line,
-         const std::string_view fmt, ...) noexcept {
-#ifndef DEBUG_ON
-  // Check if the log level is LOG_DEBUG and DEBUG_ON is not defined, in which
-  // case, return.
-  if (level == LogLevel::LOG_DEBUG)
-    return;
-#endif // DEBUG_ON
-
+void writeText(const LogSite &site, const char *fmt, ...) noexcept {
   va_list args; // Variable argument list.
-  const auto integerLevelValue =
-      static_cast<int>(level); // Convert LogLevel to integer.
 
   // Check if the log file has been set.
   if (!logfile) {
@@ -55,21 +68,18 @@ void log(const LogLevel level, std::string_view filepath, const unsigned line,
     abort(); // Abort the program.
   }
 
-  // Write log message header with log level, source file location, and line
-  // number.
-  fprintf(logfile, "%s%-5s\x1b[0m \x1b[90m%s:%u:\x1b[0m ",
-          levels[integerLevelValue].color, levels[integerLevelValue].name,
-          filepath.data(), line);
+  writeHeader(logfile, site.m_Level, site.m_File, site.m_Line, g_Colored);
 
-  va_start(args, fmt);                 // Initialize variable argument list.
-  vfprintf(logfile, fmt.data(), args); // Format and write additional arguments.
-  va_end(args);                        // End variable argument processing.
-  fprintf(logfile, "\n");              // Add a newline to the log message.
-  fflush(logfile); // Flush the log file to ensure immediate writing.
+  va_start(args, fmt);           // Initialize variable argument list.
+  vfprintf(logfile, fmt, args);  // Format and write additional arguments.
+  va_end(args);                  // End variable argument processing.
+  fputc('\n', logfile);          // Add a newline to the log message.
 
   // If the log level is LOG_ERROR, abort the program after logging the message.
-  if (level == LogLevel::LOG_ERROR)
+  if (site.m_Level == LogLevel::LOG_ERROR) {
+    fflush(logfile);
     abort();
+  }
 }
 
 /// \brief Sets the output log file for logging messages.
@@ -81,22 +91,269 @@ void log(const LogLevel level, std::string_view filepath, const unsigned line,
 /// by default.
 ///
 /// \param f A pointer to the file where log messages should be written. Can be
-/// nullptr to
-///          use the standard output.
-///
-/// \note The setOutputFile function provides flexibility in directing log
-/// messages to a specific file or the standard output.
-///
-/// \note If you want to log messages to a custom file, call this function
-/// before using the log function to ensure that the log messages are written to
-/// the desired file.
+/// nullptr to use the standard output.
 ///
-/// \note If the provided file pointer is nullptr, log messages will be written
-/// to the standard output.
+/// \note The log messages are only colored if the log file is a terminal.
 void setOutputFile(FILE *const f) noexcept {
   // If the provided file pointer is nullptr, set the log file to the standard
   // output.
   logfile = f == nullptr ? stdout : f;
+  g_Colored = isatty(fileno(logfile));
+}
+
+namespace {
+/// \class LogRing
+///
+/// \brief A single-producer single-consumer lock-free ring buffer of bytes.
+///
+/// The simulation's thread is the only producer, and the background writer is
+/// the only consumer. The positions grow monotonically and are only wrapped
+/// when the buffer is indexed.
+class LogRing {
+public:
+  explicit LogRing(const std::size_t capacity)
+      : m_Buffer(capacity), m_Mask(capacity - 1) {}
+
+  /// \brief Pushes the specified bytes, waiting for the consumer while there
+  ///        is not enough free space.
+  void push(const std::uint8_t *data, const std::size_t size) noexcept {
+    const std::uint64_t head = m_Head.load(std::memory_order_relaxed);
+
+    while (m_Buffer.size() - (head - m_Tail.load(std::memory_order_acquire)) <
+           size)
+      std::this_thread::yield();
+
+    copy(head, data, size);
+    m_Head.store(head + size, std::memory_order_release);
+  }
+
+  /// \brief Writes every pushed byte to the specified file.
+  ///
+  /// \return Whether any byte has been written.
+  bool drain(FILE *const file) noexcept {
+    const std::uint64_t tail = m_Tail.load(std::memory_order_relaxed);
+    const std::uint64_t head = m_Head.load(std::memory_order_acquire);
+
+    if (head == tail)
+      return false;
+
+    /// The pushed bytes may wrap around the buffer's end. If so, they are
+    /// written in two pieces.
+    const std::size_t begin = tail & m_Mask;
+    const std::size_t size = head - tail;
+    const std::size_t first = std::min(size, m_Buffer.size() - begin);
+
+    fwrite(m_Buffer.data() + begin, 1, first, file);
+    fwrite(m_Buffer.data(), 1, size - first, file);
+
+    m_Tail.store(head, std::memory_order_release);
+    return true;
+  }
+
+private:
+  void copy(const std::uint64_t position, const std::uint8_t *data,
+            const std::size_t size) noexcept {
+    const std::size_t begin = position & m_Mask;
+    const std::size_t first = std::min(size, m_Buffer.size() - begin);
+
+    std::memcpy(m_Buffer.data() + begin, data, first);
+    std::memcpy(m_Buffer.data(), data + first, size - first);
+  }
+
+  std::vector<std::uint8_t> m_Buffer;
+  const std::size_t m_Mask;
+
+  /// \brief The producer's and the consumer's positions, kept in different
+  ///        cache lines so that they do not falsely share one.
+  alignas(64) std::atomic<std::uint64_t> m_Head{0};
+  alignas(64) std::atomic<std::uint64_t> m_Tail{0};
+};
+
+/// \brief The binary log's ring buffer, or nullptr if no binary log is open.
+LogRing *g_Ring = nullptr;
+
+/// \brief The binary log's file.
+FILE *g_BinaryFile = nullptr;
+
+/// \brief The background thread that writes the binary log.
+std::thread g_Writer;
+
+/// \brief Whether the background thread should stop once the ring is drained.
+std::atomic<bool> g_Stopping{false};
+
+/// \brief The next call site identifier to be given.
+std::uint32_t g_NextSiteId = 1;
+
+/// \brief The time at which the binary log has been opened.
+std::chrono::steady_clock::time_point g_OpenTime;
+
+/// \brief The background thread's loop.
+void writeLoop() noexcept {
+  for (;;) {
+    /// The stopping flag is read before draining, so that every byte pushed
+    /// before stopping is written.
+    const bool stopping = g_Stopping.load(std::memory_order_acquire);
+
+    if (g_Ring->drain(g_BinaryFile))
+      continue;
+
+    if (stopping)
+      break;
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  fflush(g_BinaryFile);
+}
+
+/// \brief Encodes a record into a buffer, which is pushed at once.
+class RecordEncoder {
+public:
+  template <typename T> void put(const T &value) noexcept {
+    static_assert(std::is_trivially_copyable_v<T>);
+    putBytes(&value, sizeof(T));
+  }
+
+  /// \brief Puts a string preceded by its length, truncated if it does not
+  ///        fit in the record.
+  ///
+  /// \param reserve The bytes kept free for the record's next arguments. The
+  ///                length put is the truncated length, so that the decoder
+  ///                always reads the record's arguments in step.
+  void putString(const char *string, const std::size_t reserve = 0) noexcept {
+    const std::size_t length = string ? std::strlen(string) : 0;
+    const std::size_t room =
+        m_Data.size() - m_Size - sizeof(std::uint16_t) - reserve;
+    const auto fitting = static_cast<std::uint16_t>(
+        std::min({length, MAX_STRING_SIZE, room}));
+
+    put(fitting);
+    putBytes(string, fitting);
+  }
+
+  void push() noexcept { g_Ring->push(m_Data.data(), m_Size); }
+
+  /// \brief The maximum size of a string argument.
+  static constexpr std::size_t MAX_STRING_SIZE = 1024;
+
+  /// \brief The bytes kept free for each message argument still to be put,
+  ///        which hold its tag and either its 8 bytes or an empty string.
+  static constexpr std::size_t ARGUMENT_RESERVE = 1 + sizeof(std::uint64_t);
+
+private:
+  void putBytes(const void *data, const std::size_t size) noexcept {
+    const std::size_t fitting = std::min(size, m_Data.size() - m_Size);
+    std::memcpy(m_Data.data() + m_Size, data, fitting);
+    m_Size += fitting;
+  }
+
+  std::array<std::uint8_t, BINARY_LOG_MAX_RECORD_SIZE> m_Data;
+  std::size_t m_Size = 0;
+};
+}; // namespace
+
+void writeBinary(LogSite &site, const char *fmt, const LogArgument *args,
+                 const std::size_t count) noexcept {
+  /// The first message of a call site is preceded by the site's definition,
+  /// which the decoder needs to render the site's messages.
+  if (site.m_Id == 0) {
+    site.m_Id = g_NextSiteId++;
+
+    RecordEncoder definition;
+    definition.put(BinaryLogRecord::SITE);
+    definition.put(site.m_Id);
+    definition.put(static_cast<std::uint8_t>(site.m_Level));
+    definition.put(static_cast<std::uint32_t>(site.m_Line));
+    definition.putString(site.m_File);
+    definition.putString(fmt);
+    definition.push();
+  }
+
+  const std::chrono::duration<std::uint64_t, std::nano> elapsed =
+      std::chrono::steady_clock::now() - g_OpenTime;
+
+  /// Every argument is put, even if the strings before it have to be
+  /// truncated, since the record's argument count has already been put.
+  static_assert(1 + sizeof(std::uint32_t) + sizeof(std::uint64_t) + 1 +
+                    UINT8_MAX * RecordEncoder::ARGUMENT_RESERVE <=
+                BINARY_LOG_MAX_RECORD_SIZE);
+
+  /// A site's definition always fits, with both of its strings.
+  static_assert(1 + 2 * sizeof(std::uint32_t) + 1 +
+                    2 * (sizeof(std::uint16_t) +
+                         RecordEncoder::MAX_STRING_SIZE) <=
+                BINARY_LOG_MAX_RECORD_SIZE);
+
+  RecordEncoder message;
+  message.put(BinaryLogRecord::MESSAGE);
+  message.put(site.m_Id);
+  message.put(elapsed.count());
+  message.put(static_cast<std::uint8_t>(count));
+
+  for (std::size_t i = 0; i < count; i++) {
+    message.put(args[i].m_Tag);
+
+    if (args[i].m_Tag == LogArgumentTag::STRING)
+      message.putString(args[i].m_String,
+                        (count - i - 1) * RecordEncoder::ARGUMENT_RESERVE);
+    else
+      message.put(args[i].m_Unsigned);
+  }
+
+  message.push();
+
+  /// The errors are also written as text, since the program is aborted right
+  /// after them and they should be seen without decoding the binary log.
+  if (site.m_Level == LogLevel::LOG_ERROR) {
+    writeHeader(stderr, site.m_Level, site.m_File, site.m_Line, false);
+    fprintf(stderr, "%s (see the binary log)\n", fmt);
+    close();
+    abort();
+  }
+}
+
+void openBinary(const std::string &prefix, const unsigned rank,
+                const std::size_t capacity) noexcept {
+  const std::string filepath = prefix + "." + std::to_string(rank) + ".log";
+  g_BinaryFile = fopen(filepath.c_str(), "wb");
+
+  /// Checks if the binary log could not be opened. If so, the program is
+  /// immediately aborted.
+  if (!g_BinaryFile)
+    ispd_error("Binary log %s could not be opened.", filepath.c_str());
+
+  BinaryLogHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.m_Magic, "ISPDLOG", 8);
+  header.m_Version = BINARY_LOG_VERSION;
+  header.m_Rank = rank;
+  fwrite(&header, sizeof(header), 1, g_BinaryFile);
+
+  /// The capacity is rounded up to a power of two, so that the ring buffer
+  /// is indexed by a mask, and it must hold at least one record.
+  std::size_t roundedCapacity = BINARY_LOG_MAX_RECORD_SIZE;
+  while (roundedCapacity < capacity)
+    roundedCapacity *= 2;
+
+  g_Ring = new LogRing(roundedCapacity);
+  g_OpenTime = std::chrono::steady_clock::now();
+  g_Writer = std::thread(writeLoop);
+  g_BinaryLog = true;
+}
+
+void close() noexcept {
+  if (g_BinaryLog) {
+    g_BinaryLog = false;
+    g_Stopping.store(true, std::memory_order_release);
+    g_Writer.join();
+
+    fclose(g_BinaryFile);
+    delete g_Ring;
+    g_Ring = nullptr;
+  }
+
+  if (logfile)
+    fflush(logfile);
 }
 
 } // namespace ispd::log
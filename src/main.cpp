@@ -1,107 +1,259 @@
 #include <iostream>
 #include <memory>
+#include <cstring>
+#include <algorithm>
 #include <ross.h>
 #include <ross-extern.h>
 #include <ispd/log/log.hpp>
 #include <ispd/model/builder.hpp>
+#include <ispd/model/topology.hpp>
+#include <ispd/mapping/mapping.hpp>
 #include <ispd/services/link.hpp>
-#include <ispd/services/dummy.hpp>
 #include <ispd/services/master.hpp>
 #include <ispd/services/switch.hpp>
 #include <ispd/services/machine.hpp>
 #include <ispd/message/message.hpp>
 #include <ispd/routing/routing.hpp>
 #include <ispd/metrics/metrics.hpp>
-#include <ispd/workload/workload.hpp>
-#include <ispd/workload/interarrival.hpp>
-
+#include <ispd/metrics/histogram.hpp>
+#include <ispd/metrics/lp_metrics.hpp>
+#include <ispd/metrics/time_series.hpp>
+#include <ispd/memory/event_pool.hpp>
+#include <ispd/profiling/profile.hpp>
+#include <ispd/profiling/trace.hpp>
+#include <ispd/profiling/traffic.hpp>
+#include <ispd/report/report.hpp>
+#include <ispd/profiling/handlers.hpp>
+#include <ispd/instrumentation/model_stats.hpp>
+#include <ispd/partitioning/graph.hpp>
+#include <ispd/partitioning/partitioner.hpp>
+
+static char g_topology[32] = "star";
 static unsigned g_star_machine_amount = 10;
-static unsigned g_star_task_amount = 100;
-
-tw_peid mapping(tw_lpid gid) { return (tw_peid)gid / g_tw_nlp; }
+static unsigned g_task_amount = 100;
+static unsigned g_tree_fanout = 4;
+static unsigned g_tree_depth = 2;
+static char g_partitioner[32] = "block";
+static char g_kp_grouping[32] = "topology";
+static unsigned g_kp_per_pe = 16;
+static char g_profile_in[256] = "";
+static char g_profile_out[256] = "";
+static unsigned g_auto_event_pool = 1;
+static char g_lp_metrics[256] = "lp-metrics.bin";
+static char g_series_out[256] = "";
+static double g_series_window = 100.0;
+static unsigned g_series_max_windows = 4096;
+static char g_report[256] = "";
+static unsigned g_traffic = 0;
+static unsigned g_hot_lps = 10;
+static char g_log_level[16] = "debug";
+static char g_log_binary[256] = "";
+static unsigned g_log_buffer = 1u << 22;
+#ifdef ISPD_PROFILE_HANDLERS
+static unsigned g_handler_sample = 1;
+static unsigned g_handler_counters = 1;
+#endif // ISPD_PROFILE_HANDLERS
+#ifdef ISPD_TRACE
+static char g_trace[256] = "";
+static unsigned g_trace_buffer = 1u << 20;
+static double g_trace_gap = 10.0;
+#endif // ISPD_TRACE
+
+using ispd::profiling::Init;
+using ispd::profiling::Commit;
+using ispd::profiling::Finish;
+using ispd::profiling::Forward;
+using ispd::profiling::Reverse;
+using ispd::instrumentation::ModelStat;
+using ispd::instrumentation::ModelStats;
+
+/// The sequential-only build has no reverse handlers, since no event is ever
+/// rolled back by the sequential scheduler.
+#ifdef ISPD_SEQUENTIAL_ONLY
+#define REVERSE_HANDLER(HANDLER) (revent_f) NULL
+#else
+#define REVERSE_HANDLER(HANDLER) (revent_f) Reverse<HANDLER>::handle
+#endif // ISPD_SEQUENTIAL_ONLY
+
+tw_peid mapping(tw_lpid gid) { return ispd::lp_mapping::getPe(gid); }
 
 tw_lptype lps_type[] = {
-    {(init_f)ispd::services::master::init, (pre_run_f)NULL,
-     (event_f)ispd::services::master::forward,
-     (revent_f)ispd::services::master::reverse,
-     (commit_f)ispd::services::master::commit,
-     (final_f)ispd::services::master::finish, (map_f)mapping,
+    {(init_f)Init<ispd::services::master::init>::handle, (pre_run_f)NULL,
+     (event_f)Forward<ispd::services::master::forward>::handle,
+     REVERSE_HANDLER(ispd::services::master::reverse),
+     (commit_f)Commit<ispd::services::master::commit>::handle,
+     (final_f)Finish<ispd::services::master::finish>::handle, (map_f)mapping,
      sizeof(ispd::services::master_state)},
-    {(init_f)ispd::services::link::init, (pre_run_f)NULL,
-     (event_f)ispd::services::link::forward,
-     (revent_f)ispd::services::link::reverse, (commit_f)NULL,
-     (final_f)ispd::services::link::finish, (map_f)mapping,
+    {(init_f)Init<ispd::services::link::init>::handle, (pre_run_f)NULL,
+     (event_f)Forward<ispd::services::link::forward>::handle,
+     REVERSE_HANDLER(ispd::services::link::reverse),
+     (commit_f)Commit<ispd::services::link::commit>::handle,
+     (final_f)Finish<ispd::services::link::finish>::handle, (map_f)mapping,
      sizeof(ispd::services::link_state)},
-    {(init_f)ispd::services::machine::init, (pre_run_f)NULL,
-     (event_f)ispd::services::machine::forward,
-     (revent_f)ispd::services::machine::reverse,
-     (commit_f)ispd::services::machine::commit,
-     (final_f)ispd::services::machine::finish, (map_f)mapping,
+    {(init_f)Init<ispd::services::machine::init>::handle, (pre_run_f)NULL,
+     (event_f)Forward<ispd::services::machine::forward>::handle,
+     REVERSE_HANDLER(ispd::services::machine::reverse),
+     (commit_f)Commit<ispd::services::machine::commit>::handle,
+     (final_f)Finish<ispd::services::machine::finish>::handle, (map_f)mapping,
      sizeof(ispd::services::machine_state)},
-    {(init_f)ispd::services::Switch::init, (pre_run_f)NULL,
-     (event_f)ispd::services::Switch::forward,
-     (revent_f)ispd::services::Switch::reverse, (commit_f)NULL,
-     (final_f)ispd::services::Switch::finish, (map_f)mapping,
-     sizeof(ispd::services::Switch)},
-    {(init_f)ispd::services::dummy::init, (pre_run_f)NULL,
-     (event_f)ispd::services::dummy::forward,
-     (revent_f)ispd::services::dummy::reverse, (commit_f)NULL,
-     (final_f)ispd::services::dummy::finish, (map_f)mapping,
-     sizeof(ispd::services::dummy_state)},
+    {(init_f)Init<ispd::services::Switch::init>::handle, (pre_run_f)NULL,
+     (event_f)Forward<ispd::services::Switch::forward>::handle,
+     REVERSE_HANDLER(ispd::services::Switch::reverse),
+     (commit_f)Commit<ispd::services::Switch::commit>::handle,
+     (final_f)Finish<ispd::services::Switch::finish>::handle, (map_f)mapping,
+     sizeof(ispd::services::SwitchState)},
+    {0},
+};
+
+/// The model statistics' callbacks, indexed in the same order as `lps_type`.
+st_model_types model_types[] = {
+    {(ev_trace_f)NULL, 0,
+     (model_stat_f)ModelStat<ispd::services::master::stats>::handle,
+     sizeof(ModelStats), (sample_event_f)NULL, (sample_revent_f)NULL, 0},
+    {(ev_trace_f)NULL, 0,
+     (model_stat_f)ModelStat<ispd::services::link::stats>::handle,
+     sizeof(ModelStats), (sample_event_f)NULL, (sample_revent_f)NULL, 0},
+    {(ev_trace_f)NULL, 0,
+     (model_stat_f)ModelStat<ispd::services::machine::stats>::handle,
+     sizeof(ModelStats), (sample_event_f)NULL, (sample_revent_f)NULL, 0},
+    {(ev_trace_f)NULL, 0,
+     (model_stat_f)ModelStat<ispd::services::Switch::stats>::handle,
+     sizeof(ModelStats), (sample_event_f)NULL, (sample_revent_f)NULL, 0},
     {0},
 };
 
 const tw_optdef opt[] = {
     TWOPT_GROUP("iSPD Model"),
+    TWOPT_CHAR("topology", g_topology, "topology to simulate (star or tree)"),
     TWOPT_UINT("machine-amount", g_star_machine_amount,
-               "number of machines to simulate"),
-    TWOPT_UINT("task-amount", g_star_task_amount,
+               "number of machines to simulate (star)"),
+    TWOPT_UINT("task-amount", g_task_amount,
                "number of tasks to simulate"),
+    TWOPT_UINT("tree-fanout", g_tree_fanout,
+               "number of children of each master or switch (tree)"),
+    TWOPT_UINT("tree-depth", g_tree_depth, "depth of the machines (tree)"),
+    TWOPT_CHAR("partitioner", g_partitioner,
+               "LP-to-PE partitioner (block, multilevel or metis)"),
+    TWOPT_CHAR("kp-grouping", g_kp_grouping,
+               "LP-to-KP grouping (block or topology)"),
+    TWOPT_UINT("kp-per-pe", g_kp_per_pe, "maximum number of KPs per PE"),
+    TWOPT_CHAR("profile-in", g_profile_in,
+               "prefix of a previous run's per-LP profile to partition with"),
+    TWOPT_CHAR("profile-out", g_profile_out,
+               "prefix of the per-LP profile to be dumped"),
+    TWOPT_UINT("auto-event-pool", g_auto_event_pool,
+               "size the event pool from the model (0 keeps ROSS' default)"),
+    TWOPT_CHAR("lp-metrics", g_lp_metrics,
+               "file of the per-LP metrics (empty to not write it)"),
+    TWOPT_CHAR("series-out", g_series_out,
+               "prefix of the time series to be written (empty to disable)"),
+    TWOPT_DOUBLE("series-window", g_series_window,
+                 "initial width of the time series' windows"),
+    TWOPT_UINT("series-max-windows", g_series_max_windows,
+               "windows kept per rank before the series are downsampled"),
+    TWOPT_CHAR("report", g_report,
+               "file of the JSON run report (empty to not write it)"),
+    TWOPT_UINT("traffic", g_traffic,
+               "count the committed events sent between PEs (0 or 1)"),
+    TWOPT_UINT("hot-lps", g_hot_lps,
+               "hottest LPs reported by each metric (0 to not report them)"),
+    TWOPT_CHAR("log-level", g_log_level,
+               "lowest logged level (debug, info or error)"),
+    TWOPT_CHAR("log-binary", g_log_binary,
+               "prefix of the per-rank binary logs (empty to log as text)"),
+    TWOPT_UINT("log-buffer", g_log_buffer,
+               "size (in bytes) of the binary log's ring buffer"),
+#ifdef ISPD_PROFILE_HANDLERS
+    TWOPT_UINT("handler-sample", g_handler_sample,
+               "measure 1 out of every N handler calls (a power of two)"),
+    TWOPT_UINT("handler-counters", g_handler_counters,
+               "read the hardware performance counters if available (0 or 1)"),
+#endif // ISPD_PROFILE_HANDLERS
+#ifdef ISPD_TRACE
+    TWOPT_CHAR("trace", g_trace,
+               "file of the Chrome trace to be recorded (empty to disable)"),
+    TWOPT_UINT("trace-buffer", g_trace_buffer,
+               "spans kept per rank before the next ones are dropped"),
+    TWOPT_DOUBLE("trace-gap", g_trace_gap,
+                 "longest gap (in microseconds) within a handler batch"),
+#endif // ISPD_TRACE
     TWOPT_END(),
 };
 
+/// \brief The names of ROSS' synchronization protocols, indexed by their
+///        values.
+static const char *const g_synch_names[] = {
+    "none", "sequential", "conservative", "optimistic", "optimistic-debug",
+    "optimistic-realtime"};
+
+/// \brief Records the run configuration in the run report.
+static void recordConfiguration() {
+  using ispd::run_report::setConfiguration;
+
+  setConfiguration("synch", g_synch_names[g_tw_synchronization_protocol]);
+  setConfiguration("end", static_cast<double>(g_tw_ts_end));
+  setConfiguration("lookahead", static_cast<double>(g_tw_lookahead));
+  setConfiguration("gvt_interval", std::uint64_t{g_tw_gvt_interval});
+  setConfiguration("batch", std::uint64_t{g_tw_mblock});
+  setConfiguration("topology", g_topology);
+  setConfiguration("machine_amount", std::uint64_t{g_star_machine_amount});
+  setConfiguration("task_amount", std::uint64_t{g_task_amount});
+  setConfiguration("tree_fanout", std::uint64_t{g_tree_fanout});
+  setConfiguration("tree_depth", std::uint64_t{g_tree_depth});
+  setConfiguration("partitioner", g_partitioner);
+  setConfiguration("kp_grouping", g_kp_grouping);
+  setConfiguration("kp_per_pe", std::uint64_t{g_kp_per_pe});
+  setConfiguration("auto_event_pool", std::uint64_t{g_auto_event_pool});
+  setConfiguration("profile_in", g_profile_in);
+}
+
 int main(int argc, char **argv) {
   ispd::log::setOutputFile(nullptr);
 
-  /// Read the routing table from a specified file.
-  ispd::routing_table::load("routes.route");
-
+  ispd::run_report::beginPhase("init");
   tw_opt_add(opt);
   tw_init(&argc, &argv);
 
+  ispd::log::LogLevel logLevel;
+
+  /// Checks if the log level is unknown. If so, the program is immediately
+  /// aborted.
+  if (!ispd::log::parseLevel(g_log_level, logLevel))
+    ispd_error("Unknown log level %s (debug, info or error).", g_log_level);
+
+  ispd::log::setLevel(logLevel);
+
+  if (g_log_binary[0] != '\0')
+    ispd::log::openBinary(g_log_binary, g_tw_mynode, g_log_buffer);
+
+#ifdef ISPD_SEQUENTIAL_ONLY
+  /// Checks if a parallel synchronization protocol has been selected. If so,
+  /// the program is immediately aborted, since this build has no reverse
+  /// computation and can only be run sequentially.
+  if (g_tw_synchronization_protocol != SEQUENTIAL)
+    ispd_error("This build of iSPD is sequential-only and must be run with "
+               "--synch=1.");
+#endif // ISPD_SEQUENTIAL_ONLY
+
   // If the synchronization protocol is different from conservative then,
   // there is no need to have a conservative lookahead different from 0.
   if (g_tw_synchronization_protocol != CONSERVATIVE)
     g_tw_lookahead = 0;
 
-  const tw_lpid highest_machine_id = g_star_machine_amount * 2;
-  const tw_lpid highest_link_id = highest_machine_id - 1;
+  recordConfiguration();
 
   /// Register the user.
+  ispd::run_report::beginPhase("model");
   ispd::this_model::registerUser("User1", 100.0);
 
-  /// Register a master.
-  std::vector<tw_lpid> slaves;
-  for (tw_lpid machine_id = 2; machine_id <= highest_machine_id;
-       machine_id += 2)
-    slaves.emplace_back(machine_id);
-
-  ispd::this_model::registerMaster(
-      0, std::move(slaves), new ispd::scheduler::RoundRobin,
-      ispd::workload::constant(
-          "User1", g_star_task_amount, 1000.0, 80.0, 0.95,
-          std::make_unique<ispd::workload::PoissonInterarrivalDistribution>(
-              0.1)));
-
-  /// Registers service initializers for the links.
-  for (tw_lpid link_id = 1; link_id <= highest_link_id; link_id += 2)
-    ispd::this_model::registerLink(link_id, 0, link_id + 1, 50.0, 0.0, 1.0);
-
-  /// Registers serivce initializers for the machines.
-  for (tw_lpid machine_id = 2; machine_id <= highest_machine_id;
-       machine_id += 2)
-    ispd::this_model::registerMachine(machine_id, 20.0, 0.0, 8, 9800.0, 4096,
-                                      6.4, 0.0, 0.0);
+  /// Register the services and the routes of the selected topology.
+  if (std::strcmp(g_topology, "star") == 0)
+    ispd::topology::star("User1", g_star_machine_amount, g_task_amount);
+  else if (std::strcmp(g_topology, "tree") == 0)
+    ispd::topology::tree("User1", g_tree_fanout, g_tree_depth,
+                         g_task_amount);
+  else
+    ispd_error("Unknown topology %s.", g_topology);
 
   /// Checks if no user has been registered. If so, the program is immediately
   /// aborted, since at least one user must be registered.
@@ -109,98 +261,172 @@ int main(int argc, char **argv) {
     ispd_error("At least one user must be registered.");
 
   /// The total number of logical processes.
-  const unsigned nlp = g_star_machine_amount * 2 + 1;
-
-  /// Distributed.
-  if (tw_nnodes() > 1) {
-    /// Here, since we are distributing the logical processes through many
-    /// nodes, the number of logical processes (LP) per process element (PE)
-    /// should be calculated.
-    ///
-    /// However, will be noted that when multiply the number of logical
-    /// processes per process element (nlp_per_pe) by the number of available
-    /// nodes (tw_nnodes()) the result may be greater than the total number of
-    /// lps (nlp). In this case, in the last node, after all the required
-    /// logical processes be created, the remaining logical processes are going
-    /// to be set as dummies.
-    const unsigned nlp_per_pe = (unsigned)ceil((double)nlp / tw_nnodes());
-
-    /// Set the number of logical processes (LP) per processing element (PE).
-    tw_define_lps(nlp_per_pe, sizeof(ispd_message));
-
-    /// Calculate the first logical processes global identifier in this node.
-    /// With that, it can be track if the logical process with that global
-    /// identifier should be set as a dummy.
-    tw_lpid current_gid = g_tw_mynode * nlp_per_pe;
-
-    /// Count the amount of dummies that should be set to this node.
-    unsigned dummy_count = 0;
-
-    if (g_tw_mynode == 0) {
-      /// Set the master logical process.
-      tw_lp_settype(0, &lps_type[0]);
-
-      /// Set the links and machines.
-      for (unsigned i = 1; i < nlp_per_pe; i++) {
-        if (current_gid > highest_machine_id) {
-          tw_lp_settype(i, &lps_type[4]);
-
-          dummy_count++;
-          current_gid++;
-          continue;
-        }
-
-        if (i & 1)
-          tw_lp_settype(i, &lps_type[1]);
-        else
-          tw_lp_settype(i, &lps_type[2]);
-        current_gid++;
-      }
-    } else {
-      /// Set the links and machines.
-      for (unsigned i = 0; i < nlp_per_pe; i++) {
-        if (current_gid > highest_machine_id) {
-          tw_lp_settype(i, &lps_type[4]);
-
-          dummy_count++;
-          current_gid++;
-          continue;
-        }
-
-        if (current_gid & 1)
-          tw_lp_settype(i, &lps_type[1]);
-        else
-          tw_lp_settype(i, &lps_type[2]);
-        current_gid++;
-      }
+  const tw_lpid nlp = ispd::this_model::getServiceCount();
+
+  /// The service graph is only built if it is going to be used, either by the
+  /// partitioner or by the KP grouping.
+  ispd::run_report::beginPhase("partitioning");
+  std::unique_ptr<ispd::partitioning::ServiceGraph> graph;
+  if (std::strcmp(g_partitioner, "block") != 0 ||
+      std::strcmp(g_kp_grouping, "topology") == 0)
+    graph = std::make_unique<ispd::partitioning::ServiceGraph>(
+        ispd::partitioning::buildServiceGraph());
+
+  /// If a previous run's profile has been specified, then the measured load
+  /// of each logical process replaces its estimated load.
+  if (graph && g_profile_in[0] != '\0') {
+    const auto records = ispd::lp_profile::load(g_profile_in);
+
+    for (const auto &record : records) {
+      if (record.m_Gid >= nlp)
+        ispd_error("The profile has an LP with GID %lu but the model has "
+                   "only %lu LPs.",
+                   record.m_Gid, nlp);
+
+      graph->setVertexWeight(record.m_Gid,
+                             record.m_Committed + record.m_RolledBack + 1);
     }
 
-    ispd_info("A total of %u dummies have been created at node %d.",
-              dummy_count, g_tw_mynode);
+    if (g_tw_mynode == 0)
+      ispd_info("A profile with %lu LPs has been loaded from %s.",
+                records.size(), g_profile_in);
+  } else if (g_profile_in[0] != '\0' && g_tw_mynode == 0)
+    ispd_info("The profile %s is ignored, since neither the partitioner nor "
+              "the KP grouping uses the service graph.",
+              g_profile_in);
+
+  if (std::strcmp(g_partitioner, "block") == 0) {
+    /// The logical processes are distributed in contiguous blocks of global
+    /// identifiers, whose sizes differ by at most one among the processing
+    /// elements. Therefore, no padding logical process is needed.
+    ispd::lp_mapping::installBlock(nlp);
+  } else {
+    std::unique_ptr<ispd::partitioning::Partitioner> partitioner;
+
+    if (std::strcmp(g_partitioner, "multilevel") == 0)
+      partitioner.reset(ispd::partitioning::multilevel());
+    else if (std::strcmp(g_partitioner, "metis") == 0)
+      partitioner.reset(ispd::partitioning::metis());
+    else
+      ispd_error("Unknown partitioner %s.", g_partitioner);
+
+    /// Every node partitions the service graph by itself. Since the
+    /// partitioners are deterministic, all nodes agree on the mapping
+    /// without exchanging it.
+    auto partition = partitioner->partition(*graph, tw_nnodes());
+
+    if (g_tw_mynode == 0)
+      ispd_info("The service graph has been partitioned by the %s "
+                "partitioner (Edge Cut: %ld, Imbalance: %.3lf).",
+                g_partitioner, graph->computeEdgeCut(partition),
+                graph->computeImbalance(partition, tw_nnodes()));
+
+    ispd::lp_mapping::install(std::move(partition));
   }
-  /// Sequential.
-  else {
-    /// Set the total number of logical processes that should be created.
-    tw_define_lps(nlp, sizeof(ispd_message));
 
-    /// The master type is set at the logical process with GID 0.
-    tw_lp_settype(0, &lps_type[0]);
+  /// ROSS rolls back at kernel process (KP) granularity. Hence, there are
+  /// many KPs per processing element, so that a rollback only affects the
+  /// logical processes grouped together with the rolled back one.
+  /// The same number of KPs is used at every processing element, bounded by
+  /// the fewest logical processes held by a processing element.
+  unsigned long localCount = ispd::lp_mapping::getLocalCount();
+  unsigned long fewestLocalCount;
+  MPI_Allreduce(&localCount, &fewestLocalCount, 1, MPI_UNSIGNED_LONG, MPI_MIN,
+                MPI_COMM_ROSS);
+  g_tw_nkp = std::max<tw_kpid>(
+      1, std::min<tw_kpid>(g_kp_per_pe, fewestLocalCount));
+
+  if (std::strcmp(g_kp_grouping, "topology") == 0)
+    ispd::lp_mapping::groupKps(*graph);
+  else if (std::strcmp(g_kp_grouping, "block") != 0)
+    ispd_error("Unknown KP grouping %s.", g_kp_grouping);
+
+  ispd::run_report::beginPhase("event_pool");
+
+  /// Estimate how many events this processing element needs from the model,
+  /// instead of relying on ROSS' default event pool.
+  const auto eventPoolEstimate = ispd::event_pool::estimate();
+  if (g_auto_event_pool)
+    ispd::event_pool::apply(eventPoolEstimate);
+
+  /// Set the number of logical processes (LP) at this processing element
+  /// (PE), which may differ among the processing elements.
+  ispd::run_report::beginPhase("define_lps");
+  tw_define_lps(ispd::lp_mapping::getLocalCount(), sizeof(ispd_message));
+  ispd::lp_profile::init(ispd::lp_mapping::getLocalCount(), g_profile_out,
+                         g_hot_lps);
+  ispd::traffic::init(g_traffic != 0);
+
+  /// The time series are only kept if they are going to be written, since
+  /// every committed event updates them.
+  if (g_series_out[0] != '\0')
+    ispd::time_series::init(g_series_window, g_series_max_windows,
+                            g_series_out);
+
+  /// Set the logical processes types following their services' types.
+  for (tw_lpid i = 0; i < ispd::lp_mapping::getLocalCount(); i++) {
+    const auto type =
+        ispd::this_model::getServiceType(ispd::lp_mapping::getLocalGid(i));
+    tw_lp_settype(i, &lps_type[static_cast<int>(type)]);
+
+    /// The model statistics are only registered if ROSS' instrumentation has
+    /// been requested to sample them.
+    if (g_st_model_stats)
+      st_model_settype(i, &model_types[static_cast<int>(type)]);
+  }
 
-    /// Set the logical processes types.
-    for (unsigned i = 1; i < nlp; i += 2) {
-      /// Register at odd logical process identifier the link.
-      tw_lp_settype(i, &lps_type[1]);
+#ifdef ISPD_PROFILE_HANDLERS
+  ispd::handler_profile::init(g_handler_sample, g_handler_counters != 0);
+#endif // ISPD_PROFILE_HANDLERS
+#ifdef ISPD_TRACE
+  ispd::trace::init(g_trace, g_trace_buffer, g_trace_gap);
+#endif // ISPD_TRACE
 
-      // Register at even logical process identifier the machine.
-      tw_lp_settype(i + 1, &lps_type[2]);
-    }
-  }
+  /// The run phase begins once the last local logical process has been
+  /// initialized. The LP mapping guarantees that every PE has at least one.
+  ispd::run_report::beginPhase("lp_init");
 
   tw_run();
+
+  ispd::run_report::beginPhase("finalize");
+  ispd::event_pool::report(eventPoolEstimate);
+  ispd::lp_profile::finish();
+  ispd::lp_metrics::write(g_lp_metrics);
+  ispd::time_series::finish();
   ispd::node_metrics::reportNodeMetrics();
+  ispd::task_histograms::reduce();
+  ispd::traffic::reduce();
+#ifdef ISPD_PROFILE_HANDLERS
+  ispd::handler_profile::reduce();
+#endif // ISPD_PROFILE_HANDLERS
+#ifdef ISPD_TRACE
+  ispd::trace::finish();
+#endif // ISPD_TRACE
+  ispd::run_report::collect();
   tw_end();
 
+  /// The binary log is closed before the reports, so that they are always
+  /// written as text.
+  ispd::log::close();
+
+  ispd::run_report::report();
   ispd::global_metrics::reportGlobalMetrics();
+  ispd::task_histograms::report();
+
+  ispd::run_report::addSection("latency", ispd::task_histograms::write);
+
+  if (g_hot_lps)
+    ispd::run_report::addSection("hot_lps", ispd::lp_profile::writeHotLps);
+
+  if (g_traffic) {
+    ispd::traffic::report();
+    ispd::run_report::addSection("traffic", ispd::traffic::write);
+  }
+#ifdef ISPD_PROFILE_HANDLERS
+  ispd::handler_profile::report();
+  ispd::run_report::addSection("handlers", ispd::handler_profile::write);
+#endif // ISPD_PROFILE_HANDLERS
+  ispd::run_report::write(g_report);
 
   return 0;
 }
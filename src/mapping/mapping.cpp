@@ -0,0 +1,175 @@
+#include <ross.h>
+#include <ispd/log/log.hpp>
+#include <ispd/mapping/mapping.hpp>
+#include <ispd/partitioning/partitioner.hpp>
+
+namespace ispd::mapping {
+
+LpMapping::LpMapping(std::vector<tw_peid> &&partition, const tw_peid self)
+    : m_Self(self), m_GidToPe(std::move(partition)),
+      m_GidToLocal(m_GidToPe.size()) {
+  /// The next local index at each PE.
+  std::vector<tw_lpid> nextIndex;
+
+  for (tw_lpid gid = 0; gid < m_GidToPe.size(); gid++) {
+    const tw_peid pe = m_GidToPe[gid];
+
+    if (pe >= nextIndex.size())
+      nextIndex.resize(pe + 1, 0);
+
+    m_GidToLocal[gid] = nextIndex[pe]++;
+
+    if (pe == self)
+      m_LocalToGid.push_back(gid);
+  }
+}
+
+LpMapping::LpMapping(const std::vector<tw_lpid> &counts, const tw_peid self)
+    : m_Self(self), m_Offsets(counts.size() + 1, 0) {
+  for (std::size_t pe = 0; pe < counts.size(); pe++)
+    m_Offsets[pe + 1] = m_Offsets[pe] + counts[pe];
+
+  m_LocalToGid.reserve(counts[self]);
+  for (tw_lpid gid = m_Offsets[self]; gid < m_Offsets[self + 1]; gid++)
+    m_LocalToGid.push_back(gid);
+}
+
+}; // namespace ispd::mapping
+
+namespace ispd::lp_mapping {
+
+/// \brief The global LP mapping.
+ispd::mapping::LpMapping *g_LpMapping = nullptr;
+
+/// \brief Places the local LPs and the KPs at this PE.
+///
+/// This function is called by ROSS from `tw_define_lps`.
+static void initialMapping() {
+  const tw_lpid localCount = g_LpMapping->getLocalCount();
+
+  for (tw_kpid kp = 0; kp < g_tw_nkp; kp++)
+    tw_kp_onpe(kp, g_tw_pe);
+
+  for (tw_lpid index = 0; index < localCount; index++) {
+    const tw_kpid kp = g_LpMapping->getLocalKp(index, g_tw_nkp);
+
+    tw_lp_onpe(index, g_tw_pe, g_LpMapping->getLocalGid(index));
+    tw_lp_onkp(g_tw_lp[index], g_tw_kp[kp]);
+  }
+}
+
+/// \brief Returns the local LP with the specified GID.
+///
+/// This function is called by ROSS for every event received by this PE.
+static tw_lp *globalToLocal(const tw_lpid gid) {
+  DEBUG({
+    if (g_LpMapping->getPe(gid) != g_LpMapping->getSelf())
+      ispd_error("LP with GID %lu is not simulated at PE %lu (Actual: %lu).",
+                 gid, g_LpMapping->getSelf(), g_LpMapping->getPe(gid));
+  });
+
+  return g_tw_lp[g_LpMapping->getLocalIndex(gid)];
+}
+
+/// \brief Sets the specified mapping as the global LP mapping and registers
+///        it within ROSS.
+static void setMapping(ispd::mapping::LpMapping *mapping) {
+  /// Checks if a mapping has already been installed. If so, the program is
+  /// immediately aborted.
+  if (g_LpMapping)
+    ispd_error("An LP mapping has already been installed.");
+
+  g_LpMapping = mapping;
+
+  /// Checks if this PE has been left without any LP. If so, the program is
+  /// immediately aborted, since ROSS requires at least one LP per PE.
+  if (g_LpMapping->getLocalCount() == 0)
+    ispd_error("No LP has been mapped to PE %lu.", g_LpMapping->getSelf());
+
+  g_tw_mapping = CUSTOM;
+  g_tw_custom_initial_mapping = &initialMapping;
+  g_tw_custom_lp_global_to_local_map = &globalToLocal;
+}
+
+void install(std::vector<tw_peid> &&partition) {
+  setMapping(new ispd::mapping::LpMapping(std::move(partition), g_tw_mynode));
+}
+
+void installBlock(const tw_lpid globalCount) {
+  const tw_peid peCount = tw_nnodes();
+  std::vector<tw_lpid> counts(peCount);
+
+  for (tw_peid pe = 0; pe < peCount; pe++)
+    counts[pe] = globalCount / peCount + (pe < globalCount % peCount ? 1 : 0);
+
+  setMapping(new ispd::mapping::LpMapping(counts, g_tw_mynode));
+}
+
+void groupKps(const ispd::partitioning::ServiceGraph &graph) {
+  using vertex_type = ispd::partitioning::ServiceGraph::vertex_type;
+
+  const tw_lpid localCount = g_LpMapping->getLocalCount();
+  const tw_peid self = g_LpMapping->getSelf();
+
+  /// A single KP needs no grouping.
+  if (g_tw_nkp <= 1)
+    return;
+
+  /// Checks if there are more KPs than local LPs. If so, the program is
+  /// immediately aborted, since it would leave some KPs empty.
+  if (g_tw_nkp > localCount)
+    ispd_error("There are more KPs (%lu) than LPs (%lu) at PE %lu.",
+               static_cast<unsigned long>(g_tw_nkp), localCount, self);
+
+  const auto &offsets = graph.getOffsets();
+  const auto &adjacency = graph.getAdjacency();
+  const auto &edgeWeights = graph.getEdgeWeights();
+  const auto &vertexWeights = graph.getVertexWeights();
+
+  /// Build the subgraph induced by the local LPs, whose vertices are the
+  /// LPs' local indices.
+  ispd::partitioning::ServiceGraphBuilder builder(localCount);
+
+  for (tw_lpid index = 0; index < localCount; index++) {
+    const vertex_type gid = g_LpMapping->getLocalGid(index);
+    builder.addVertexWeight(index, vertexWeights[gid]);
+
+    for (vertex_type e = offsets[gid]; e < offsets[gid + 1]; e++) {
+      const vertex_type neighbor = adjacency[e];
+
+      if (g_LpMapping->getPe(neighbor) != self)
+        continue;
+
+      /// Each edge is stored at both of its ends, therefore, it is only
+      /// added from the end with the lowest local index.
+      const tw_lpid neighborIndex = g_LpMapping->getLocalIndex(neighbor);
+      if (neighborIndex > index)
+        builder.addEdge(index, neighborIndex, edgeWeights[e]);
+    }
+  }
+
+  const auto subgraph = builder.build();
+  const auto partition =
+      ispd::partitioning::MultilevelPartitioner(0.03).partition(subgraph,
+                                                                g_tw_nkp);
+
+  g_LpMapping->setLocalKps(
+      std::vector<tw_kpid>(partition.begin(), partition.end()));
+}
+
+tw_peid getPe(const tw_lpid gid) {
+  /// Forward the PE query to the global LP mapping.
+  return g_LpMapping->getPe(gid);
+}
+
+tw_lpid getLocalGid(const tw_lpid index) {
+  /// Forward the GID query to the global LP mapping.
+  return g_LpMapping->getLocalGid(index);
+}
+
+tw_lpid getLocalCount() {
+  /// Forward the local count query to the global LP mapping.
+  return g_LpMapping->getLocalCount();
+}
+
+}; // namespace ispd::lp_mapping
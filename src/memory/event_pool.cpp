@@ -0,0 +1,108 @@
+#include <mpi.h>
+#include <limits>
+#include <vector>
+#include <algorithm>
+#include <ispd/log/log.hpp>
+#include <ispd/model/builder.hpp>
+#include <ispd/routing/routing.hpp>
+#include <ispd/mapping/mapping.hpp>
+#include <ispd/memory/event_pool.hpp>
+
+namespace ispd::event_pool {
+
+std::size_t g_LowestFree = std::numeric_limits<std::size_t>::max();
+
+auto estimate() -> ispd::memory::EventPoolEstimate {
+  const tw_peid self = g_tw_mynode;
+  std::size_t pending = 0;
+  std::size_t handled = 0;
+
+  for (const auto &master : ispd::this_model::getMasters()) {
+    const auto slaveCount = master.m_Slaves.size();
+
+    if (slaveCount == 0)
+      continue;
+
+    /// The generate events are always simulated at the master's PE and there
+    /// is at most one of them pending at a time.
+    /// The master handles a generate event and a result for each task.
+    const bool masterIsLocal = ispd::lp_mapping::getPe(master.m_Gid) == self;
+    if (masterIsLocal) {
+      pending++;
+      handled += 2 * static_cast<std::size_t>(master.m_TaskCount);
+    }
+
+    /// As when building the service graph, the tasks are assumed to be
+    /// scheduled evenly among the slaves.
+    const std::size_t tasksPerSlave =
+        (master.m_TaskCount + slaveCount - 1) / slaveCount;
+
+    for (const auto slave : master.m_Slaves) {
+      const auto *route = ispd::routing_table::getRoute(master.m_Gid, slave);
+      std::size_t localHops = 0;
+
+      for (std::size_t i = 0; i < route->getLength(); i++)
+        if (ispd::lp_mapping::getPe(route->get(i)) == self)
+          localHops++;
+
+      /// A task is carried by a single event at a time. Hence, each task whose
+      /// route touches this PE may have at most one pending event here, while
+      /// each local element of its route handles two events (the task and its
+      /// result).
+      if (masterIsLocal || localHops > 0)
+        pending += tasksPerSlave;
+      handled += 2 * tasksPerSlave * localHops;
+    }
+  }
+
+  /// In optimistic runs, the processed events are only released by the fossil
+  /// collection that follows each GVT computation, which happens after at most
+  /// `g_tw_gvt_interval` batches of `g_tw_mblock` events.
+  std::size_t retained = 0;
+  if (g_tw_synchronization_protocol == OPTIMISTIC ||
+      g_tw_synchronization_protocol == OPTIMISTIC_DEBUG ||
+      g_tw_synchronization_protocol == OPTIMISTIC_REALTIME)
+    retained = std::min<std::size_t>(
+        handled, static_cast<std::size_t>(g_tw_gvt_interval) * g_tw_mblock);
+
+  /// A quarter is added as a margin for the rollbacks, the anti-messages and
+  /// the network buffers, and every logical process gets at least a couple
+  /// of events.
+  const std::size_t required = pending + retained;
+  const std::size_t total = std::max<std::size_t>(
+      required + required / 4, 2 * ispd::lp_mapping::getLocalCount() + 64);
+
+  return ispd::memory::EventPoolEstimate{pending, retained, total};
+}
+
+void apply(const ispd::memory::EventPoolEstimate &estimate) {
+  if (estimate.m_Total > std::numeric_limits<unsigned>::max())
+    ispd_error("The estimated event pool (%zu events) is too large.",
+               estimate.m_Total);
+
+  g_tw_events_per_pe = static_cast<unsigned>(estimate.m_Total);
+}
+
+void report(const ispd::memory::EventPoolEstimate &estimate) {
+  /// The pool is made of the events per PE and the extra events requested
+  /// by `--extramem`. If no event has been observed, none has been used.
+  const std::size_t capacity = static_cast<std::size_t>(g_tw_events_per_pe) +
+                               g_tw_events_per_pe_extra;
+  const std::size_t lowestFree = std::min(g_LowestFree, capacity);
+
+  unsigned long local[3] = {estimate.m_Total, capacity - lowestFree,
+                            capacity - lowestFree > estimate.m_Total};
+  unsigned long global[3];
+
+  MPI_Reduce(local, global, 2, MPI_UNSIGNED_LONG, MPI_MAX, 0, MPI_COMM_ROSS);
+  MPI_Reduce(&local[2], &global[2], 1, MPI_UNSIGNED_LONG, MPI_SUM, 0,
+             MPI_COMM_ROSS);
+
+  if (g_tw_mynode == 0)
+    ispd_info("Event pool: largest estimate is %lu events per PE and the "
+              "largest high-water mark is %lu events (%lu PEs have exceeded "
+              "their estimates).",
+              global[0], global[1], global[2]);
+}
+
+}; // namespace ispd::event_pool
@@ -0,0 +1,207 @@
+#include <mpi.h>
+#include <ross.h>
+#include <map>
+#include <vector>
+#include <algorithm>
+#include <ispd/log/log.hpp>
+#include <ispd/model/builder.hpp>
+#include <ispd/metrics/histogram.hpp>
+
+namespace ispd::metrics {
+
+auto LogHistogram::getCount() const noexcept -> std::uint64_t {
+  std::uint64_t count = 0;
+  for (const auto bucketCount : m_Buckets)
+    count += bucketCount;
+  return count;
+}
+
+auto LogHistogram::getBucketUpperBound(const std::size_t bucket) noexcept
+    -> double {
+  if (bucket == 0)
+    return std::ldexp(1.0, MIN_EXPONENT);
+  if (bucket >= BUCKET_COUNT - 1)
+    return HUGE_VAL;
+
+  const int power = static_cast<int>((bucket - 1) / SUB_BUCKETS) + MIN_EXPONENT;
+  const int subBucket = static_cast<int>((bucket - 1) % SUB_BUCKETS);
+
+  return std::ldexp(1.0 + static_cast<double>(subBucket + 1) / SUB_BUCKETS,
+                    power);
+}
+
+auto LogHistogram::getPercentile(const double percentile) const noexcept
+    -> double {
+  const std::uint64_t count = getCount();
+
+  if (count == 0)
+    return 0.0;
+
+  /// The rank of the value at the percentile, counting from one.
+  const auto rank = std::max<std::uint64_t>(
+      1, static_cast<std::uint64_t>(std::ceil(percentile / 100.0 * count)));
+
+  std::uint64_t cumulative = 0;
+  for (std::size_t i = 0; i < BUCKET_COUNT; i++) {
+    cumulative += m_Buckets[i];
+
+    if (cumulative >= rank)
+      return getBucketUpperBound(i);
+  }
+
+  return getBucketUpperBound(BUCKET_COUNT - 1);
+}
+
+}; // namespace ispd::metrics
+
+namespace ispd::task_histograms {
+
+/// \brief The reduced histograms of each user, only kept at the master node.
+static std::map<ispd::model::User::uid_t, ispd::metrics::TaskHistograms>
+    g_GlobalUserHistograms;
+
+/// \brief Returns the histograms of a user, indexed as they are packed.
+static ispd::metrics::LogHistogram *
+getHistogram(ispd::metrics::TaskHistograms &histograms, const std::size_t i) {
+  ispd::metrics::LogHistogram *const packed[] = {
+      &histograms.m_Turnaround,   &histograms.m_MachineWaiting,
+      &histograms.m_LinkWaiting,  &histograms.m_LinkWait,
+      &histograms.m_LinkTransfer, &histograms.m_SwitchTransit,
+      &histograms.m_MachineWait,  &histograms.m_MachineService};
+  return packed[i];
+}
+
+void reduce() {
+  constexpr std::size_t buckets = ispd::metrics::LogHistogram::BUCKET_COUNT;
+  constexpr std::size_t histogramsPerUser = ispd::metrics::TaskHistograms::COUNT;
+
+  /// The users are packed in the order of their identifiers, so that every
+  /// node packs them in the same order.
+  std::vector<ispd::model::User::uid_t> userIds;
+  for (const auto &[id, user] : ispd::this_model::getUsers())
+    userIds.push_back(id);
+  std::sort(userIds.begin(), userIds.end());
+
+  std::vector<std::uint64_t> packed(userIds.size() * histogramsPerUser * buckets);
+  std::uint64_t *position = packed.data();
+
+  for (const auto id : userIds) {
+    auto &histograms = ispd::this_model::getUserById(id).getHistograms();
+
+    for (std::size_t i = 0; i < histogramsPerUser; i++, position += buckets)
+      std::copy_n(getHistogram(histograms, i)->data(), buckets, position);
+  }
+
+  std::vector<std::uint64_t> reduced(g_tw_mynode == 0 ? packed.size() : 0);
+  if (MPI_SUCCESS != MPI_Reduce(packed.data(), reduced.data(),
+                                static_cast<int>(packed.size()), MPI_UINT64_T,
+                                MPI_SUM, 0, MPI_COMM_ROSS))
+    ispd_error("Task histograms could not be reduced, exiting...");
+
+  if (g_tw_mynode)
+    return;
+
+  position = reduced.data();
+  for (const auto id : userIds) {
+    auto &histograms = g_GlobalUserHistograms[id];
+
+    for (std::size_t i = 0; i < histogramsPerUser; i++, position += buckets)
+      std::copy_n(position, buckets, getHistogram(histograms, i)->data());
+  }
+}
+
+/// \brief Reports the percentiles of a histogram.
+static void reportHistogram(const char *name,
+                            const ispd::metrics::LogHistogram &histogram) {
+  ispd_info("  %s (%lu samples): p50 %lf, p90 %lf, p95 %lf, p99 %lf, "
+            "p99.9 %lf seconds.",
+            name, histogram.getCount(), histogram.getPercentile(50.0),
+            histogram.getPercentile(90.0), histogram.getPercentile(95.0),
+            histogram.getPercentile(99.0), histogram.getPercentile(99.9));
+}
+
+/// \brief Reports the percentiles of a user's histograms.
+static void reportHistograms(const ispd::metrics::TaskHistograms &histograms) {
+  reportHistogram("Turnaround Time.....", histograms.m_Turnaround);
+  reportHistogram("Machine Waiting Time", histograms.m_MachineWaiting);
+  reportHistogram("Link Waiting Time...", histograms.m_LinkWaiting);
+
+  ispd_info("  Turnaround Time Breakdown");
+  reportHistogram(" Link Wait..........", histograms.m_LinkWait);
+  reportHistogram(" Link Transfer......", histograms.m_LinkTransfer);
+  reportHistogram(" Switch Transit.....", histograms.m_SwitchTransit);
+  reportHistogram(" Machine Wait.......", histograms.m_MachineWait);
+  reportHistogram(" Machine Service....", histograms.m_MachineService);
+}
+
+/// \brief Returns the global histograms, which are the merge of every user's
+///        reduced histograms.
+static ispd::metrics::TaskHistograms mergeUsers() {
+  ispd::metrics::TaskHistograms global;
+  for (auto &[id, histograms] : g_GlobalUserHistograms)
+    for (std::size_t i = 0; i < ispd::metrics::TaskHistograms::COUNT; i++)
+      getHistogram(global, i)->merge(*getHistogram(histograms, i));
+
+  return global;
+}
+
+void report() {
+  if (g_tw_mynode)
+    return;
+
+  ispd::metrics::TaskHistograms global = mergeUsers();
+
+  ispd_info("Latency Percentiles");
+  ispd_info(" Global");
+  reportHistograms(global);
+
+  for (const auto &[id, histograms] : g_GlobalUserHistograms) {
+    ispd_info(" %s", ispd::this_model::getUserById(id).getName().c_str());
+    reportHistograms(histograms);
+  }
+
+  ispd_info("");
+}
+
+/// \brief The histograms' keys in the run report, indexed as they are packed.
+static constexpr const char *g_HistogramKeys[] = {
+    "turnaround_time", "machine_waiting_time", "link_waiting_time",
+    "link_wait",       "link_transfer",        "switch_transit",
+    "machine_wait",    "machine_service"};
+
+static_assert(std::size(g_HistogramKeys) == ispd::metrics::TaskHistograms::COUNT);
+
+/// \brief Writes the percentiles of a user's histograms to the run report.
+static void writeHistograms(ispd::report::JsonWriter &json,
+                            ispd::metrics::TaskHistograms &histograms) {
+  for (std::size_t i = 0; i < ispd::metrics::TaskHistograms::COUNT; i++) {
+    const auto &histogram = *getHistogram(histograms, i);
+
+    json.beginObject(g_HistogramKeys[i]);
+    json.field("count", histogram.getCount());
+    json.field("p50", histogram.getPercentile(50.0));
+    json.field("p90", histogram.getPercentile(90.0));
+    json.field("p95", histogram.getPercentile(95.0));
+    json.field("p99", histogram.getPercentile(99.0));
+    json.field("p99.9", histogram.getPercentile(99.9));
+    json.endObject();
+  }
+}
+
+void write(ispd::report::JsonWriter &json) {
+  ispd::metrics::TaskHistograms global = mergeUsers();
+
+  json.beginObject("global");
+  writeHistograms(json, global);
+  json.endObject();
+
+  json.beginObject("users");
+  for (auto &[id, histograms] : g_GlobalUserHistograms) {
+    json.beginObject(ispd::this_model::getUserById(id).getName());
+    writeHistograms(json, histograms);
+    json.endObject();
+  }
+  json.endObject();
+}
+
+}; // namespace ispd::task_histograms
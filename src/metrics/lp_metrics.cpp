@@ -0,0 +1,112 @@
+#include <mpi.h>
+#include <ross.h>
+#include <vector>
+#include <cstring>
+#include <algorithm>
+#include <ispd/log/log.hpp>
+#include <ispd/metrics/lp_metrics.hpp>
+
+namespace ispd::lp_metrics {
+
+/// \brief The records of the local logical processes.
+static std::vector<ispd::metrics::LpMetricsRecord> g_Records;
+
+void record(const std::uint64_t gid, const ispd::services::ServiceType type,
+            const std::initializer_list<double> values) {
+  /// Checks if there are more values than columns. If so, the program is
+  /// immediately aborted, since the schema does not describe them.
+  if (values.size() > ispd::metrics::LP_METRICS_COLUMNS)
+    ispd_error("LP %lu has %zu metrics but at most %zu are supported.", gid,
+               values.size(), ispd::metrics::LP_METRICS_COLUMNS);
+
+  ispd::metrics::LpMetricsRecord record;
+  std::memset(&record, 0, sizeof(record));
+  record.m_Gid = gid;
+  record.m_Type = static_cast<std::uint32_t>(type);
+  record.m_ColumnCount = static_cast<std::uint32_t>(values.size());
+  std::copy(values.begin(), values.end(), record.m_Values);
+
+  g_Records.push_back(record);
+}
+
+/// \brief Builds the header describing the schema of the records.
+static auto buildHeader(const std::uint64_t count)
+    -> ispd::metrics::LpMetricsHeader {
+  ispd::metrics::LpMetricsHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.m_Magic, "ISPDLPM", 8);
+  header.m_Version = ispd::metrics::LP_METRICS_VERSION;
+  header.m_RecordSize = sizeof(ispd::metrics::LpMetricsRecord);
+  header.m_Count = count;
+  header.m_TypeCount = ispd::metrics::LP_METRICS_TYPES;
+  header.m_ColumnCount = ispd::metrics::LP_METRICS_COLUMNS;
+
+  for (std::size_t type = 0; type < ispd::metrics::LP_METRICS_TYPES; type++)
+    for (std::size_t column = 0; column < ispd::metrics::LP_METRICS_COLUMNS;
+         column++)
+      if (const char *name = ispd::metrics::g_LpMetricsColumns[type][column])
+        std::strncpy(header.m_Columns[type][column], name,
+                     ispd::metrics::LP_METRICS_COLUMN_NAME - 1);
+
+  return header;
+}
+
+void write(const std::string &filepath) {
+  if (filepath.empty())
+    return;
+
+  /// The records of each rank are placed after the records of the ranks that
+  /// precede it. Therefore, the record offset of each rank is the exclusive
+  /// prefix sum of the record counts.
+  unsigned long count = g_Records.size();
+  unsigned long offset = 0;
+  MPI_Exscan(&count, &offset, 1, MPI_UNSIGNED_LONG, MPI_SUM, MPI_COMM_ROSS);
+
+  /// The exclusive prefix sum is undefined at the first rank.
+  if (g_tw_mynode == 0)
+    offset = 0;
+
+  MPI_File file;
+  if (MPI_SUCCESS != MPI_File_open(MPI_COMM_ROSS, filepath.c_str(),
+                                   MPI_MODE_CREATE | MPI_MODE_WRONLY,
+                                   MPI_INFO_NULL, &file))
+    ispd_error("LP metrics file %s could not be opened.", filepath.c_str());
+
+  /// Truncate any previous contents of the file.
+  MPI_File_set_size(file, 0);
+
+  /// The last rank is the only one that knows the total amount of records
+  /// and, therefore, it writes the header.
+  if (g_tw_mynode == tw_nnodes() - 1) {
+    const auto header = buildHeader(offset + count);
+
+    if (MPI_SUCCESS != MPI_File_write_at(file, 0, &header, sizeof(header),
+                                         MPI_BYTE, MPI_STATUS_IGNORE))
+      ispd_error("LP metrics file %s header could not be written.",
+                 filepath.c_str());
+  }
+
+  MPI_Datatype recordType;
+  MPI_Type_contiguous(sizeof(ispd::metrics::LpMetricsRecord), MPI_BYTE,
+                      &recordType);
+  MPI_Type_commit(&recordType);
+
+  const MPI_Offset position =
+      sizeof(ispd::metrics::LpMetricsHeader) +
+      static_cast<MPI_Offset>(offset) * sizeof(ispd::metrics::LpMetricsRecord);
+
+  if (MPI_SUCCESS != MPI_File_write_at_all(file, position, g_Records.data(),
+                                           static_cast<int>(count), recordType,
+                                           MPI_STATUS_IGNORE))
+    ispd_error("LP metrics file %s records could not be written.",
+               filepath.c_str());
+
+  MPI_Type_free(&recordType);
+  MPI_File_close(&file);
+
+  if (g_tw_mynode == 0)
+    ispd_info("The metrics of each LP have been written to %s.",
+              filepath.c_str());
+}
+
+}; // namespace ispd::lp_metrics
@@ -1,5 +1,7 @@
 #include <mpi.h>
 #include <ross.h>
+#include <vector>
+#include <cstring>
 #include <algorithm>
 #include <ispd/log/log.hpp>
 #include <ispd/metrics/metrics.hpp>
@@ -7,296 +9,197 @@
 
 namespace ispd::metrics {
 
-void NodeMetricsCollector::reportNodeUserMetrics() {
-  /// An alias for the global metrics collector.
-  auto gmc = ispd::global_metrics::g_GlobalMetricsCollector;
-
-  /// Fetch the mapping containing all registered users in the system being simulated.
-  const auto& registeredUsers = ispd::this_model::getUsers();
-
-  /// Report each user metrics.
-  for (const auto& [id, user] : registeredUsers) {
-    const auto& metrics = user.getMetrics();
-
-    #define REDUCE_USER_METRIC(op, type, field, fieldName) \
-      if (MPI_SUCCESS != MPI_Reduce(&metrics.field, &gmc->m_GlobalUserMetrics[id].field, 1, type, op, 0, MPI_COMM_ROSS)) \
-          ispd_error("User (%u, %s) %s could not be reduced, exiting...", id, user.getName().c_str(), fieldName);
-
-    REDUCE_USER_METRIC(MPI_SUM, MPI_DOUBLE, m_ProcTime, "processing time");
-    REDUCE_USER_METRIC(MPI_SUM, MPI_DOUBLE, m_ProcWaitingTime, "processing waiting time");
-    REDUCE_USER_METRIC(MPI_SUM, MPI_DOUBLE, m_CommTime, "communication time");
-    REDUCE_USER_METRIC(MPI_SUM, MPI_DOUBLE, m_CommWaitingTime, "communication waiting time");
-    REDUCE_USER_METRIC(MPI_SUM, MPI_DOUBLE, m_EnergyConsumption, "energy consumption");
-    REDUCE_USER_METRIC(MPI_SUM, MPI_UNSIGNED, m_IssuedTasks, "issued tasks");
-    REDUCE_USER_METRIC(MPI_SUM, MPI_UNSIGNED, m_CompletedTasks, "completed tasks");
-
-    #undef REDUCE_USER_METRIC
+namespace {
+/// \brief How a packed word is reduced among the nodes.
+enum class PackedReduction : std::uint8_t {
+  SUM_DOUBLE, ///< The word holds a double that is summed up.
+  MAX_DOUBLE, ///< The word holds a double whose maximum is kept.
+  SUM_COUNTER ///< The word holds an unsigned integer that is summed up.
+};
+
+/// \brief The reduction of each word of the packed metrics.
+///
+/// \note Every node builds the same layout, since every node simulates the same
+///       model and, therefore, has the same registered users.
+std::vector<PackedReduction> g_PackedLayout;
+
+/// \brief The amount of fields of a user's metrics that are packed.
+constexpr std::size_t USER_METRICS_WORDS = 7;
+
+/// \brief Reduces two packed metrics buffers, word by word, following the packed layout.
+///
+/// The packed buffer is described by a contiguous datatype with one word per metric.
+/// Therefore, each element handled by this reduction operation is a whole buffer.
+void reducePackedMetrics(void *in, void *inout, int *len, MPI_Datatype *datatype) {
+  const auto *src = static_cast<const std::uint64_t *>(in);
+  auto *dst = static_cast<std::uint64_t *>(inout);
+  const std::size_t words = g_PackedLayout.size();
+
+  for (int element = 0; element < *len; element++, src += words, dst += words) {
+    for (std::size_t i = 0; i < words; i++) {
+      switch (g_PackedLayout[i]) {
+      case PackedReduction::SUM_COUNTER:
+        dst[i] += src[i];
+        break;
+      case PackedReduction::SUM_DOUBLE:
+      case PackedReduction::MAX_DOUBLE: {
+        double lhs, rhs;
+        std::memcpy(&lhs, &src[i], sizeof(double));
+        std::memcpy(&rhs, &dst[i], sizeof(double));
+
+        const double result = g_PackedLayout[i] == PackedReduction::SUM_DOUBLE
+                                  ? lhs + rhs
+                                  : std::max(lhs, rhs);
+        std::memcpy(&dst[i], &result, sizeof(double));
+        break;
+      }
+      }
+    }
   }
 }
 
-template <>
-void NodeMetricsCollector::notifyMetric(const NodeMetricsFlag flag, const double value) {
-  switch (flag) {
-    case NodeMetricsFlag::NODE_TOTAL_PROCESSED_MFLOPS:
-      /// Updates total processed MFLOPS.
-      m_NodeTotalProcessedMFlops += value;
-      break;
-    case NodeMetricsFlag::NODE_TOTAL_COMMUNICATED_MBITS:
-      /// Updates total communicated MBits.
-      m_NodeTotalCommunicatedMBits += value;
-      break;
-    case NodeMetricsFlag::NODE_TOTAL_PROCESSING_WAITING_TIME:
-      /// Updates total processing waiting time.
-      m_NodeTotalProcessingWaitingTime += value;
-      break;
-    case NodeMetricsFlag::NODE_TOTAL_COMMUNICATION_WAITING_TIME:
-      /// Updates total communication waiting time.
-      m_NodeTotalCommunicationWaitingTime += value;
-      break;
-    case NodeMetricsFlag::NODE_TOTAL_COMPUTATIONAL_POWER:
-      /// Updates total computational power.
-      m_NodeTotalComputationalPower += value;
-    case NodeMetricsFlag::NODE_TOTAL_PROCESSING_TIME:
-      /// Updates total processing time.
-      m_NodeTotalProcessingTime += value;
-      break;
-     case NodeMetricsFlag::NODE_TOTAL_COMMUNICATION_TIME:
-      /// Updates total communication time.
-      m_NodeTotalCommunicationTime += value;
-      break;
-    case NodeMetricsFlag::NODE_TOTAL_TURNAROUND_TIME:
-      /// Updates total turnaround time.
-      m_NodeTotalTurnaroundTime += value;
-      break;
-    case NodeMetricsFlag::NODE_TOTAL_NON_IDLE_ENERGY_CONSUMPTION:
-      /// Updates the total energy consumption.
-      m_NodeTotalNonIdleEnergyConsumption += value;
-      break;
-    case NodeMetricsFlag::NODE_TOTAL_POWER_IDLE:
-      /// Updates the total power idle.
-      m_NodeTotalPowerIdle += value;
-      break;
-    case NodeMetricsFlag::NODE_SIMULATION_TIME:
-      /// Updates simulation time.
-      m_NodeSimulationTime = std::max(m_NodeSimulationTime, value);
-      break;
-#ifdef DEBUG_ON
-    case NodeMetricsFlag::NODE_MASTER_FORWARD_TIME:
-      /// Updates the total forward time and forward events count by the master.
-      m_NodeTotalForwardTime[ispd::services::ServiceType::MASTER] += value;
-      m_NodeTotalForwardEventsCount[ispd::services::ServiceType::MASTER]++;
-      break;
-    case NodeMetricsFlag::NODE_MASTER_REVERSE_TIME:
-      /// Updates the total reverse time and reverse events count by the master.
-      m_NodeTotalReverseTime[ispd::services::ServiceType::MASTER] += value;
-      m_NodeTotalReverseEventsCount[ispd::services::ServiceType::MASTER]++;
-      break;
-    case NodeMetricsFlag::NODE_LINK_FORWARD_TIME:
-      /// Updates the total forward time and forward events count by the link.
-      m_NodeTotalForwardTime[ispd::services::ServiceType::LINK] += value;
-      m_NodeTotalForwardEventsCount[ispd::services::ServiceType::LINK]++;
-      break;
-    case NodeMetricsFlag::NODE_LINK_REVERSE_TIME:
-      /// Updates the total reverse time and reverse events count by the link.
-      m_NodeTotalReverseTime[ispd::services::ServiceType::LINK] += value;
-      m_NodeTotalReverseEventsCount[ispd::services::ServiceType::LINK]++;
-      break;
-    case NodeMetricsFlag::NODE_MACHINE_FORWARD_TIME:
-      /// Updates the total forward time and forward events count by the machine.
-      m_NodeTotalForwardTime[ispd::services::ServiceType::MACHINE] += value;
-      m_NodeTotalForwardEventsCount[ispd::services::ServiceType::MACHINE]++;
-      break;
-    case NodeMetricsFlag::NODE_MACHINE_REVERSE_TIME:
-      /// Updates the total reverse time and reverse events count by the machine.
-      m_NodeTotalReverseTime[ispd::services::ServiceType::MACHINE] += value;
-      m_NodeTotalReverseEventsCount[ispd::services::ServiceType::MACHINE]++;
-      break;
-    case NodeMetricsFlag::NODE_SWITCH_FORWARD_TIME:
-      /// Updates the total forward time and forward events count by the switch.
-      m_NodeTotalForwardTime[ispd::services::ServiceType::SWITCH] += value;
-      m_NodeTotalForwardEventsCount[ispd::services::ServiceType::SWITCH]++;
-      break;
-    case NodeMetricsFlag::NODE_SWITCH_REVERSE_TIME:
-      /// Updates the total reverse time and reverse events count by the master.
-      m_NodeTotalReverseTime[ispd::services::ServiceType::SWITCH] += value;
-      m_NodeTotalReverseEventsCount[ispd::services::ServiceType::SWITCH]++;
-      break;
-#endif // DEBUG_ON
-    default:
-      ispd_error("Unknown node metrics flag (%d) or incorrect argument type.", flag);
-  }
+/// \brief Appends a double to the packed buffer.
+void packDouble(std::vector<std::uint64_t> &buffer, const double value,
+                const PackedReduction reduction) {
+  std::uint64_t word;
+  std::memcpy(&word, &value, sizeof(double));
+  buffer.push_back(word);
+  g_PackedLayout.push_back(reduction);
 }
 
-template <>
-void NodeMetricsCollector::notifyMetric(const enum NodeMetricsFlag flag, const unsigned value) {
-  switch (flag) {
-    case NodeMetricsFlag::NODE_TOTAL_COMPLETED_TASKS:
-      /// Updates total completed tasks.
-      m_NodeTotalCompletedTasks += value;
-      break;
-    case NodeMetricsFlag::NODE_TOTAL_CPU_CORES:
-      /// Updates the total CPU cores.
-      m_NodeTotalCpuCores += value;
-      break;
-    case NodeMetricsFlag::NODE_TOTAL_GPU_CORES:
-      /// Updates the total GPU cores.
-      m_NodeTotalGpuCores += value;
-      break;
-    default:
-      ispd_error("Unknown node metrics flag (%d) or it may be the case the flag is correct but the argument is not of the required type.", flag);
-  }
+/// \brief Appends an unsigned integer to the packed buffer.
+void packCounter(std::vector<std::uint64_t> &buffer, const std::uint64_t value) {
+  buffer.push_back(value);
+  g_PackedLayout.push_back(PackedReduction::SUM_COUNTER);
 }
 
-void NodeMetricsCollector::notifyMetric(const enum NodeMetricsFlag flag) {
-  switch (flag) {
-     case NodeMetricsFlag::NODE_TOTAL_MASTER_SERVICES:
-      /// Updates the count of master services.
-      m_NodeTotalMasterServices++;
-      break;
-     case NodeMetricsFlag::NODE_TOTAL_LINK_SERVICES:
-      /// Updates the count of link services.
-      m_NodeTotalLinkServices++;
-      break;
-     case NodeMetricsFlag::NODE_TOTAL_MACHINE_SERVICES:
-      /// Updates the count of machine services.
-      m_NodeTotalMachineServices++;
-      break;
-     case NodeMetricsFlag::NODE_TOTAL_SWITCH_SERVICES:
-      /// Updates the count of switch services.
-      m_NodeTotalSwitchServices++;
-      break;
-    default:
-      ispd_error("Unknown node metrics flag (%d) or it may be the case the flag is correct but the argument is not of the required type.", flag);
-    }
+/// \brief Reads a double from the packed buffer.
+double unpackDouble(const std::uint64_t *&word) {
+  double value;
+  std::memcpy(&value, word++, sizeof(double));
+  return value;
 }
+}; // namespace
 
 void NodeMetricsCollector::reportNodeMetrics() {
   /// An alias for the global metrics collector.
   auto gmc = ispd::global_metrics::g_GlobalMetricsCollector;
 
-  /// Report to the master node the simulation time of this node.
-  if (MPI_SUCCESS != MPI_Reduce(&m_NodeSimulationTime, &gmc->m_GlobalSimulationTime, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_ROSS))
-    ispd_error("Global simulation time could not be reduced, exiting...");
-
-  /// Report to the master node the processed MFlops of this node.
-  if (MPI_SUCCESS != MPI_Reduce(&m_NodeTotalProcessedMFlops, &gmc->m_GlobalTotalProcessedMFlops, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_ROSS))
-    ispd_error("Global total processed mflops could not be reduced, exiting...");
-
-  /// Report to the master node the processed MFlops of this node.
-  if (MPI_SUCCESS != MPI_Reduce(&m_NodeTotalCommunicatedMBits, &gmc->m_GlobalTotalCommunicatedMBits, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_ROSS))
-    ispd_error("Global total communicated mbits could not be reduced, exiting...");
-
-  /// Report to the master node the total processing waiting time.
-  if (MPI_SUCCESS != MPI_Reduce(&m_NodeTotalProcessingWaitingTime, &gmc->m_GlobalTotalProcessingWaitingTime, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_ROSS))
-    ispd_error("Global total processing waiting time could not be reduced, exiting...");
-
-  /// Report to the master node the total communication waiting time.
-  if (MPI_SUCCESS != MPI_Reduce(&m_NodeTotalCommunicationWaitingTime, &gmc->m_GlobalTotalCommunicationWaitingTime, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_ROSS))
-    ispd_error("Global total communication waiting time could not be reduced, exiting...");
-
-  /// Report to the master node the total master services count.
-  if (MPI_SUCCESS != MPI_Reduce(&m_NodeTotalMasterServices, &gmc->m_GlobalTotalMasterServices, 1, MPI_UNSIGNED, MPI_SUM, 0, MPI_COMM_ROSS))
-    ispd_error("Global total master services could not be reduced, exiting...");
- 
-  /// Report to the master node the total link services count.
-  if (MPI_SUCCESS != MPI_Reduce(&m_NodeTotalLinkServices, &gmc->m_GlobalTotalLinkServices, 1, MPI_UNSIGNED, MPI_SUM, 0, MPI_COMM_ROSS))
-    ispd_error("Global total link services could not be reduced, exiting...");
- 
-  /// Report to the master node the total machine services count.
-  if (MPI_SUCCESS != MPI_Reduce(&m_NodeTotalMachineServices, &gmc->m_GlobalTotalMachineServices, 1, MPI_UNSIGNED, MPI_SUM, 0, MPI_COMM_ROSS))
-    ispd_error("Global total machine services could not be reduced, exiting...");
- 
-  /// Report to the master node the total switch services count.
-  if (MPI_SUCCESS != MPI_Reduce(&m_NodeTotalSwitchServices, &gmc->m_GlobalTotalSwitchServices, 1, MPI_UNSIGNED, MPI_SUM, 0, MPI_COMM_ROSS))
-    ispd_error("Global total switch services could not be reduced, exiting...");
- 
-  /// Report to the master node the total completed tasks.
-  if (MPI_SUCCESS != MPI_Reduce(&m_NodeTotalCompletedTasks, &gmc->m_GlobalTotalCompletedTasks, 1, MPI_UNSIGNED, MPI_SUM, 0, MPI_COMM_ROSS))
-    ispd_error("Global total completed tasks could not be reduced, exiting...");
-
-  /// Report to the master node the total computational power.
-  if (MPI_SUCCESS != MPI_Reduce(&m_NodeTotalComputationalPower, &gmc->m_GlobalTotalComputationalPower, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_ROSS))
-    ispd_error("Global total computational power could not be reduced, exiting...");
-
-  /// Report to the master node the total CPU cores.
-  if (MPI_SUCCESS != MPI_Reduce(&m_NodeTotalCpuCores, &gmc->m_GlobalTotalCpuCores, 1, MPI_UNSIGNED, MPI_SUM, 0, MPI_COMM_ROSS))
-    ispd_error("Global total cpu cores could not be reduced, exiting...");
-
-  /// Report to the master node the total GPU cores.
-  if (MPI_SUCCESS != MPI_Reduce(&m_NodeTotalGpuCores, &gmc->m_GlobalTotalGpuCores, 1, MPI_UNSIGNED, MPI_SUM, 0, MPI_COMM_ROSS))
-    ispd_error("Global total gpu cores could not be reduced, exiting...");
-
-
-  /// Report to the master node the processing time.
-  if (MPI_SUCCESS != MPI_Reduce(&m_NodeTotalProcessingTime, &gmc->m_GlobalTotalProcessingTime, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_ROSS))
-    ispd_error("Global total processing time could not be reduced, exiting...");
-
-  /// Report to the master node the communication size.
-  if (MPI_SUCCESS != MPI_Reduce(&m_NodeTotalCommunicationTime, &gmc->m_GlobalTotalCommunicationTime, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_ROSS))
-    ispd_error("Global total communication time could not be reduced, exiting...");
-
-  /// Report to the master node the turnaround time.
-  if (MPI_SUCCESS != MPI_Reduce(&m_NodeTotalTurnaroundTime, &gmc->m_GlobalTotalTurnaroundTime, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_ROSS))
-    ispd_error("Global total turnaround time could not be reduced, exiting...");
-  
-  /// Report to the master node the energy consumption.
-  if (MPI_SUCCESS != MPI_Reduce(&m_NodeTotalNonIdleEnergyConsumption, &gmc->m_GlobalTotalNonIdleEnergyConsumption, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_ROSS))
-    ispd_error("Global total energy consumption could not be reduced, exiting...");
-
-  /// Report to the master node the power idle.
-  if (MPI_SUCCESS != MPI_Reduce(&m_NodeTotalPowerIdle, &gmc->m_GlobalTotalPowerIdle, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_ROSS))
-    ispd_error("Global total power idle could not be reduced, exiting...");
-
-#ifdef DEBUG_ON
-  for (const auto& serviceType : ispd::services::g_ServiceTypes) {
-    /// Report to the master node the forward processing time.
-    if (MPI_SUCCESS != MPI_Reduce(&m_NodeTotalForwardTime[serviceType],
-                                  &gmc->m_GlobalTotalForwardTime[serviceType],
-                                  1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_ROSS))
-      ispd_error("Global total %s forward time could not be reduced, exiting...",
-         ispd::services::getServiceTypeName(serviceType));
-
-    /// Report to the master node the forward events count.
-    if (MPI_SUCCESS != MPI_Reduce(&m_NodeTotalForwardEventsCount[serviceType],
-                                  &gmc->m_GlobalTotalForwardEventsCount[serviceType],
-                                  1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_ROSS))
-      ispd_error("Global total %s forward events count could not be reduced, exiting...",
-          ispd::services::getServiceTypeName(serviceType));
-
-    /// Report to the master node the reverse processing time.
-    if (MPI_SUCCESS != MPI_Reduce(&m_NodeTotalReverseTime[serviceType],
-                                  &gmc->m_GlobalTotalReverseTime[serviceType],
-                                  1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_ROSS))
-      ispd_error("Global total %s reverse time could not be reduced, exiting...",
-          ispd::services::getServiceTypeName(serviceType));
-
-    /// Report to the master node the reverse events count.
-    if (MPI_SUCCESS != MPI_Reduce(&m_NodeTotalReverseEventsCount[serviceType],
-                                  &gmc->m_GlobalTotalReverseEventsCount[serviceType],
-                                  1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_ROSS))
-      ispd_error("Global total %s reverse events count could not be reduced, exiting...",
-          ispd::services::getServiceTypeName(serviceType));
+  /// Fetch the mapping containing all registered users in the system being simulated.
+  const auto& registeredUsers = ispd::this_model::getUsers();
+
+  /// The users are packed in the order of their identifiers, so that every node
+  /// packs them in the same order.
+  std::vector<ispd::model::User::uid_t> userIds;
+  userIds.reserve(registeredUsers.size());
+  for (const auto& [id, user] : registeredUsers)
+    userIds.push_back(id);
+  std::sort(userIds.begin(), userIds.end());
+
+  std::vector<std::uint64_t> packed;
+  packed.reserve(g_NodeMetricsDoubleCount + g_NodeMetricsCounterCount + USER_METRICS_WORDS * userIds.size());
+  g_PackedLayout.clear();
+
+  /// Pack the node-level metrics. The doubles array is followed by the counters array.
+  for (std::size_t i = 0; i < g_NodeMetricsCount; i++) {
+    const auto kind = g_NodeMetricsKinds[i];
+
+    if (hasDoubleSlot(kind))
+      packDouble(packed, m_Doubles[getDoubleSlot(static_cast<NodeMetricsFlag>(i))],
+                 kind == MetricKind::MAX ? PackedReduction::MAX_DOUBLE : PackedReduction::SUM_DOUBLE);
   }
-#endif // DEBUG_ON
 
-  reportNodeUserMetrics();
-}
+  for (const auto counter : m_Counters)
+    packCounter(packed, counter);
 
-void GlobalMetricsCollector::reportGlobalMetrics() {
-  /// Check if the current node is not the master one. If so, the global metrics will
-  /// not be reported, since only the master node will report the global metrics.
+  /// Pack each user's metrics.
+  for (const auto id : userIds) {
+    const auto& metrics = ispd::this_model::getUserById(id).getMetrics();
+
+    packDouble(packed, metrics.m_ProcTime, PackedReduction::SUM_DOUBLE);
+    packDouble(packed, metrics.m_ProcWaitingTime, PackedReduction::SUM_DOUBLE);
+    packDouble(packed, metrics.m_CommTime, PackedReduction::SUM_DOUBLE);
+    packDouble(packed, metrics.m_CommWaitingTime, PackedReduction::SUM_DOUBLE);
+    packDouble(packed, metrics.m_EnergyConsumption, PackedReduction::SUM_DOUBLE);
+    packCounter(packed, metrics.m_IssuedTasks);
+    packCounter(packed, metrics.m_CompletedTasks);
+  }
+
+  /// The whole packed buffer is a single element of a contiguous datatype, so that
+  /// the custom reduction operation sees the entire buffer at once.
+  MPI_Datatype packedType;
+  MPI_Op packedOp;
+  MPI_Type_contiguous(static_cast<int>(packed.size()), MPI_UINT64_T, &packedType);
+  MPI_Type_commit(&packedType);
+  MPI_Op_create(reducePackedMetrics, 1, &packedOp);
+
+  std::vector<std::uint64_t> reduced(packed.size());
+  if (MPI_SUCCESS != MPI_Reduce(packed.data(), reduced.data(), 1, packedType, packedOp, 0, MPI_COMM_ROSS))
+    ispd_error("Node metrics could not be reduced, exiting...");
+
+  MPI_Op_free(&packedOp);
+  MPI_Type_free(&packedType);
+
+  /// Only the master node has the reduced metrics.
   if (g_tw_mynode)
     return;
 
-  const double avgProcessingTime = m_GlobalTotalProcessingTime / m_GlobalTotalCompletedTasks;
-  const double avgProcessingWaitingTime = m_GlobalTotalProcessingWaitingTime / m_GlobalTotalCompletedTasks;
-  const double avgCommunicationTime = m_GlobalTotalCommunicationTime / m_GlobalTotalCompletedTasks;
-  const double avgCommunicationWaitingTime = m_GlobalTotalCommunicationWaitingTime / m_GlobalTotalCompletedTasks;
-  const double avgTotalTurnaroundTime = m_GlobalTotalTurnaroundTime / m_GlobalTotalCompletedTasks;
-  const double maxComputationalPower = m_GlobalTotalProcessedMFlops / m_GlobalSimulationTime;
+  /// Unpack the global metrics in the same order they have been packed.
+  const std::uint64_t *word = reduced.data();
+
+  for (auto &value : gmc->m_Doubles)
+    value = unpackDouble(word);
+
+  for (auto &counter : gmc->m_Counters)
+    counter = *word++;
+
+  for (const auto id : userIds) {
+    auto& metrics = gmc->m_GlobalUserMetrics[id];
+
+    metrics.m_ProcTime = unpackDouble(word);
+    metrics.m_ProcWaitingTime = unpackDouble(word);
+    metrics.m_CommTime = unpackDouble(word);
+    metrics.m_CommWaitingTime = unpackDouble(word);
+    metrics.m_EnergyConsumption = unpackDouble(word);
+    metrics.m_IssuedTasks = static_cast<unsigned>(*word++);
+    metrics.m_CompletedTasks = static_cast<unsigned>(*word++);
+  }
+}
+
+auto GlobalMetricsCollector::summarize() const -> GlobalMetricsSummary {
+  using Flag = NodeMetricsFlag;
+  GlobalMetricsSummary summary;
+
+  /// Fetch the global metrics from the registry.
+  summary.m_SimulationTime = getValue<Flag::NODE_SIMULATION_TIME>();
+  summary.m_TotalProcessedMFlops = getValue<Flag::NODE_TOTAL_PROCESSED_MFLOPS>();
+  summary.m_TotalCommunicatedMBits = getValue<Flag::NODE_TOTAL_COMMUNICATED_MBITS>();
+  summary.m_TotalProcessingTime = getValue<Flag::NODE_TOTAL_PROCESSING_TIME>();
+  summary.m_TotalProcessingWaitingTime = getValue<Flag::NODE_TOTAL_PROCESSING_WAITING_TIME>();
+  summary.m_TotalCommunicationTime = getValue<Flag::NODE_TOTAL_COMMUNICATION_TIME>();
+  summary.m_TotalCommunicationWaitingTime = getValue<Flag::NODE_TOTAL_COMMUNICATION_WAITING_TIME>();
+  summary.m_TotalTurnaroundTime = getValue<Flag::NODE_TOTAL_TURNAROUND_TIME>();
+  summary.m_TotalComputationalPower = getValue<Flag::NODE_TOTAL_COMPUTATIONAL_POWER>();
+  summary.m_TotalNonIdleEnergyConsumption = getValue<Flag::NODE_TOTAL_NON_IDLE_ENERGY_CONSUMPTION>();
+  summary.m_TotalPowerIdle = getValue<Flag::NODE_TOTAL_POWER_IDLE>();
+  summary.m_TotalMasterServices = getCount<Flag::NODE_TOTAL_MASTER_SERVICES>();
+  summary.m_TotalLinkServices = getCount<Flag::NODE_TOTAL_LINK_SERVICES>();
+  summary.m_TotalMachineServices = getCount<Flag::NODE_TOTAL_MACHINE_SERVICES>();
+  summary.m_TotalSwitchServices = getCount<Flag::NODE_TOTAL_SWITCH_SERVICES>();
+  summary.m_TotalCompletedTasks = getCount<Flag::NODE_TOTAL_COMPLETED_TASKS>();
+  summary.m_TotalCpuCores = getCount<Flag::NODE_TOTAL_CPU_CORES>();
+  summary.m_TotalGpuCores = getCount<Flag::NODE_TOTAL_GPU_CORES>();
+
+  const double completedTasks = static_cast<double>(summary.m_TotalCompletedTasks);
+  summary.m_AvgProcessingTime = summary.m_TotalProcessingTime / completedTasks;
+  summary.m_AvgProcessingWaitingTime = summary.m_TotalProcessingWaitingTime / completedTasks;
+  summary.m_AvgCommunicationTime = summary.m_TotalCommunicationTime / completedTasks;
+  summary.m_AvgCommunicationWaitingTime = summary.m_TotalCommunicationWaitingTime / completedTasks;
+  summary.m_AvgTurnaroundTime = summary.m_TotalTurnaroundTime / completedTasks;
+  summary.m_MaxComputationalPower = summary.m_TotalProcessedMFlops / summary.m_SimulationTime;
 
   /// The efficiency is calculated as: Rmax / Rpeak
-  const double efficiency = maxComputationalPower / m_GlobalTotalComputationalPower;
+  summary.m_Efficiency = summary.m_MaxComputationalPower / summary.m_TotalComputationalPower;
 
   /// The total energy consumption is divided into two main components: dynamic (D) and
   /// static (S) energy consumption. The dynamic energy consumption refers to the energy
@@ -307,49 +210,60 @@ void GlobalMetricsCollector::reportGlobalMetrics() {
   /// \note The dynamic energy consumption is typically influenced by factors such as
   /// processing load, activity patterns, and utilization. The static energy consumption
   /// often includes power used by components in standby, sleep, or other low-power modes.
-  const double totalEnergyConsumption = m_GlobalTotalNonIdleEnergyConsumption +
-    m_GlobalTotalPowerIdle * m_GlobalSimulationTime;
+  summary.m_TotalEnergyConsumption = summary.m_TotalNonIdleEnergyConsumption +
+    summary.m_TotalPowerIdle * summary.m_SimulationTime;
 
   /// Calculates the system average power and the system's energy efficiency.
-  const double avgPower = totalEnergyConsumption / m_GlobalSimulationTime;
-  const double energyEfficiency = maxComputationalPower / avgPower;
+  summary.m_AvgPower = summary.m_TotalEnergyConsumption / summary.m_SimulationTime;
+  summary.m_EnergyEfficiency = summary.m_MaxComputationalPower / summary.m_AvgPower;
+
+  return summary;
+}
+
+void GlobalMetricsCollector::reportGlobalMetrics() {
+  /// Check if the current node is not the master one. If so, the global metrics will
+  /// not be reported, since only the master node will report the global metrics.
+  if (g_tw_mynode)
+    return;
+
+  const GlobalMetricsSummary summary = summarize();
 
   ispd_info("");
-  ispd_info("Global Simulation Time...........: %lf seconds.", m_GlobalSimulationTime);
+  ispd_info("Global Simulation Time...........: %lf seconds.", summary.m_SimulationTime);
   ispd_info("");
   ispd_info("Total Metrics");
-  ispd_info(" Total Processed MFLOPS..........: %lf MFLOPS.", m_GlobalTotalProcessedMFlops);
-  ispd_info(" Total Communicated MBits........: %lf MBits.", m_GlobalTotalCommunicatedMBits);
-  ispd_info(" Total Processing Waiting Time...: %lf seconds.", m_GlobalTotalProcessingWaitingTime);
-  ispd_info(" Total Communication Waiting Time: %lf seconds.", m_GlobalTotalCommunicationWaitingTime);
-  ispd_info(" Total Master Services...........: %u services.", m_GlobalTotalMasterServices);
-  ispd_info(" Total Link Services.............: %u services.", m_GlobalTotalLinkServices);
-  ispd_info(" Total Machine Services..........: %u services.", m_GlobalTotalMachineServices);
-  ispd_info(" Total Switch Services...........: %u services.", m_GlobalTotalSwitchServices);
-  ispd_info(" Total Completed Tasks...........: %u tasks.", m_GlobalTotalCompletedTasks);
+  ispd_info(" Total Processed MFLOPS..........: %lf MFLOPS.", summary.m_TotalProcessedMFlops);
+  ispd_info(" Total Communicated MBits........: %lf MBits.", summary.m_TotalCommunicatedMBits);
+  ispd_info(" Total Processing Waiting Time...: %lf seconds.", summary.m_TotalProcessingWaitingTime);
+  ispd_info(" Total Communication Waiting Time: %lf seconds.", summary.m_TotalCommunicationWaitingTime);
+  ispd_info(" Total Master Services...........: %lu services.", summary.m_TotalMasterServices);
+  ispd_info(" Total Link Services.............: %lu services.", summary.m_TotalLinkServices);
+  ispd_info(" Total Machine Services..........: %lu services.", summary.m_TotalMachineServices);
+  ispd_info(" Total Switch Services...........: %lu services.", summary.m_TotalSwitchServices);
+  ispd_info(" Total Completed Tasks...........: %lu tasks.", summary.m_TotalCompletedTasks);
   ispd_info("");
   ispd_info("Average Metrics");
-  ispd_info(" Avg. Processing Time............: %lf seconds.", avgProcessingTime);
-  ispd_info(" Avg. Processing Waiting Time....: %lf seconds.", avgProcessingWaitingTime);
-  ispd_info(" Avg. Communication Time.........: %lf seconds.", avgCommunicationTime);
-  ispd_info(" Avg. Communication Waiting Time.: %lf seconds.", avgCommunicationWaitingTime);
-  ispd_info(" Avg. Turnaround Time............: %lf seconds.", avgTotalTurnaroundTime);
+  ispd_info(" Avg. Processing Time............: %lf seconds.", summary.m_AvgProcessingTime);
+  ispd_info(" Avg. Processing Waiting Time....: %lf seconds.", summary.m_AvgProcessingWaitingTime);
+  ispd_info(" Avg. Communication Time.........: %lf seconds.", summary.m_AvgCommunicationTime);
+  ispd_info(" Avg. Communication Waiting Time.: %lf seconds.", summary.m_AvgCommunicationWaitingTime);
+  ispd_info(" Avg. Turnaround Time............: %lf seconds.", summary.m_AvgTurnaroundTime);
   ispd_info("");
   ispd_info("System Metrics");
   ispd_info("");
   ispd_info(" Processing-related metrics");
-  ispd_info("  Peak Computational Power........: %lf MFLOPS.", m_GlobalTotalComputationalPower);
-  ispd_info("  Max. Computational Power........: %lf MFLOPS.", maxComputationalPower);
-  ispd_info("  Efficiency......................: %lf%%.", efficiency * 100.0);
+  ispd_info("  Peak Computational Power........: %lf MFLOPS.", summary.m_TotalComputationalPower);
+  ispd_info("  Max. Computational Power........: %lf MFLOPS.", summary.m_MaxComputationalPower);
+  ispd_info("  Efficiency......................: %lf%%.", summary.m_Efficiency * 100.0);
   ispd_info("");
   ispd_info(" Energy-related metrics");
-  ispd_info("  Energy Consumption..............: %lf J.", totalEnergyConsumption);
-  ispd_info("  Energy Efficiency...............: %lf MFLOPS/W.", energyEfficiency);
-  ispd_info("  Avg. Power......................: %lf W.", avgPower);
-  ispd_info("  Idle Power......................: %lf W.", m_GlobalTotalPowerIdle);
+  ispd_info("  Energy Consumption..............: %lf J.", summary.m_TotalEnergyConsumption);
+  ispd_info("  Energy Efficiency...............: %lf MFLOPS/W.", summary.m_EnergyEfficiency);
+  ispd_info("  Avg. Power......................: %lf W.", summary.m_AvgPower);
+  ispd_info("  Idle Power......................: %lf W.", summary.m_TotalPowerIdle);
   ispd_info("");
-  ispd_info(" Total CPU Cores.................: %u cores.", m_GlobalTotalCpuCores);
-  ispd_info(" Total GPU Cores.................: %u cores.", m_GlobalTotalGpuCores);
+  ispd_info(" Total CPU Cores.................: %lu cores.", summary.m_TotalCpuCores);
+  ispd_info(" Total GPU Cores.................: %lu cores.", summary.m_TotalGpuCores);
   ispd_info("");
   ispd_info("User Metrics");
   
@@ -372,37 +286,65 @@ void GlobalMetricsCollector::reportGlobalMetrics() {
   }
 
   ispd_info("");
-#ifdef DEBUG_ON
-  ispd_info("Service Center Metrics");
-  
-  /// Calculate the average time taken for forward and reverse processing and, print the information
-  /// about the average time of forward and reverse processing as well as the forward and reverse event count.
-  for (const auto& serviceType : ispd::services::g_ServiceTypes) {
-    /// Fetches the forward and reverse processing time (in nanoseconds) of the service center type.
-    const double totalForwardTime = m_GlobalTotalForwardTime[serviceType];
-    const double totalReverseTime = m_GlobalTotalReverseTime[serviceType];
-    
-    /// Fetches the forward and reverse events processed of the service center type.
-    const uint64_t forwardEventsCount = m_GlobalTotalForwardEventsCount[serviceType];
-    const uint64_t reverseEventsCount = m_GlobalTotalReverseEventsCount[serviceType];   
-
-    /// Calculates the average time taken (in nanoseconds) to forward and reverse processing.
-    const double avgForwardTime = totalForwardTime / forwardEventsCount;
-    const double avgReverseTime = totalReverseTime / reverseEventsCount;
-    
-    /// Calculates how many times the reverse processing is faster than the forward processing at average.
-    const double forwardAndReverseRelation = avgForwardTime / avgReverseTime;
-    
-    const char *capitalizedServiceTypeName = ispd::services::getServiceTypeName<true>(serviceType);
-    
-    ispd_info(" Avg. %s Forward Time........: %lf ns.", capitalizedServiceTypeName, avgForwardTime);
-    ispd_info(" Avg. %s Reverse Time........: %lf ns.", capitalizedServiceTypeName, avgReverseTime);
-    ispd_info(" %s Forward Events Count.....: %lu events.", capitalizedServiceTypeName, forwardEventsCount);
-    ispd_info(" %s Reverse Events Count.....: %lu events.", capitalizedServiceTypeName, reverseEventsCount);
-    ispd_info(" Avg. Forward/Reverse........: %lfx.", capitalizedServiceTypeName, forwardAndReverseRelation);
-    ispd_info("");   
+}
+
+void GlobalMetricsCollector::writeGlobalMetrics(ispd::report::JsonWriter &json) const {
+  const GlobalMetricsSummary summary = summarize();
+
+  json.beginObject("metrics");
+  json.field("simulation_time", summary.m_SimulationTime);
+
+  json.beginObject("total");
+  json.field("processed_mflops", summary.m_TotalProcessedMFlops);
+  json.field("communicated_mbits", summary.m_TotalCommunicatedMBits);
+  json.field("processing_time", summary.m_TotalProcessingTime);
+  json.field("processing_waiting_time", summary.m_TotalProcessingWaitingTime);
+  json.field("communication_time", summary.m_TotalCommunicationTime);
+  json.field("communication_waiting_time", summary.m_TotalCommunicationWaitingTime);
+  json.field("turnaround_time", summary.m_TotalTurnaroundTime);
+  json.field("master_services", summary.m_TotalMasterServices);
+  json.field("link_services", summary.m_TotalLinkServices);
+  json.field("machine_services", summary.m_TotalMachineServices);
+  json.field("switch_services", summary.m_TotalSwitchServices);
+  json.field("completed_tasks", summary.m_TotalCompletedTasks);
+  json.field("cpu_cores", summary.m_TotalCpuCores);
+  json.field("gpu_cores", summary.m_TotalGpuCores);
+  json.endObject();
+
+  json.beginObject("average");
+  json.field("processing_time", summary.m_AvgProcessingTime);
+  json.field("processing_waiting_time", summary.m_AvgProcessingWaitingTime);
+  json.field("communication_time", summary.m_AvgCommunicationTime);
+  json.field("communication_waiting_time", summary.m_AvgCommunicationWaitingTime);
+  json.field("turnaround_time", summary.m_AvgTurnaroundTime);
+  json.endObject();
+
+  json.beginObject("system");
+  json.field("peak_computational_power", summary.m_TotalComputationalPower);
+  json.field("max_computational_power", summary.m_MaxComputationalPower);
+  json.field("efficiency", summary.m_Efficiency);
+  json.field("energy_consumption", summary.m_TotalEnergyConsumption);
+  json.field("energy_efficiency", summary.m_EnergyEfficiency);
+  json.field("avg_power", summary.m_AvgPower);
+  json.field("idle_power", summary.m_TotalPowerIdle);
+  json.endObject();
+
+  json.beginArray("users");
+  for (const auto& [id, userMetrics] : m_GlobalUserMetrics) {
+    json.beginObject();
+    json.field("name", ispd::this_model::getUserById(id).getName());
+    json.field("processing_time", userMetrics.m_ProcTime);
+    json.field("processing_waiting_time", userMetrics.m_ProcWaitingTime);
+    json.field("communication_time", userMetrics.m_CommTime);
+    json.field("communication_waiting_time", userMetrics.m_CommWaitingTime);
+    json.field("issued_tasks", userMetrics.m_IssuedTasks);
+    json.field("completed_tasks", userMetrics.m_CompletedTasks);
+    json.field("energy_consumption", userMetrics.m_EnergyConsumption);
+    json.endObject();
   }
-#endif // DEBUG_ON
+  json.endArray();
+
+  json.endObject();
 }
 
 }; // namespace ispd::metrics
@@ -411,23 +353,6 @@ namespace ispd::node_metrics {
 
   ispd::metrics::NodeMetricsCollector *g_NodeMetricsCollector = new ispd::metrics::NodeMetricsCollector();
 
-  template <>
-  void notifyMetric(const enum ispd::metrics::NodeMetricsFlag flag, const double value) {
-    /// Forward the notification to the node metrics collector.
-    g_NodeMetricsCollector->notifyMetric(flag, value);
-  }
-
-  template <>
-  void notifyMetric(const enum ispd::metrics::NodeMetricsFlag flag, const unsigned value) {
-    /// Forward the notification to the node metrics collector.
-    g_NodeMetricsCollector->notifyMetric(flag, value);
-  }
-
-  void notifyMetric(const enum ispd::metrics::NodeMetricsFlag flag) {
-    /// Forward the notification to the node metrics collector.
-    g_NodeMetricsCollector->notifyMetric(flag);
-  }
-
   void reportNodeMetrics() {
     /// Forward the report to the node metrics collector.
     g_NodeMetricsCollector->reportNodeMetrics();
@@ -443,6 +368,11 @@ namespace ispd::global_metrics {
     /// Forward the report to the global metrics collector.
     g_GlobalMetricsCollector->reportGlobalMetrics();
   }
+
+  void writeGlobalMetrics(ispd::report::JsonWriter &json) {
+    /// Forward the writing to the global metrics collector.
+    g_GlobalMetricsCollector->writeGlobalMetrics(json);
+  }
   
 }; // namespace ispd::global_metrics
 
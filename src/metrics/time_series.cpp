@@ -0,0 +1,162 @@
+#include <cstdio>
+#include <cstring>
+#include <ispd/log/log.hpp>
+#include <ispd/model/builder.hpp>
+#include <ispd/mapping/mapping.hpp>
+#include <ispd/metrics/time_series.hpp>
+
+namespace ispd::metrics {
+
+/// \brief The time series file format version.
+static constexpr std::uint32_t SERIES_VERSION = 1;
+
+void SeriesWindow::merge(const SeriesWindow &other) noexcept {
+  m_CompletedTasks += other.m_CompletedTasks;
+  m_MachineWaits += other.m_MachineWaits;
+  m_LinkWaits += other.m_LinkWaits;
+  m_MachineBusyTime += other.m_MachineBusyTime;
+  m_LinkBusyTime += other.m_LinkBusyTime;
+  m_MachineWaitingTime += other.m_MachineWaitingTime;
+  m_LinkWaitingTime += other.m_LinkWaitingTime;
+}
+
+TimeSeries::TimeSeries(const double width, const std::size_t maxWindows)
+    : m_Width(width), m_MaxWindows(maxWindows) {
+  /// Checks if the series are degenerated. If so, the program is immediately
+  /// aborted, since no window could ever be kept.
+  if (!(width > 0.0) || maxWindows < 2)
+    ispd_error("The time series must have a positive window width and keep "
+               "at least two windows (Width: %lf, Max. Windows: %zu).",
+               width, maxWindows);
+
+  m_Windows.reserve(maxWindows);
+}
+
+auto TimeSeries::addMachine(const tw_lpid gid, const unsigned cores)
+    -> unsigned {
+  /// Checks if a window has already been created. If so, the program is
+  /// immediately aborted, since the machines' busy time would be misaligned.
+  if (!m_Windows.empty())
+    ispd_error("Machine %lu has been added to the time series after the "
+               "simulation has started.",
+               gid);
+
+  m_Machines.push_back(SeriesMachine{gid, cores});
+  return static_cast<unsigned>(m_Machines.size() - 1);
+}
+
+auto TimeSeries::locate(const double time) -> std::size_t {
+  auto index = static_cast<std::size_t>(time / m_Width);
+
+  /// The window does not fit in the memory cap. Therefore, the series are
+  /// downsampled until it fits.
+  while (index >= m_MaxWindows) {
+    downsample();
+    index = static_cast<std::size_t>(time / m_Width);
+  }
+
+  if (index >= m_Windows.size()) {
+    m_Windows.resize(index + 1, SeriesWindow{});
+    m_MachineBusyTime.resize(m_Windows.size() * m_Machines.size(), 0.0);
+  }
+
+  return index;
+}
+
+void TimeSeries::downsample() {
+  const std::size_t count = (m_Windows.size() + 1) / 2;
+  const std::size_t machines = m_Machines.size();
+
+  for (std::size_t i = 0; i < count; i++) {
+    const bool hasPair = 2 * i + 1 < m_Windows.size();
+    SeriesWindow merged = m_Windows[2 * i];
+
+    if (hasPair)
+      merged.merge(m_Windows[2 * i + 1]);
+
+    m_Windows[i] = merged;
+
+    for (std::size_t slot = 0; slot < machines; slot++) {
+      double busyTime = m_MachineBusyTime[2 * i * machines + slot];
+
+      if (hasPair)
+        busyTime += m_MachineBusyTime[(2 * i + 1) * machines + slot];
+
+      m_MachineBusyTime[i * machines + slot] = busyTime;
+    }
+  }
+
+  m_Windows.resize(count);
+  m_MachineBusyTime.resize(count * machines);
+  m_Width *= 2.0;
+}
+
+void TimeSeries::write(const std::string &filepath) const {
+  std::FILE *file = std::fopen(filepath.c_str(), "wb");
+
+  /// Checks if the series file could not be opened. If so, the program is
+  /// immediately aborted.
+  if (!file)
+    ispd_error("Time series file %s could not be opened.", filepath.c_str());
+
+  SeriesHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.m_Magic, "ISPDTS", 7);
+  header.m_Version = SERIES_VERSION;
+  header.m_Rank = static_cast<std::uint32_t>(g_tw_mynode);
+  header.m_Count = m_Windows.size();
+  header.m_Width = m_Width;
+  header.m_MachineCount = m_Machines.size();
+  header.m_LinkChannels = m_LinkChannels;
+
+  if (std::fwrite(&header, sizeof(header), 1, file) != 1 ||
+      std::fwrite(m_Machines.data(), sizeof(SeriesMachine), m_Machines.size(),
+                  file) != m_Machines.size() ||
+      std::fwrite(m_Windows.data(), sizeof(SeriesWindow), m_Windows.size(),
+                  file) != m_Windows.size() ||
+      std::fwrite(m_MachineBusyTime.data(), sizeof(double),
+                  m_MachineBusyTime.size(),
+                  file) != m_MachineBusyTime.size())
+    ispd_error("Time series file %s could not be written.", filepath.c_str());
+
+  std::fclose(file);
+}
+
+}; // namespace ispd::metrics
+
+namespace ispd::time_series {
+
+ispd::metrics::TimeSeries *g_Series = nullptr;
+
+/// \brief The prefix of the files to be written.
+static std::string g_DumpPrefix;
+
+void init(const double width, const std::size_t maxWindows,
+          const std::string &dumpPrefix) {
+  g_Series = new ispd::metrics::TimeSeries(width, maxWindows);
+  g_DumpPrefix = dumpPrefix;
+}
+
+void finish() {
+  if (!g_Series)
+    return;
+
+  /// Checks if some local link has not been accounted. If so, the program is
+  /// immediately aborted, since the links' utilization could not be computed
+  /// from the written series.
+  std::uint64_t linkCount = 0;
+  for (tw_lpid i = 0; i < ispd::lp_mapping::getLocalCount(); i++)
+    if (ispd::this_model::getServiceType(ispd::lp_mapping::getLocalGid(i)) ==
+        ispd::services::ServiceType::LINK)
+      linkCount++;
+
+  if (g_Series->getLinkChannels() != 2 * linkCount)
+    ispd_error("The time series have %lu link directions, but there are %lu "
+               "local links.",
+               g_Series->getLinkChannels(), linkCount);
+
+  g_Series->write(g_DumpPrefix + "." + std::to_string(g_tw_mynode) +
+                  ".series");
+}
+
+}; // namespace ispd::time_series
@@ -8,17 +8,18 @@
 #include <ispd/services/switch.hpp>
 #include <ispd/configuration/machine.hpp>
 
+#ifdef DEBUG_ON
 static inline std::string firstSlaves(const std::vector<tw_lpid> &slaves) {
   const auto maxToShow = std::vector<tw_lpid>::size_type(10);
   const auto slavesToShowCount = std::min(maxToShow, slaves.size());
 
   std::stringstream ss;
 
-  for (int i = 0; i < slavesToShowCount - 1; i++)
-    ss << slaves[i] << ", ";
-  ss << slaves[slavesToShowCount - 1];
+  for (std::size_t i = 0; i < slavesToShowCount; i++)
+    ss << (i ? ", " : "") << slaves[i];
   return ss.str();
 }
+#endif // DEBUG_ON
 
 namespace ispd::model {
 
@@ -59,7 +60,9 @@ void SimulationModel::registerMachine(
 
   /// Register the service initializer for a machine with the specified
   /// logical process global identifier (GID).
-  registerServiceInitializer(gid, [=](void *state) {
+  registerServiceInitializer(
+      gid, ispd::services::ServiceType::MACHINE,
+      [=](void *state) {
     ispd::services::machine_state *s =
         static_cast<ispd::services::machine_state *>(state);
 
@@ -102,7 +105,9 @@ void SimulationModel::registerLink(const tw_lpid gid, const tw_lpid from,
 
   /// Register the service initializer for a link with the specified
   /// logical process global identifier (GID).
-  registerServiceInitializer(gid, [=](void *state) {
+  registerServiceInitializer(
+      gid, ispd::services::ServiceType::LINK,
+      [=](void *state) {
     ispd::services::link_state *s =
         static_cast<ispd::services::link_state *>(state);
 
@@ -114,6 +119,9 @@ void SimulationModel::registerLink(const tw_lpid gid, const tw_lpid from,
     s->conf = ispd::configuration::LinkConfiguration(bandwidth, load, latency);
   });
 
+  /// Keep the link's ends for reconstructing the service graph later.
+  m_Links.push_back(LinkDescriptor{gid, from, to});
+
   /// Print a debug indicating that a link initializer has been registered.
   ispd_debug(
       "A link with GID %lu has been registered (B: %lf, L: %lf, LT: %lf).", gid,
@@ -145,7 +153,9 @@ void SimulationModel::registerSwitch(const tw_lpid gid, const double bandwidth,
 
   /// Register the service initializer for a switch with the specified
   /// logical process global identifier (GID).
-  registerServiceInitializer(gid, [=](void *state) {
+  registerServiceInitializer(
+      gid, ispd::services::ServiceType::SWITCH,
+      [=](void *state) {
     ispd::services::SwitchState *s =
         static_cast<ispd::services::SwitchState *>(state);
 
@@ -179,17 +189,22 @@ void SimulationModel::registerMaster(
         "At registering the master %lu the workload has not been specified.",
         gid);
 
-  const auto slaveCount = slaves.size();
-  const auto someSlaves = firstSlaves(slaves);
+  /// Keep the master's slaves and its task count for estimating the traffic
+  /// through the routes starting from this master later.
+  m_Masters.push_back(
+      MasterDescriptor{gid, slaves, workload->getRemainingTasks()});
 
   /// Register the service initializer for a master with the specified
   /// logical process global identifier.
-  registerServiceInitializer(gid, [workload, scheduler, &slaves](void *state) {
+  registerServiceInitializer(
+      gid, ispd::services::ServiceType::MASTER,
+      [workload, scheduler, slaves](void *state) {
     ispd::services::master_state *s =
         static_cast<ispd::services::master_state *>(state);
 
-    /// Specify the master's slaves.
-    s->slaves = std::move(slaves);
+    /// Specify the master's slaves. The slaves are captured by value, since
+    /// the vector passed to this function may not outlive the registration.
+    s->slaves = slaves;
 
     /// Specify the master's schedule and workload.
     s->scheduler = scheduler;
@@ -197,8 +212,11 @@ void SimulationModel::registerMaster(
   });
 
   /// Print a debug indicating that a master initializer has been registered.
-  ispd_debug("A master with GID %lu has been registered (SC: %u, S: %s).", gid,
-             slaveCount, someSlaves.c_str());
+  ///
+  /// @Note: The slaves are listed inside the debug arguments, so that the
+  ///        list is not built unless DEBUG_ON is defined.
+  ispd_debug("A master with GID %lu has been registered (SC: %zu, S: %s).", gid,
+             slaves.size(), firstSlaves(slaves).c_str());
 }
 
 void SimulationModel::registerUser(const std::string &name,
@@ -257,6 +275,18 @@ SimulationModel::getServiceInitializer(const tw_lpid gid) noexcept {
         gid);
   return service_initializers.at(gid);
 }
+
+[[nodiscard]] ispd::services::ServiceType
+SimulationModel::getServiceType(const tw_lpid gid) const noexcept {
+  const auto it = m_ServiceTypes.find(gid);
+
+  /// Checks if a service with the specified global identifier has not been
+  /// registered. If so, the program is immediately aborted.
+  if (it == m_ServiceTypes.end())
+    ispd_error("A service with GID %lu has not been registered.", gid);
+
+  return it->second;
+}
 }; // namespace ispd::model
 
 namespace ispd::this_model {
@@ -306,6 +336,26 @@ getServiceInitializer(const tw_lpid gid) {
   return g_Model->getServiceInitializer(gid);
 }
 
+[[nodiscard]] ispd::services::ServiceType getServiceType(const tw_lpid gid) {
+  /// Forward the service type query to the global model.
+  return g_Model->getServiceType(gid);
+}
+
+[[nodiscard]] tw_lpid getServiceCount() {
+  /// Forward the service count query to the global model.
+  return g_Model->getServiceCount();
+}
+
+[[nodiscard]] const std::vector<ispd::model::LinkDescriptor> &getLinks() {
+  /// Forward the links query to the global model.
+  return g_Model->getLinks();
+}
+
+[[nodiscard]] const std::vector<ispd::model::MasterDescriptor> &getMasters() {
+  /// Forward the masters query to the global model.
+  return g_Model->getMasters();
+}
+
 [[nodiscard]] const std::unordered_map<ispd::model::User::uid_t,
                                        ispd::model::User> &
 getUsers() {
@@ -0,0 +1,115 @@
+#include <vector>
+#include <memory>
+#include <ispd/log/log.hpp>
+#include <ispd/model/builder.hpp>
+#include <ispd/model/topology.hpp>
+#include <ispd/routing/routing.hpp>
+#include <ispd/workload/workload.hpp>
+#include <ispd/workload/interarrival.hpp>
+#include <ispd/scheduler/round_robin.hpp>
+
+namespace ispd::topology {
+
+namespace {
+/// \brief Registers a machine with the synthetic topologies' configuration.
+void registerMachine(const tw_lpid gid) {
+  ispd::this_model::registerMachine(gid, 20.0, 0.0, 8, 9800.0, 4096, 6.4, 0.0,
+                                    0.0);
+}
+
+/// \brief Registers a link with the synthetic topologies' configuration.
+void registerLink(const tw_lpid gid, const tw_lpid from, const tw_lpid to) {
+  ispd::this_model::registerLink(gid, from, to, 50.0, 0.0, 1.0);
+}
+
+/// \brief Registers the master with the synthetic topologies' workload.
+void registerMaster(const std::string &user, std::vector<tw_lpid> &&slaves,
+                    const unsigned taskCount) {
+  ispd::this_model::registerMaster(
+      0, std::move(slaves), new ispd::scheduler::RoundRobin,
+      ispd::workload::constant(
+          user, taskCount, 1000.0, 80.0, 0.95,
+          std::make_unique<ispd::workload::PoissonInterarrivalDistribution>(
+              0.1)));
+}
+
+/// \brief Generates the subtree rooted at the specified vertex.
+///
+/// \param root The subtree's root GID.
+/// \param depth The root's depth.
+/// \param fanout The amount of children of each inner vertex.
+/// \param maxDepth The machines' depth.
+/// \param nextGid The next GID to be given.
+/// \param path The route from the master to the subtree's root (excluding the
+///             master and including the root).
+/// \param slaves The machines generated so far.
+void generateSubtree(const tw_lpid root, const unsigned depth,
+                     const unsigned fanout, const unsigned maxDepth,
+                     tw_lpid &nextGid, std::vector<tw_lpid> &path,
+                     std::vector<tw_lpid> &slaves) {
+  for (unsigned i = 0; i < fanout; i++) {
+    const tw_lpid link = nextGid++;
+    const tw_lpid child = nextGid++;
+
+    registerLink(link, root, child);
+    path.push_back(link);
+    path.push_back(child);
+
+    /// The leaves are the machines. Each one of them is reached by the
+    /// master through the route that has been built along the way.
+    if (depth + 1 == maxDepth) {
+      registerMachine(child);
+      ispd::routing_table::registerRoute(0, child, path);
+      slaves.push_back(child);
+    } else {
+      ispd::this_model::registerSwitch(child, 50.0, 0.0, 1.0);
+      generateSubtree(child, depth + 1, fanout, maxDepth, nextGid, path,
+                      slaves);
+    }
+
+    path.pop_back();
+    path.pop_back();
+  }
+}
+}; // namespace
+
+void star(const std::string &user, const unsigned machineCount,
+          const unsigned taskCount) {
+  /// Checks if there is no machine. If so, the program is immediately
+  /// aborted, since the master would have no slave.
+  if (machineCount == 0)
+    ispd_error("A star topology must have at least one machine.");
+
+  std::vector<tw_lpid> slaves;
+  slaves.reserve(machineCount);
+
+  for (tw_lpid machine = 2; machine <= 2 * machineCount; machine += 2) {
+    const tw_lpid link = machine - 1;
+
+    registerLink(link, 0, machine);
+    registerMachine(machine);
+    ispd::routing_table::registerRoute(0, machine, {link, machine});
+    slaves.push_back(machine);
+  }
+
+  registerMaster(user, std::move(slaves), taskCount);
+}
+
+void tree(const std::string &user, const unsigned fanout, const unsigned depth,
+          const unsigned taskCount) {
+  /// Checks if the tree is degenerated. If so, the program is immediately
+  /// aborted, since the master would have no slave.
+  if (fanout == 0 || depth == 0)
+    ispd_error("A tree topology must have positive fanout and depth "
+               "(Fanout: %u, Depth: %u).",
+               fanout, depth);
+
+  tw_lpid nextGid = 1;
+  std::vector<tw_lpid> path;
+  std::vector<tw_lpid> slaves;
+
+  generateSubtree(0, 0, fanout, depth, nextGid, path, slaves);
+  registerMaster(user, std::move(slaves), taskCount);
+}
+
+}; // namespace ispd::topology
@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <ispd/log/log.hpp>
+#include <ispd/model/builder.hpp>
+#include <ispd/routing/routing.hpp>
+#include <ispd/partitioning/graph.hpp>
+
+namespace ispd::partitioning {
+
+auto ServiceGraph::getTotalVertexWeight() const noexcept -> weight_type {
+  weight_type total = 0;
+  for (const auto weight : m_VertexWeights)
+    total += weight;
+  return total;
+}
+
+auto ServiceGraph::computeEdgeCut(
+    const std::vector<tw_peid> &partition) const noexcept -> weight_type {
+  weight_type cut = 0;
+
+  for (vertex_type v = 0; v < getVertexCount(); v++)
+    for (vertex_type e = m_Offsets[v]; e < m_Offsets[v + 1]; e++)
+      if (partition[v] != partition[m_Adjacency[e]])
+        cut += m_EdgeWeights[e];
+
+  /// Each undirected edge is stored twice and, therefore, it has been
+  /// counted twice.
+  return cut / 2;
+}
+
+auto ServiceGraph::computeImbalance(const std::vector<tw_peid> &partition,
+                                    const tw_peid partCount) const noexcept
+    -> double {
+  std::vector<weight_type> partWeights(partCount, 0);
+
+  for (vertex_type v = 0; v < getVertexCount(); v++)
+    partWeights[partition[v]] += m_VertexWeights[v];
+
+  const weight_type total = getTotalVertexWeight();
+
+  /// An empty graph is trivially balanced.
+  if (total == 0)
+    return 1.0;
+
+  const weight_type heaviest =
+      *std::max_element(partWeights.begin(), partWeights.end());
+  return static_cast<double>(heaviest) * static_cast<double>(partCount) /
+         static_cast<double>(total);
+}
+
+auto ServiceGraphBuilder::addVertexWeight(const vertex_type v,
+                                          const weight_type weight) -> void {
+  m_VertexWeights.at(v) += weight;
+}
+
+auto ServiceGraphBuilder::addEdge(const vertex_type u, const vertex_type v,
+                                  const weight_type weight) -> void {
+  /// Self-loops do not contribute to the edge cut and, therefore, they are
+  /// ignored.
+  if (u == v)
+    return;
+
+  m_Edges.at(u).emplace_back(v, weight);
+  m_Edges.at(v).emplace_back(u, weight);
+}
+
+auto ServiceGraphBuilder::build() -> ServiceGraph {
+  const vertex_type vertexCount = m_VertexWeights.size();
+
+  std::vector<vertex_type> offsets;
+  std::vector<vertex_type> adjacency;
+  std::vector<weight_type> edgeWeights;
+
+  offsets.reserve(vertexCount + 1);
+  offsets.push_back(0);
+
+  for (vertex_type v = 0; v < vertexCount; v++) {
+    auto &edges = m_Edges[v];
+
+    /// Sort the adjacency list so that parallel edges are contiguous and,
+    /// therefore, can be merged by summing up their weights.
+    std::sort(edges.begin(), edges.end());
+
+    for (std::size_t i = 0; i < edges.size(); i++) {
+      if (i > 0 && edges[i].first == edges[i - 1].first)
+        edgeWeights.back() += edges[i].second;
+      else {
+        adjacency.push_back(edges[i].first);
+        edgeWeights.push_back(edges[i].second);
+      }
+    }
+
+    offsets.push_back(adjacency.size());
+
+    /// Release the memory used by the adjacency list as soon as possible,
+    /// since the models can be quite large.
+    std::vector<std::pair<vertex_type, weight_type>>().swap(edges);
+  }
+
+  return ServiceGraph(std::move(offsets), std::move(adjacency),
+                      std::move(edgeWeights), std::move(m_VertexWeights));
+}
+
+auto buildServiceGraph() -> ServiceGraph {
+  const tw_lpid serviceCount = ispd::this_model::getServiceCount();
+  ServiceGraphBuilder builder(serviceCount);
+
+  /// Every service processes at least some events during the simulation,
+  /// therefore, each one of them has a unitary weight even if no route
+  /// passes through it.
+  for (tw_lpid gid = 0; gid < serviceCount; gid++)
+    builder.addVertexWeight(gid, 1);
+
+  /// Every registered link connects two services. A unitary weight is given
+  /// so that the graph keeps its structure even if no traffic is expected.
+  for (const auto &link : ispd::this_model::getLinks()) {
+    if (link.m_Gid >= serviceCount || link.m_From >= serviceCount ||
+        link.m_To >= serviceCount)
+      ispd_error("Link %lu connects services that have not been registered "
+                 "(From: %lu, To: %lu).",
+                 link.m_Gid, link.m_From, link.m_To);
+
+    builder.addEdge(link.m_From, link.m_Gid, 1);
+    builder.addEdge(link.m_Gid, link.m_To, 1);
+  }
+
+  for (const auto &master : ispd::this_model::getMasters()) {
+    const auto slaveCount = master.m_Slaves.size();
+
+    if (slaveCount == 0)
+      continue;
+
+    /// The master schedules the tasks evenly among its slaves, since it
+    /// is not known in advance which scheduling policy is going to
+    /// dispatch them. Each task is sent downward and its result is sent
+    /// upward, hence each element of the route handles two events per task.
+    const ServiceGraph::weight_type tasksPerSlave =
+        (master.m_TaskCount + slaveCount - 1) / slaveCount;
+    const ServiceGraph::weight_type traffic = 2 * tasksPerSlave;
+
+    builder.addVertexWeight(master.m_Gid,
+                            2 * static_cast<ServiceGraph::weight_type>(
+                                    master.m_TaskCount));
+
+    for (const auto slave : master.m_Slaves) {
+      const auto *route = ispd::routing_table::getRoute(master.m_Gid, slave);
+
+      tw_lpid previous = master.m_Gid;
+      for (std::size_t i = 0; i < route->getLength(); i++) {
+        const tw_lpid current = route->get(i);
+
+        builder.addEdge(previous, current, traffic);
+        builder.addVertexWeight(current, traffic);
+        previous = current;
+      }
+    }
+  }
+
+  return builder.build();
+}
+
+}; // namespace ispd::partitioning
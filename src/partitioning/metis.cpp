@@ -0,0 +1,99 @@
+#include <limits>
+#include <vector>
+#include <numeric>
+#include <algorithm>
+#include <ispd/log/log.hpp>
+#include <ispd/partitioning/partitioner.hpp>
+
+#ifdef ISPD_HAVE_METIS
+#include <metis.h>
+#endif // ISPD_HAVE_METIS
+
+namespace ispd::partitioning {
+
+auto MetisPartitioner::partition(const ServiceGraph &graph,
+                                 const tw_peid partCount)
+    -> std::vector<tw_peid> {
+#ifdef ISPD_HAVE_METIS
+  const auto n = graph.getVertexCount();
+
+  if (partCount == 1)
+    return std::vector<tw_peid>(n, 0);
+
+  /// METIS may have been built with 32-bit indices. In that case, the weights
+  /// are scaled down so that their sums fit in its index type.
+  const ServiceGraph::weight_type limit =
+      std::numeric_limits<idx_t>::max() / 4;
+  const ServiceGraph::weight_type total = std::max(
+      graph.getTotalVertexWeight(),
+      std::accumulate(graph.getEdgeWeights().begin(),
+                      graph.getEdgeWeights().end(),
+                      ServiceGraph::weight_type(0)));
+  const ServiceGraph::weight_type scale =
+      total > limit ? total / limit + 1 : 1;
+
+  const auto scaled = [scale](const ServiceGraph::weight_type weight) {
+    return static_cast<idx_t>(
+        std::max<ServiceGraph::weight_type>(1, weight / scale));
+  };
+
+  std::vector<idx_t> xadj(graph.getOffsets().begin(),
+                          graph.getOffsets().end());
+  std::vector<idx_t> adjncy(graph.getAdjacency().begin(),
+                            graph.getAdjacency().end());
+  std::vector<idx_t> vwgt(n);
+  std::vector<idx_t> adjwgt(graph.getEdgeWeights().size());
+  std::vector<idx_t> part(n);
+
+  std::transform(graph.getVertexWeights().begin(),
+                 graph.getVertexWeights().end(), vwgt.begin(), scaled);
+  std::transform(graph.getEdgeWeights().begin(), graph.getEdgeWeights().end(),
+                 adjwgt.begin(), scaled);
+
+  idx_t nvtxs = static_cast<idx_t>(n);
+  idx_t ncon = 1;
+  idx_t nparts = static_cast<idx_t>(partCount);
+  idx_t objval = 0;
+
+  idx_t options[METIS_NOPTIONS];
+  METIS_SetDefaultOptions(options);
+  options[METIS_OPTION_UFACTOR] = static_cast<idx_t>(m_Imbalance * 1000.0);
+
+  /// Every rank must compute exactly the same partition.
+  options[METIS_OPTION_SEED] = 0;
+
+  const int status = METIS_PartGraphKway(
+      &nvtxs, &ncon, xadj.data(), adjncy.data(), vwgt.data(), nullptr,
+      adjwgt.data(), &nparts, nullptr, nullptr, options, &objval, part.data());
+
+  if (status != METIS_OK)
+    ispd_error("METIS could not partition the service graph (Status: %d).",
+               status);
+
+  std::vector<tw_peid> partition(part.begin(), part.end());
+
+  /// METIS does not guarantee that every part has at least one vertex, which
+  /// is required by ROSS. In that case, the built-in partitioner is used.
+  std::vector<bool> used(partCount, false);
+  for (const auto p : partition)
+    used[p] = true;
+
+  if (std::find(used.begin(), used.end(), false) != used.end()) {
+    ispd_info("METIS has left a part empty, falling back to the built-in "
+              "multilevel partitioner.");
+    return MultilevelPartitioner(m_Imbalance).partition(graph, partCount);
+  }
+
+  return partition;
+#else
+  ispd_error("METIS support has not been enabled at build time, reconfigure "
+             "with -DISPD_USE_METIS=ON or choose another partitioner.");
+  return {};
+#endif // ISPD_HAVE_METIS
+}
+
+auto metis(const double imbalance) -> MetisPartitioner * {
+  return new MetisPartitioner(imbalance);
+}
+
+}; // namespace ispd::partitioning
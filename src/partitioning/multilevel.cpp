@@ -0,0 +1,489 @@
+#include <queue>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <algorithm>
+#include <ispd/log/log.hpp>
+#include <ispd/partitioning/partitioner.hpp>
+
+namespace ispd::partitioning {
+
+namespace {
+using vertex_type = ServiceGraph::vertex_type;
+using weight_type = ServiceGraph::weight_type;
+
+/// \brief Indicates that a vertex has not been matched or assigned yet.
+constexpr vertex_type NONE = std::numeric_limits<vertex_type>::max();
+
+/// \brief Indicates that a vertex has not been assigned to any part yet.
+constexpr tw_peid UNASSIGNED = std::numeric_limits<tw_peid>::max();
+
+/// \brief The coarsening stops as soon as the graph has at most this amount of
+///        vertices per part.
+constexpr vertex_type COARSEST_VERTICES_PER_PART = 20;
+
+/// \brief The coarsening stops if a level collapses less than this fraction of
+///        the vertices, since further coarsening would barely help.
+constexpr double MINIMUM_COARSENING_RATIO = 0.95;
+
+/// \brief The maximum amount of refinement passes at each level.
+constexpr int MAXIMUM_REFINEMENT_PASSES = 8;
+
+/// \struct Level
+///
+/// \brief A level of the multilevel hierarchy.
+struct Level {
+  ServiceGraph m_Graph;
+
+  /// \brief The vertex at the next (coarser) level that each vertex of this
+  ///        level has been collapsed into.
+  std::vector<vertex_type> m_CoarseMap;
+};
+
+/// \brief Coarsens the graph by collapsing the vertices matched through their
+///        heaviest edges (heavy-edge matching).
+///
+/// \param graph The graph to be coarsened.
+/// \param maxVertexWeight The maximum weight of a collapsed vertex, so that a
+///                        single coarse vertex cannot unbalance the parts.
+/// \param coarseMap The vertex at the coarse graph that each vertex has been
+///                  collapsed into.
+///
+/// \return The coarse graph.
+ServiceGraph coarsen(const ServiceGraph &graph,
+                     const weight_type maxVertexWeight,
+                     std::vector<vertex_type> &coarseMap) {
+  const vertex_type n = graph.getVertexCount();
+  const auto &offsets = graph.getOffsets();
+  const auto &adjacency = graph.getAdjacency();
+  const auto &edgeWeights = graph.getEdgeWeights();
+  const auto &vertexWeights = graph.getVertexWeights();
+
+  /// The vertices are visited in increasing order of degree, so that the
+  /// low degree vertices (e.g., the machines at the leaves) have a chance of
+  /// being matched before their neighbors are taken.
+  std::vector<vertex_type> order(n);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&](const vertex_type a, const vertex_type b) {
+                     return offsets[a + 1] - offsets[a] <
+                            offsets[b + 1] - offsets[b];
+                   });
+
+  std::vector<vertex_type> match(n, NONE);
+
+  for (const vertex_type v : order) {
+    if (match[v] != NONE)
+      continue;
+
+    vertex_type best = NONE;
+    weight_type bestWeight = -1;
+
+    for (vertex_type e = offsets[v]; e < offsets[v + 1]; e++) {
+      const vertex_type u = adjacency[e];
+
+      if (match[u] != NONE)
+        continue;
+      if (vertexWeights[v] + vertexWeights[u] > maxVertexWeight)
+        continue;
+
+      if (edgeWeights[e] > bestWeight) {
+        bestWeight = edgeWeights[e];
+        best = u;
+      }
+    }
+
+    /// An unmatched vertex is collapsed alone.
+    if (best == NONE)
+      match[v] = v;
+    else {
+      match[v] = best;
+      match[best] = v;
+    }
+  }
+
+  /// Number the coarse vertices following the fine vertices order, so that
+  /// the coarse graph keeps the locality of the services' identifiers.
+  coarseMap.assign(n, NONE);
+  vertex_type coarseCount = 0;
+
+  for (vertex_type v = 0; v < n; v++) {
+    if (coarseMap[v] != NONE)
+      continue;
+    coarseMap[v] = coarseCount;
+    coarseMap[match[v]] = coarseCount;
+    coarseCount++;
+  }
+
+  std::vector<vertex_type> coarseOffsets;
+  std::vector<vertex_type> coarseAdjacency;
+  std::vector<weight_type> coarseEdgeWeights;
+  std::vector<weight_type> coarseVertexWeights(coarseCount, 0);
+
+  coarseOffsets.reserve(coarseCount + 1);
+  coarseOffsets.push_back(0);
+
+  /// The position of each coarse neighbor in the adjacency list being built,
+  /// so that parallel edges can be merged in constant time.
+  std::vector<vertex_type> position(coarseCount, NONE);
+
+  for (vertex_type v = 0; v < n; v++) {
+    /// Each coarse vertex is built when its first fine vertex is visited.
+    if (match[v] < v)
+      continue;
+
+    const vertex_type c = coarseMap[v];
+    const vertex_type start = coarseAdjacency.size();
+    const vertex_type members[2] = {v, match[v]};
+    const int memberCount = match[v] == v ? 1 : 2;
+
+    for (int i = 0; i < memberCount; i++) {
+      const vertex_type fine = members[i];
+      coarseVertexWeights[c] += vertexWeights[fine];
+
+      for (vertex_type e = offsets[fine]; e < offsets[fine + 1]; e++) {
+        const vertex_type u = coarseMap[adjacency[e]];
+
+        /// The edge between the matched vertices becomes internal.
+        if (u == c)
+          continue;
+
+        if (position[u] == NONE) {
+          position[u] = coarseAdjacency.size();
+          coarseAdjacency.push_back(u);
+          coarseEdgeWeights.push_back(edgeWeights[e]);
+        } else
+          coarseEdgeWeights[position[u]] += edgeWeights[e];
+      }
+    }
+
+    for (vertex_type e = start; e < coarseAdjacency.size(); e++)
+      position[coarseAdjacency[e]] = NONE;
+
+    coarseOffsets.push_back(coarseAdjacency.size());
+  }
+
+  return ServiceGraph(std::move(coarseOffsets), std::move(coarseAdjacency),
+                      std::move(coarseEdgeWeights),
+                      std::move(coarseVertexWeights));
+}
+
+/// \brief Computes the initial partition of the coarsest graph by growing each
+///        part from a seed vertex (greedy graph growing).
+///
+/// The vertex most connected to the part being grown is added to it until the
+/// part reaches its share of the remaining weight.
+std::vector<tw_peid> grow(const ServiceGraph &graph, const tw_peid partCount) {
+  const vertex_type n = graph.getVertexCount();
+  const auto &offsets = graph.getOffsets();
+  const auto &adjacency = graph.getAdjacency();
+  const auto &edgeWeights = graph.getEdgeWeights();
+  const auto &vertexWeights = graph.getVertexWeights();
+
+  std::vector<tw_peid> partition(n, UNASSIGNED);
+  std::vector<weight_type> connectivity(n, 0);
+  std::vector<vertex_type> touched;
+
+  weight_type remainingWeight = graph.getTotalVertexWeight();
+  vertex_type remainingVertices = n;
+  vertex_type nextSeed = 0;
+
+  for (tw_peid p = 0; p < partCount; p++) {
+    const tw_peid remainingParts = partCount - p;
+
+    /// The last part takes all the vertices that have not been assigned.
+    if (remainingParts == 1) {
+      for (vertex_type v = 0; v < n; v++)
+        if (partition[v] == UNASSIGNED)
+          partition[v] = p;
+      break;
+    }
+
+    const weight_type target = remainingWeight / remainingParts;
+    weight_type partWeight = 0;
+
+    /// A max-heap of (connectivity, -vertex), so that ties are broken by the
+    /// lowest vertex identifier, keeping the partition deterministic.
+    std::priority_queue<std::pair<weight_type, std::int64_t>> frontier;
+
+    while (partWeight < target || partWeight == 0) {
+      /// It must be left at least one vertex for each remaining part.
+      if (remainingVertices <= remainingParts - 1)
+        break;
+
+      vertex_type v = NONE;
+
+      while (!frontier.empty()) {
+        const auto [gain, negated] = frontier.top();
+        frontier.pop();
+
+        const auto candidate = static_cast<vertex_type>(-negated);
+        if (partition[candidate] == UNASSIGNED &&
+            connectivity[candidate] == gain) {
+          v = candidate;
+          break;
+        }
+      }
+
+      /// The part has no more unassigned neighbors (e.g., the graph is
+      /// disconnected). Hence, the part continues from a new seed.
+      if (v == NONE) {
+        while (partition[nextSeed] != UNASSIGNED)
+          nextSeed++;
+        v = nextSeed;
+      }
+
+      partition[v] = p;
+      partWeight += vertexWeights[v];
+      remainingWeight -= vertexWeights[v];
+      remainingVertices--;
+
+      for (vertex_type e = offsets[v]; e < offsets[v + 1]; e++) {
+        const vertex_type u = adjacency[e];
+        if (partition[u] != UNASSIGNED)
+          continue;
+        if (connectivity[u] == 0)
+          touched.push_back(u);
+        connectivity[u] += edgeWeights[e];
+        frontier.emplace(connectivity[u], -static_cast<std::int64_t>(u));
+      }
+    }
+
+    /// The connectivity is relative to the part being grown.
+    for (const vertex_type u : touched)
+      connectivity[u] = 0;
+    touched.clear();
+  }
+
+  return partition;
+}
+
+/// \brief Refines the partition by greedily moving the vertices to the part
+///        they are most connected to.
+///
+/// At first, the overweight parts are relieved by moving their vertices to
+/// the parts with room, preferring their neighbors' parts. Then, the vertices
+/// are moved whenever it reduces the edge cut, or keeps it while improving the
+/// balance, without exceeding the maximum part weight.
+void refine(const ServiceGraph &graph, const tw_peid partCount,
+            const double imbalance, std::vector<tw_peid> &partition) {
+  const vertex_type n = graph.getVertexCount();
+  const auto &offsets = graph.getOffsets();
+  const auto &adjacency = graph.getAdjacency();
+  const auto &edgeWeights = graph.getEdgeWeights();
+  const auto &vertexWeights = graph.getVertexWeights();
+
+  const weight_type total = graph.getTotalVertexWeight();
+  const weight_type heaviestVertex =
+      n == 0 ? 0 : *std::max_element(vertexWeights.begin(), vertexWeights.end());
+
+  /// A single vertex may weight more than the allowed part weight. In that
+  /// case, the balance constraint is relaxed to fit it.
+  const weight_type maxPartWeight = std::max(
+      static_cast<weight_type>(std::ceil((1.0 + imbalance) * total /
+                                         static_cast<double>(partCount))),
+      heaviestVertex);
+
+  std::vector<weight_type> partWeights(partCount, 0);
+  std::vector<vertex_type> partSizes(partCount, 0);
+
+  for (vertex_type v = 0; v < n; v++) {
+    partWeights[partition[v]] += vertexWeights[v];
+    partSizes[partition[v]]++;
+  }
+
+  std::vector<weight_type> connectivity(partCount, 0);
+  std::vector<tw_peid> touched;
+
+  const auto gatherConnectivity = [&](const vertex_type v) {
+    for (vertex_type e = offsets[v]; e < offsets[v + 1]; e++) {
+      const tw_peid p = partition[adjacency[e]];
+      if (connectivity[p] == 0)
+        touched.push_back(p);
+      connectivity[p] += edgeWeights[e];
+    }
+  };
+
+  const auto clearConnectivity = [&]() {
+    for (const tw_peid p : touched)
+      connectivity[p] = 0;
+    touched.clear();
+  };
+
+  const auto move = [&](const vertex_type v, const tw_peid to) {
+    partWeights[partition[v]] -= vertexWeights[v];
+    partSizes[partition[v]]--;
+    partWeights[to] += vertexWeights[v];
+    partSizes[to]++;
+    partition[v] = to;
+  };
+
+  /// Balancing.
+  for (int pass = 0; pass < MAXIMUM_REFINEMENT_PASSES; pass++) {
+    bool overweight = false;
+    bool moved = false;
+
+    for (vertex_type v = 0; v < n; v++) {
+      const tw_peid from = partition[v];
+
+      if (partWeights[from] <= maxPartWeight)
+        continue;
+      overweight = true;
+
+      /// A part cannot become empty.
+      if (partSizes[from] == 1)
+        continue;
+
+      gatherConnectivity(v);
+
+      tw_peid best = UNASSIGNED;
+      for (const tw_peid p : touched) {
+        if (p == from || partWeights[p] + vertexWeights[v] > maxPartWeight)
+          continue;
+        if (best == UNASSIGNED || connectivity[p] > connectivity[best])
+          best = p;
+      }
+
+      clearConnectivity();
+
+      /// If no neighbor part has room, the lightest part is used.
+      if (best == UNASSIGNED) {
+        const auto lightest = static_cast<tw_peid>(
+            std::min_element(partWeights.begin(), partWeights.end()) -
+            partWeights.begin());
+        if (lightest != from &&
+            partWeights[lightest] + vertexWeights[v] <= maxPartWeight)
+          best = lightest;
+      }
+
+      if (best != UNASSIGNED) {
+        move(v, best);
+        moved = true;
+      }
+    }
+
+    if (!overweight || !moved)
+      break;
+  }
+
+  /// Edge cut reduction.
+  for (int pass = 0; pass < MAXIMUM_REFINEMENT_PASSES; pass++) {
+    bool moved = false;
+
+    for (vertex_type v = 0; v < n; v++) {
+      const tw_peid from = partition[v];
+
+      /// A part cannot become empty.
+      if (partSizes[from] == 1)
+        continue;
+
+      gatherConnectivity(v);
+
+      const weight_type internal = connectivity[from];
+      tw_peid best = from;
+      weight_type bestGain = 0;
+
+      for (const tw_peid p : touched) {
+        if (p == from || partWeights[p] + vertexWeights[v] > maxPartWeight)
+          continue;
+
+        const weight_type gain = connectivity[p] - internal;
+
+        /// A move that keeps the edge cut is only accepted if it improves
+        /// the balance between both parts.
+        if (gain < 0 ||
+            (gain == 0 &&
+             partWeights[p] + vertexWeights[v] >= partWeights[from]))
+          continue;
+
+        if (best == from || gain > bestGain ||
+            (gain == bestGain && partWeights[p] < partWeights[best])) {
+          best = p;
+          bestGain = gain;
+        }
+      }
+
+      clearConnectivity();
+
+      if (best != from) {
+        move(v, best);
+        moved = true;
+      }
+    }
+
+    if (!moved)
+      break;
+  }
+}
+}; // namespace
+
+auto MultilevelPartitioner::partition(const ServiceGraph &graph,
+                                      const tw_peid partCount)
+    -> std::vector<tw_peid> {
+  const vertex_type n = graph.getVertexCount();
+
+  if (partCount == 0)
+    ispd_error("The graph must be partitioned into at least one part.");
+
+  if (n < partCount)
+    ispd_error("A graph with %lu vertices cannot be partitioned into %lu "
+               "non-empty parts.",
+               n, static_cast<unsigned long>(partCount));
+
+  if (partCount == 1)
+    return std::vector<tw_peid>(n, 0);
+
+  /// A collapsed vertex cannot weight more than a fraction of a part, since
+  /// otherwise the coarsest graph could not be partitioned in a balanced way.
+  const weight_type maxVertexWeight = std::max<weight_type>(
+      1, graph.getTotalVertexWeight() /
+             static_cast<weight_type>(COARSEST_VERTICES_PER_PART * partCount /
+                                      4));
+  const vertex_type coarsestVertices = COARSEST_VERTICES_PER_PART * partCount;
+
+  std::vector<Level> levels;
+  const ServiceGraph *current = &graph;
+
+  /// Coarsening.
+  while (current->getVertexCount() > coarsestVertices) {
+    std::vector<vertex_type> coarseMap;
+    ServiceGraph coarse = coarsen(*current, maxVertexWeight, coarseMap);
+
+    if (coarse.getVertexCount() >
+        MINIMUM_COARSENING_RATIO * current->getVertexCount())
+      break;
+
+    levels.push_back(Level{std::move(coarse), std::move(coarseMap)});
+    current = &levels.back().m_Graph;
+  }
+
+  /// The levels vector owns the coarse graphs, therefore, the pointers must
+  /// be taken after it has stopped growing.
+  const auto graphAt = [&](const std::size_t level) -> const ServiceGraph & {
+    return level == 0 ? graph : levels[level - 1].m_Graph;
+  };
+
+  /// Initial partitioning.
+  std::vector<tw_peid> partition = grow(graphAt(levels.size()), partCount);
+  refine(graphAt(levels.size()), partCount, m_Imbalance, partition);
+
+  /// Uncoarsening.
+  for (std::size_t level = levels.size(); level > 0; level--) {
+    const auto &coarseMap = levels[level - 1].m_CoarseMap;
+    std::vector<tw_peid> finer(coarseMap.size());
+
+    for (vertex_type v = 0; v < coarseMap.size(); v++)
+      finer[v] = partition[coarseMap[v]];
+
+    partition = std::move(finer);
+    refine(graphAt(level - 1), partCount, m_Imbalance, partition);
+  }
+
+  return partition;
+}
+
+auto multilevel(const double imbalance) -> MultilevelPartitioner * {
+  return new MultilevelPartitioner(imbalance);
+}
+
+}; // namespace ispd::partitioning
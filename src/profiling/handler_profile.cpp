@@ -0,0 +1,272 @@
+#include <ispd/profiling/handler_profile.hpp>
+
+#ifdef ISPD_PROFILE_HANDLERS
+#include <mpi.h>
+#include <ross.h>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <ispd/log/log.hpp>
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif // __linux__
+
+namespace ispd::handler_profile {
+
+using ispd::profiling::g_ProfiledCounters;
+using ispd::profiling::g_ProfiledHandlerKinds;
+using ispd::profiling::g_ProfiledServiceTypes;
+
+ispd::profiling::HandlerTimes g_Times = {};
+std::uint64_t g_SampleMask = 0;
+bool g_CountersEnabled = false;
+
+/// \brief Whether the hardware performance counters have been read by every
+///        node, only kept at the master node.
+static bool g_ReducedCountersEnabled = false;
+
+/// \brief The counters' group leader, whose group is read at once.
+static int g_CounterGroup = -1;
+
+/// \brief The counters' names, indexed by `HandlerCounter`.
+static constexpr const char *g_CounterNames[] = {"cycles", "instructions",
+                                                 "llc_misses", "branch_misses"};
+
+static_assert(std::size(g_CounterNames) == g_ProfiledCounters);
+
+/// \brief The profiling clock and the steady clock at the profile's start,
+///        which calibrate the clock ticks into nanoseconds.
+static std::uint64_t g_StartTicks;
+static std::chrono::steady_clock::time_point g_StartTime;
+
+/// \brief The reduced measurements, only kept at the master node.
+static ispd::profiling::HandlerTimes g_ReducedTimes = {};
+
+/// \brief The profiling clock's ticks per nanosecond.
+static double g_TicksPerNanosecond = 1.0;
+
+#ifdef __linux__
+/// \brief Opens a hardware performance counter of the calling thread.
+///
+/// \param config The counter's hardware event.
+/// \param group The group leader, or -1 if the counter leads the group.
+///
+/// \return The counter's file descriptor, or -1 if it could not be opened.
+static int openCounter(const std::uint64_t config, const int group) {
+  struct perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = config;
+  attr.read_format = PERF_FORMAT_GROUP;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+
+  /// The group leader starts disabled and enables the whole group at once.
+  attr.disabled = group == -1;
+
+  return static_cast<int>(
+      syscall(SYS_perf_event_open, &attr, 0, -1, group, 0));
+}
+#endif // __linux__
+
+/// \brief Opens the hardware performance counters, as a group that is read
+///        at once.
+///
+/// \return Whether every counter has been opened.
+static bool openCounters() {
+#ifdef __linux__
+  static constexpr std::uint64_t configs[] = {
+      PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+      PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+  static_assert(std::size(configs) == g_ProfiledCounters);
+
+  for (const auto config : configs) {
+    const int fd = openCounter(config, g_CounterGroup);
+
+    /// Checks if the counter could not be opened. If so, the counters that
+    /// have been opened are closed with their leader.
+    if (fd == -1) {
+      if (g_CounterGroup != -1)
+        close(g_CounterGroup);
+      g_CounterGroup = -1;
+      return false;
+    }
+
+    if (g_CounterGroup == -1)
+      g_CounterGroup = fd;
+  }
+
+  ioctl(g_CounterGroup, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(g_CounterGroup, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  return true;
+#else
+  return false;
+#endif // __linux__
+}
+
+void readCounters(std::uint64_t (&values)[g_ProfiledCounters]) {
+#ifdef __linux__
+  /// The group's read format is the amount of counters followed by their
+  /// values.
+  std::uint64_t group[1 + g_ProfiledCounters];
+
+  if (read(g_CounterGroup, group, sizeof(group)) ==
+      static_cast<ssize_t>(sizeof(group))) {
+    std::memcpy(values, group + 1, sizeof(values));
+    return;
+  }
+#endif // __linux__
+
+  std::memset(values, 0, sizeof(values));
+}
+
+void init(const unsigned samplePeriod, const bool counters) {
+  /// Checks if the sampling period is not a power of two. If so, the program
+  /// is immediately aborted, since the sampled calls are selected by a mask.
+  if (samplePeriod == 0 || (samplePeriod & (samplePeriod - 1)) != 0)
+    ispd_error("The handler sampling period must be a power of two (Period: "
+               "%u).",
+               samplePeriod);
+
+  g_SampleMask = samplePeriod - 1;
+
+  if (counters) {
+    g_CountersEnabled = openCounters();
+
+    if (!g_CountersEnabled)
+      ispd_info("The hardware performance counters could not be opened at PE "
+                "%lu (%s), therefore, only the time is measured.",
+                g_tw_mynode, std::strerror(errno));
+  }
+
+  g_StartTicks = ispd::profiling::readClock();
+  g_StartTime = std::chrono::steady_clock::now();
+}
+
+void reduce() {
+  constexpr int words = (3 + g_ProfiledCounters) * g_ProfiledServiceTypes *
+                        g_ProfiledHandlerKinds;
+  static_assert(sizeof(ispd::profiling::HandlerTimes) ==
+                words * sizeof(std::uint64_t));
+
+  /// The counters are only reported if every node has read them, since
+  /// otherwise their sums would only cover some of the calls.
+  const int countersEnabled = g_CountersEnabled;
+  int everyCountersEnabled;
+
+  if (MPI_SUCCESS != MPI_Reduce(&g_Times, &g_ReducedTimes, words,
+                                MPI_UINT64_T, MPI_SUM, 0, MPI_COMM_ROSS) ||
+      MPI_SUCCESS != MPI_Reduce(&countersEnabled, &everyCountersEnabled, 1,
+                                MPI_INT, MPI_MIN, 0, MPI_COMM_ROSS))
+    ispd_error("Handler profile could not be reduced, exiting...");
+
+  g_ReducedCountersEnabled = everyCountersEnabled != 0;
+
+  /// The clock ticks are calibrated by the master node along the whole run.
+  const std::chrono::duration<double, std::nano> elapsed =
+      std::chrono::steady_clock::now() - g_StartTime;
+  const std::uint64_t ticks = ispd::profiling::readClock() - g_StartTicks;
+
+  if (elapsed.count() > 0.0)
+    g_TicksPerNanosecond = static_cast<double>(ticks) / elapsed.count();
+}
+
+/// \brief Returns the average time (in nanoseconds) taken by a handler.
+static double getAverageTime(const std::size_t type, const std::size_t kind) {
+  const double ticks = static_cast<double>(g_ReducedTimes.m_Ticks[type][kind]);
+  const double samples =
+      static_cast<double>(g_ReducedTimes.m_Samples[type][kind]);
+
+  return ticks / samples / g_TicksPerNanosecond;
+}
+
+/// \brief Returns the average increment of a hardware performance counter
+///        during a handler.
+static double getAverageCounter(const std::size_t type, const std::size_t kind,
+                                const std::size_t counter) {
+  const double total =
+      static_cast<double>(g_ReducedTimes.m_Counters[type][kind][counter]);
+  const double samples =
+      static_cast<double>(g_ReducedTimes.m_Samples[type][kind]);
+
+  return total / samples;
+}
+
+void report() {
+  if (g_tw_mynode)
+    return;
+
+  ispd_info("Handler Profile (1 out of %lu calls measured, %.3lf ticks/ns)",
+            g_SampleMask + 1, g_TicksPerNanosecond);
+
+  for (const auto serviceType : ispd::services::g_ServiceTypes) {
+    const auto type = static_cast<std::size_t>(serviceType);
+    const char *name = ispd::services::getServiceTypeName<true>(serviceType);
+
+    const double avgForwardTime = getAverageTime(type, 0);
+    const double avgReverseTime = getAverageTime(type, 1);
+
+    ispd_info(" %s Forward: %lu calls, %lf ns avg.; Reverse: %lu calls, %lf "
+              "ns avg.; Forward/Reverse: %lfx.",
+              name, g_ReducedTimes.m_Calls[type][0], avgForwardTime,
+              g_ReducedTimes.m_Calls[type][1], avgReverseTime,
+              avgForwardTime / avgReverseTime);
+
+    if (!g_ReducedCountersEnabled)
+      continue;
+
+    static constexpr const char *kindNames[] = {"Forward", "Reverse"};
+
+    for (std::size_t kind = 0; kind < g_ProfiledHandlerKinds; kind++)
+      ispd_info("  %s: %.1lf cycles, %.1lf instructions (IPC %.2lf), %.2lf "
+                "LLC misses and %.2lf branch misses avg.",
+                kindNames[kind], getAverageCounter(type, kind, 0),
+                getAverageCounter(type, kind, 1),
+                getAverageCounter(type, kind, 1) /
+                    getAverageCounter(type, kind, 0),
+                getAverageCounter(type, kind, 2),
+                getAverageCounter(type, kind, 3));
+  }
+
+  if (!g_ReducedCountersEnabled)
+    ispd_info(" The hardware performance counters are not available at every "
+              "PE.");
+
+  ispd_info("");
+}
+
+void write(ispd::report::JsonWriter &json) {
+  static constexpr const char *kindNames[] = {"forward", "reverse"};
+
+  json.field("sample_period", g_SampleMask + 1);
+  json.field("ticks_per_ns", g_TicksPerNanosecond);
+  json.field("counters", g_ReducedCountersEnabled);
+
+  for (const auto serviceType : ispd::services::g_ServiceTypes) {
+    const auto type = static_cast<std::size_t>(serviceType);
+
+    json.beginObject(ispd::services::getServiceTypeName(serviceType));
+    for (std::size_t kind = 0; kind < g_ProfiledHandlerKinds; kind++) {
+      json.beginObject(kindNames[kind]);
+      json.field("calls", g_ReducedTimes.m_Calls[type][kind]);
+      json.field("samples", g_ReducedTimes.m_Samples[type][kind]);
+      json.field("avg_ns", getAverageTime(type, kind));
+
+      if (g_ReducedCountersEnabled)
+        for (std::size_t counter = 0; counter < g_ProfiledCounters; counter++)
+          json.field(std::string("avg_") + g_CounterNames[counter],
+                     getAverageCounter(type, kind, counter));
+
+      json.endObject();
+    }
+    json.endObject();
+  }
+}
+
+}; // namespace ispd::handler_profile
+#endif // ISPD_PROFILE_HANDLERS
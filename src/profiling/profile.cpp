@@ -0,0 +1,311 @@
+#include <mpi.h>
+#include <cstdio>
+#include <cstring>
+#include <ispd/log/log.hpp>
+#include <ispd/model/builder.hpp>
+#include <ispd/mapping/mapping.hpp>
+#include <ispd/profiling/profile.hpp>
+
+namespace ispd::lp_profile {
+
+/// \brief The profile file format version.
+static constexpr std::uint32_t PROFILE_VERSION = 2;
+
+ispd::profiling::LpCounters *g_Counters = nullptr;
+
+/// \brief The amount of local logical processes.
+static tw_lpid g_LocalCount = 0;
+
+/// \brief The prefix of the profile file to be dumped. Empty if no profile
+///        should be dumped.
+static std::string g_DumpPrefix;
+
+/// \brief The records to be dumped.
+static std::vector<ispd::profiling::ProfileRecord> g_Records;
+
+/// \brief The amount of hottest logical processes reported by each metric.
+static unsigned g_HotLpCount = 0;
+
+/// \brief The hottest logical processes of each metric, hottest first, only
+///        kept at the master node.
+static std::vector<ispd::profiling::HotLp>
+    g_HotLps[ispd::profiling::g_HotLpMetrics];
+
+/// \brief The metrics' names, indexed by `HotLpMetric`.
+static constexpr const char *g_HotLpMetricNames[] = {"forward", "reverse",
+                                                     "committed", "max_wait"};
+
+static_assert(std::size(g_HotLpMetricNames) == ispd::profiling::g_HotLpMetrics);
+
+void init(const tw_lpid localCount, const std::string &dumpPrefix,
+          const unsigned hotLps) {
+  g_LocalCount = localCount;
+  g_Counters = new ispd::profiling::LpCounters[localCount]();
+  g_DumpPrefix = dumpPrefix;
+  g_HotLpCount = hotLps;
+
+  if (!g_DumpPrefix.empty())
+    g_Records.reserve(localCount);
+}
+
+void record(const tw_lp *lp) {
+  if (g_DumpPrefix.empty())
+    return;
+
+  const auto &counters = g_Counters[lp->id];
+  g_Records.push_back(ispd::profiling::ProfileRecord{
+      lp->gid, counters.m_Forward - counters.m_Reverse, counters.m_Reverse});
+}
+
+/// \brief Reports the ratio between the heaviest processing element's load
+///        and the average processing element's load.
+///
+/// The load of a processing element is the amount of committed events by its
+/// logical processes. A perfectly balanced run has a ratio of 1.0.
+static void reportLoadImbalance() {
+  std::uint64_t committed = 0;
+  std::uint64_t rolledBack = 0;
+
+  for (tw_lpid i = 0; i < g_LocalCount; i++) {
+    committed += g_Counters[i].m_Forward - g_Counters[i].m_Reverse;
+    rolledBack += g_Counters[i].m_Reverse;
+  }
+
+  std::uint64_t heaviest, total, totalRolledBack;
+  MPI_Reduce(&committed, &heaviest, 1, MPI_UINT64_T, MPI_MAX, 0,
+             MPI_COMM_ROSS);
+  MPI_Reduce(&committed, &total, 1, MPI_UINT64_T, MPI_SUM, 0, MPI_COMM_ROSS);
+  MPI_Reduce(&rolledBack, &totalRolledBack, 1, MPI_UINT64_T, MPI_SUM, 0,
+             MPI_COMM_ROSS);
+
+  if (g_tw_mynode == 0) {
+    const double average = static_cast<double>(total) / tw_nnodes();
+    const double imbalance =
+        average > 0.0 ? static_cast<double>(heaviest) / average : 1.0;
+
+    ispd_info("PE load imbalance ratio is %.3lf (Committed Events: %lu, "
+              "Heaviest PE: %lu, Rolled Back Events: %lu).",
+              imbalance, total, heaviest, totalRolledBack);
+  }
+}
+
+/// \brief Returns the specified metric of a local logical process.
+static double getMetric(const tw_lpid local, const std::size_t metric) {
+  const auto &counters = g_Counters[local];
+
+  switch (static_cast<ispd::profiling::HotLpMetric>(metric)) {
+  case ispd::profiling::HotLpMetric::FORWARD:
+    return static_cast<double>(counters.m_Forward);
+  case ispd::profiling::HotLpMetric::REVERSE:
+    return static_cast<double>(counters.m_Reverse);
+  case ispd::profiling::HotLpMetric::COMMITTED:
+    return static_cast<double>(counters.m_Forward - counters.m_Reverse);
+  case ispd::profiling::HotLpMetric::MAX_WAIT:
+    return counters.m_MaxWait;
+  }
+
+  return 0.0;
+}
+
+/// \brief Orders the logical processes from the hottest to the coldest, and
+///        by global identifier among equally hot ones.
+static bool isHotter(const ispd::profiling::HotLp &a,
+                     const ispd::profiling::HotLp &b) {
+  return a.m_Value > b.m_Value || (a.m_Value == b.m_Value && a.m_Gid < b.m_Gid);
+}
+
+/// \brief Gathers the hottest logical processes of each metric at the master
+///        node.
+///
+/// Each node only sends its own hottest logical processes, since the global
+/// hottest ones must be among them.
+static void gatherHotLps() {
+  using ispd::profiling::HotLp;
+
+  const std::size_t count = g_HotLpCount;
+  std::vector<HotLp> local(count * ispd::profiling::g_HotLpMetrics);
+
+  for (std::size_t metric = 0; metric < ispd::profiling::g_HotLpMetrics;
+       metric++) {
+    std::vector<HotLp> candidates;
+    candidates.reserve(g_LocalCount);
+
+    for (tw_lpid i = 0; i < g_LocalCount; i++)
+      candidates.push_back(
+          HotLp{getMetric(i, metric), ispd::lp_mapping::getLocalGid(i)});
+
+    const std::size_t kept = std::min(count, candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + kept,
+                      candidates.end(), isHotter);
+
+    /// The missing logical processes are padded by ones that are never
+    /// reported.
+    for (std::size_t i = 0; i < count; i++)
+      local[metric * count + i] =
+          i < kept ? candidates[i] : HotLp{-1.0, ~std::uint64_t{0}};
+  }
+
+  const int bytes = static_cast<int>(local.size() * sizeof(HotLp));
+  std::vector<HotLp> gathered;
+  if (g_tw_mynode == 0)
+    gathered.resize(local.size() * tw_nnodes());
+
+  if (MPI_SUCCESS != MPI_Gather(local.data(), bytes, MPI_BYTE,
+                                gathered.data(), bytes, MPI_BYTE, 0,
+                                MPI_COMM_ROSS))
+    ispd_error("Hottest LPs could not be gathered, exiting...");
+
+  if (g_tw_mynode)
+    return;
+
+  for (std::size_t metric = 0; metric < ispd::profiling::g_HotLpMetrics;
+       metric++) {
+    auto &hottest = g_HotLps[metric];
+
+    for (tw_peid pe = 0; pe < tw_nnodes(); pe++)
+      for (std::size_t i = 0; i < count; i++) {
+        const auto &lp = gathered[(pe * ispd::profiling::g_HotLpMetrics +
+                                   metric) * count + i];
+        if (lp.m_Value >= 0.0)
+          hottest.push_back(lp);
+      }
+
+    const std::size_t kept = std::min(count, hottest.size());
+    std::partial_sort(hottest.begin(), hottest.begin() + kept, hottest.end(),
+                      isHotter);
+    hottest.resize(kept);
+  }
+}
+
+/// \brief Reports the hottest logical processes of each metric.
+static void reportHotLps() {
+  ispd_info("Hottest LPs (Top %u)", g_HotLpCount);
+
+  for (std::size_t metric = 0; metric < ispd::profiling::g_HotLpMetrics;
+       metric++) {
+    ispd_info(" By %s", g_HotLpMetricNames[metric]);
+
+    for (const auto &lp : g_HotLps[metric])
+      ispd_info("  %s %lu: %lf",
+                ispd::services::getServiceTypeName<true>(
+                    ispd::this_model::getServiceType(lp.m_Gid)),
+                lp.m_Gid, lp.m_Value);
+  }
+
+  ispd_info("");
+}
+
+void writeHotLps(ispd::report::JsonWriter &json) {
+  for (std::size_t metric = 0; metric < ispd::profiling::g_HotLpMetrics;
+       metric++) {
+    json.beginArray(g_HotLpMetricNames[metric]);
+
+    for (const auto &lp : g_HotLps[metric]) {
+      json.beginObject();
+      json.field("gid", lp.m_Gid);
+      json.field("type", ispd::services::getServiceTypeName(
+                             ispd::this_model::getServiceType(lp.m_Gid)));
+      json.field("value", lp.m_Value);
+      json.endObject();
+    }
+
+    json.endArray();
+  }
+}
+
+/// \brief Writes the recorded counters to this rank's profile file.
+static void dump() {
+  const std::string filepath =
+      g_DumpPrefix + "." + std::to_string(g_tw_mynode) + ".bin";
+  std::FILE *file = std::fopen(filepath.c_str(), "wb");
+
+  /// Checks if the profile file could not be opened. If so, the program is
+  /// immediately aborted.
+  if (!file)
+    ispd_error("Profile file %s could not be opened.", filepath.c_str());
+
+  ispd::profiling::ProfileHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.m_Magic, "ISPDPRF", 8);
+  header.m_Version = PROFILE_VERSION;
+  header.m_Rank = static_cast<std::uint32_t>(g_tw_mynode);
+  header.m_RankCount = static_cast<std::uint32_t>(tw_nnodes());
+  header.m_Count = g_Records.size();
+
+  if (std::fwrite(&header, sizeof(header), 1, file) != 1 ||
+      std::fwrite(g_Records.data(), sizeof(ispd::profiling::ProfileRecord),
+                  g_Records.size(), file) != g_Records.size())
+    ispd_error("Profile file %s could not be written.", filepath.c_str());
+
+  std::fclose(file);
+}
+
+void finish() {
+  reportLoadImbalance();
+
+  if (g_HotLpCount > 0) {
+    gatherHotLps();
+
+    if (g_tw_mynode == 0)
+      reportHotLps();
+  }
+
+  if (!g_DumpPrefix.empty())
+    dump();
+}
+
+auto load(const std::string &prefix)
+    -> std::vector<ispd::profiling::ProfileRecord> {
+  std::vector<ispd::profiling::ProfileRecord> records;
+
+  /// The amount of files is given by the first file's header, so that the
+  /// stale files left by an earlier run with more ranks are not loaded.
+  std::uint32_t rankCount = 1;
+
+  for (std::uint32_t rank = 0; rank < rankCount; rank++) {
+    const std::string filepath =
+        prefix + "." + std::to_string(rank) + ".bin";
+    std::FILE *file = std::fopen(filepath.c_str(), "rb");
+
+    /// Checks if the profile file could not be opened. If so, the program is
+    /// immediately aborted, since the profile would be incomplete.
+    if (!file)
+      ispd_error("Profile file %s could not be opened.", filepath.c_str());
+
+    ispd::profiling::ProfileHeader header;
+    if (std::fread(&header, sizeof(header), 1, file) != 1 ||
+        std::memcmp(header.m_Magic, "ISPDPRF", 8) != 0)
+      ispd_error("Profile file %s is not a valid profile.", filepath.c_str());
+
+    if (header.m_Version != PROFILE_VERSION)
+      ispd_error("Profile file %s has version %u but version %u is expected.",
+                 filepath.c_str(), header.m_Version, PROFILE_VERSION);
+
+    if (rank == 0)
+      rankCount = header.m_RankCount;
+
+    /// Checks if the file has been written by another rank or by a run with
+    /// another amount of ranks. If so, the program is immediately aborted,
+    /// since the files of different runs would be mixed.
+    if (header.m_Rank != rank || header.m_RankCount != rankCount ||
+        rankCount == 0)
+      ispd_error("Profile file %s has been written by rank %u of %u, but rank "
+                 "%u of %u is expected.",
+                 filepath.c_str(), header.m_Rank, header.m_RankCount, rank,
+                 rankCount);
+
+    const auto offset = records.size();
+    records.resize(offset + header.m_Count);
+
+    if (std::fread(records.data() + offset,
+                   sizeof(ispd::profiling::ProfileRecord), header.m_Count,
+                   file) != header.m_Count)
+      ispd_error("Profile file %s is truncated.", filepath.c_str());
+
+    std::fclose(file);
+  }
+
+  return records;
+}
+
+}; // namespace ispd::lp_profile
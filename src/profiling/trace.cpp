@@ -0,0 +1,260 @@
+#include <ispd/profiling/trace.hpp>
+
+#ifdef ISPD_TRACE
+#include <mpi.h>
+#include <cstdio>
+#include <vector>
+#include <ispd/log/log.hpp>
+
+namespace ispd::trace {
+
+using ispd::profiling::HandlerBatch;
+using ispd::profiling::TraceLane;
+using ispd::profiling::TraceSpan;
+
+bool g_Enabled = false;
+HandlerBatch g_Batch = {};
+std::uint64_t g_MaxGap = 0;
+unsigned long long g_GvtDone = 0;
+
+/// \brief The trace's file path.
+static std::string g_Filepath;
+
+/// \brief The recorded spans and their maximum amount.
+static std::vector<TraceSpan> g_Spans;
+static std::size_t g_Capacity = 0;
+
+/// \brief The amount of spans dropped because the buffer was full.
+static std::uint64_t g_Dropped = 0;
+
+/// \brief The time at which the trace has been started.
+static std::chrono::steady_clock::time_point g_Origin;
+
+/// \brief The batches' names, indexed by service type and by handler kind.
+static constexpr const char *g_BatchNames[][2] = {
+    {"Forward Master", "Rollback Master"},
+    {"Forward Link", "Rollback Link"},
+    {"Forward Machine", "Rollback Machine"},
+    {"Forward Switch", "Rollback Switch"},
+};
+
+static_assert(std::size(g_BatchNames) == ispd::services::g_ServiceTypes.size());
+
+/// \brief The lanes' names, indexed by lane.
+static constexpr const char *g_LaneNames[] = {"Handlers", "Engine", "MPI"};
+
+void init(const std::string &filepath, const unsigned capacity,
+          const double maxGap) {
+  if (filepath.empty())
+    return;
+
+  g_Filepath = filepath;
+  g_Capacity = capacity;
+  g_Spans.reserve(capacity);
+  g_MaxGap = static_cast<std::uint64_t>(maxGap * 1e3);
+
+  /// The ranks' steady clocks are unrelated. Therefore, every rank starts its
+  /// clock right after a barrier, which aligns them up to the barrier's skew.
+  MPI_Barrier(MPI_COMM_ROSS);
+  g_Origin = std::chrono::steady_clock::now();
+  g_Enabled = true;
+}
+
+std::uint64_t now() noexcept {
+  const std::chrono::duration<std::uint64_t, std::nano> elapsed =
+      std::chrono::steady_clock::now() - g_Origin;
+  return elapsed.count();
+}
+
+void record(const char *name, const TraceLane lane, const std::uint64_t start,
+            const std::uint64_t end, const std::uint64_t count) noexcept {
+  if (g_Spans.size() == g_Capacity) {
+    g_Dropped++;
+    return;
+  }
+
+  g_Spans.push_back(TraceSpan{name, lane, start, end, count});
+}
+
+void flushBatch(const HandlerBatch &next) noexcept {
+  if (g_Batch.m_Count > 0)
+    record(g_BatchNames[static_cast<std::size_t>(g_Batch.m_Type)]
+                      [static_cast<std::size_t>(g_Batch.m_Kind)],
+           TraceLane::HANDLERS, g_Batch.m_Start, g_Batch.m_End,
+           g_Batch.m_Count);
+
+  /// If a GVT has been computed since the current batch has begun, then it
+  /// has been computed between the two batches, in which this PE has handled
+  /// no event.
+  if (g_tw_gvt_done != g_GvtDone) {
+    if (g_Batch.m_Count > 0)
+      record("GVT", TraceLane::ENGINE, g_Batch.m_End, next.m_Start,
+             g_tw_gvt_done - g_GvtDone);
+    g_GvtDone = g_tw_gvt_done;
+  }
+
+  g_Batch = next;
+}
+
+/// \brief Formats a span as a Chrome trace event.
+static void appendSpan(std::string &out, const TraceSpan &span) {
+  char buffer[256];
+
+  std::snprintf(buffer, sizeof(buffer),
+                ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":%lu,\"tid\":%d,"
+                "\"ts\":%.3lf,\"dur\":%.3lf,\"args\":{\"events\":%lu}}",
+                span.m_Name, static_cast<unsigned long>(g_tw_mynode),
+                static_cast<int>(span.m_Lane), span.m_Start * 1e-3,
+                (span.m_End - span.m_Start) * 1e-3,
+                static_cast<unsigned long>(span.m_Count));
+  out += buffer;
+}
+
+/// \brief Formats the names of this rank's process and lanes.
+static void appendNames(std::string &out) {
+  char buffer[256];
+
+  std::snprintf(buffer, sizeof(buffer),
+                ",\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%lu,"
+                "\"args\":{\"name\":\"PE %lu\"}}",
+                static_cast<unsigned long>(g_tw_mynode),
+                static_cast<unsigned long>(g_tw_mynode));
+  out += buffer;
+
+  for (std::size_t lane = 0; lane < std::size(g_LaneNames); lane++) {
+    std::snprintf(buffer, sizeof(buffer),
+                  ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%lu,"
+                  "\"tid\":%zu,\"args\":{\"name\":\"%s\"}}",
+                  static_cast<unsigned long>(g_tw_mynode), lane,
+                  g_LaneNames[lane]);
+    out += buffer;
+  }
+}
+
+void finish() {
+  if (!g_Enabled)
+    return;
+
+  /// The trace's own collectives are not recorded.
+  flushBatch(HandlerBatch{});
+  g_Enabled = false;
+
+  std::string out;
+  appendNames(out);
+  for (const auto &span : g_Spans)
+    appendSpan(out, span);
+
+  /// Every event is preceded by a separator, except for the file's first one.
+  /// Hence, the first rank replaces its first separator by the array's start
+  /// and the last rank ends the array.
+  if (g_tw_mynode == 0)
+    out.replace(0, 1, "[");
+  if (g_tw_mynode == tw_nnodes() - 1)
+    out += "\n]\n";
+
+  /// The text of each rank is placed after the text of the ranks that
+  /// precede it.
+  unsigned long size = out.size();
+  unsigned long offset = 0;
+  MPI_Exscan(&size, &offset, 1, MPI_UNSIGNED_LONG, MPI_SUM, MPI_COMM_ROSS);
+
+  /// The exclusive prefix sum is undefined at the first rank.
+  if (g_tw_mynode == 0)
+    offset = 0;
+
+  MPI_File file;
+  if (MPI_SUCCESS != MPI_File_open(MPI_COMM_ROSS, g_Filepath.c_str(),
+                                   MPI_MODE_CREATE | MPI_MODE_WRONLY,
+                                   MPI_INFO_NULL, &file))
+    ispd_error("Trace file %s could not be opened.", g_Filepath.c_str());
+
+  /// Truncate any previous contents of the file.
+  MPI_File_set_size(file, 0);
+
+  if (MPI_SUCCESS != MPI_File_write_at_all(file, offset, out.data(),
+                                           static_cast<int>(size), MPI_BYTE,
+                                           MPI_STATUS_IGNORE))
+    ispd_error("Trace file %s could not be written.", g_Filepath.c_str());
+
+  MPI_File_close(&file);
+
+  std::uint64_t spans = g_Spans.size();
+  std::uint64_t counts[] = {spans, g_Dropped};
+  std::uint64_t totals[std::size(counts)];
+  MPI_Reduce(counts, totals, std::size(counts), MPI_UINT64_T, MPI_SUM, 0,
+             MPI_COMM_ROSS);
+
+  if (g_tw_mynode == 0)
+    ispd_info("The trace has been written to %s (Spans: %lu, Dropped Spans: "
+              "%lu).",
+              g_Filepath.c_str(), totals[0], totals[1]);
+}
+
+}; // namespace ispd::trace
+
+using ispd::profiling::TraceLane;
+
+/// The blocking MPI calls are intercepted through MPI's profiling interface,
+/// in which every MPI function is also available with the `PMPI_` prefix.
+/// Therefore, the calls made by ROSS are recorded without changing it.
+extern "C" {
+
+int MPI_Allreduce(const void *sendbuf, void *recvbuf, int count,
+                  MPI_Datatype datatype, MPI_Op op, MPI_Comm comm) {
+  if (!ispd::trace::g_Enabled)
+    return PMPI_Allreduce(sendbuf, recvbuf, count, datatype, op, comm);
+
+  const std::uint64_t start = ispd::trace::now();
+  const int result =
+      PMPI_Allreduce(sendbuf, recvbuf, count, datatype, op, comm);
+  ispd::trace::record("MPI_Allreduce", TraceLane::MPI, start,
+                      ispd::trace::now());
+  return result;
+}
+
+int MPI_Reduce(const void *sendbuf, void *recvbuf, int count,
+               MPI_Datatype datatype, MPI_Op op, int root, MPI_Comm comm) {
+  if (!ispd::trace::g_Enabled)
+    return PMPI_Reduce(sendbuf, recvbuf, count, datatype, op, root, comm);
+
+  const std::uint64_t start = ispd::trace::now();
+  const int result =
+      PMPI_Reduce(sendbuf, recvbuf, count, datatype, op, root, comm);
+  ispd::trace::record("MPI_Reduce", TraceLane::MPI, start, ispd::trace::now());
+  return result;
+}
+
+int MPI_Barrier(MPI_Comm comm) {
+  if (!ispd::trace::g_Enabled)
+    return PMPI_Barrier(comm);
+
+  const std::uint64_t start = ispd::trace::now();
+  const int result = PMPI_Barrier(comm);
+  ispd::trace::record("MPI_Barrier", TraceLane::MPI, start,
+                      ispd::trace::now());
+  return result;
+}
+
+int MPI_Wait(MPI_Request *request, MPI_Status *status) {
+  if (!ispd::trace::g_Enabled)
+    return PMPI_Wait(request, status);
+
+  const std::uint64_t start = ispd::trace::now();
+  const int result = PMPI_Wait(request, status);
+  ispd::trace::record("MPI_Wait", TraceLane::MPI, start, ispd::trace::now());
+  return result;
+}
+
+int MPI_Waitall(int count, MPI_Request requests[], MPI_Status statuses[]) {
+  if (!ispd::trace::g_Enabled)
+    return PMPI_Waitall(count, requests, statuses);
+
+  const std::uint64_t start = ispd::trace::now();
+  const int result = PMPI_Waitall(count, requests, statuses);
+  ispd::trace::record("MPI_Waitall", TraceLane::MPI, start,
+                      ispd::trace::now());
+  return result;
+}
+
+} // extern "C"
+#endif // ISPD_TRACE
@@ -0,0 +1,180 @@
+#include <mpi.h>
+#include <vector>
+#include <algorithm>
+#include <ispd/log/log.hpp>
+#include <ispd/profiling/traffic.hpp>
+
+namespace ispd::traffic {
+
+using ispd::profiling::g_TrafficServiceTypes;
+using ispd::profiling::TrafficEntry;
+using ispd::profiling::TypeTraffic;
+
+/// \brief The amount of the heaviest matrix entries that are reported.
+static constexpr std::size_t REPORTED_ENTRIES = 10;
+
+bool g_Enabled = false;
+std::uint64_t *g_FromPe = nullptr;
+TypeTraffic g_ByType[g_TrafficServiceTypes][g_TrafficServiceTypes] = {};
+
+/// \brief The gathered non-zero matrix entries, ordered by receiver and by
+///        sender, only kept at the master node.
+static std::vector<TrafficEntry> g_Matrix;
+
+/// \brief The reduced service types' traffic, only kept at the master node.
+static TypeTraffic g_ReducedByType[g_TrafficServiceTypes]
+                                  [g_TrafficServiceTypes] = {};
+
+void init(const bool enabled) {
+  g_Enabled = enabled;
+
+  if (g_Enabled)
+    g_FromPe = new std::uint64_t[tw_nnodes()]();
+}
+
+void reduce() {
+  if (!g_Enabled)
+    return;
+
+  /// Each node only sends its non-zero entries, which are few if the
+  /// partitioning is any good.
+  std::vector<TrafficEntry> entries;
+  for (tw_peid pe = 0; pe < tw_nnodes(); pe++)
+    if (g_FromPe[pe] > 0)
+      entries.push_back(TrafficEntry{pe, g_tw_mynode, g_FromPe[pe]});
+
+  constexpr int entryWords = sizeof(TrafficEntry) / sizeof(std::uint64_t);
+  const int words = static_cast<int>(entries.size()) * entryWords;
+
+  std::vector<int> counts, displacements;
+  if (g_tw_mynode == 0)
+    counts.resize(tw_nnodes());
+
+  if (MPI_SUCCESS != MPI_Gather(&words, 1, MPI_INT, counts.data(), 1, MPI_INT,
+                                0, MPI_COMM_ROSS))
+    ispd_error("Traffic matrix could not be gathered, exiting...");
+
+  if (g_tw_mynode == 0) {
+    int total = 0;
+    for (const int count : counts) {
+      displacements.push_back(total);
+      total += count;
+    }
+    g_Matrix.resize(total / entryWords);
+  }
+
+  constexpr int typeWords =
+      sizeof(g_ByType) / sizeof(std::uint64_t);
+
+  if (MPI_SUCCESS != MPI_Gatherv(entries.data(), words, MPI_UINT64_T,
+                                 g_Matrix.data(), counts.data(),
+                                 displacements.data(), MPI_UINT64_T, 0,
+                                 MPI_COMM_ROSS) ||
+      MPI_SUCCESS != MPI_Reduce(g_ByType, g_ReducedByType, typeWords,
+                                MPI_UINT64_T, MPI_SUM, 0, MPI_COMM_ROSS))
+    ispd_error("Traffic profile could not be reduced, exiting...");
+}
+
+/// \brief Returns the committed events sent by the specified service type.
+static TypeTraffic getSentTraffic(const std::size_t from) {
+  TypeTraffic sent = {};
+
+  for (std::size_t to = 0; to < g_TrafficServiceTypes; to++) {
+    sent.m_Local += g_ReducedByType[from][to].m_Local;
+    sent.m_Remote += g_ReducedByType[from][to].m_Remote;
+  }
+
+  return sent;
+}
+
+/// \brief Returns the ratio of remote events among the specified traffic.
+static double getRemoteRatio(const TypeTraffic &traffic) {
+  const auto total = traffic.m_Local + traffic.m_Remote;
+  return total ? static_cast<double>(traffic.m_Remote) / total : 0.0;
+}
+
+void report() {
+  if (!g_Enabled || g_tw_mynode)
+    return;
+
+  TypeTraffic overall = {};
+
+  ispd_info("Cross-PE Traffic");
+  for (const auto serviceType : ispd::services::g_ServiceTypes) {
+    const auto sent = getSentTraffic(static_cast<std::size_t>(serviceType));
+
+    overall.m_Local += sent.m_Local;
+    overall.m_Remote += sent.m_Remote;
+
+    ispd_info(" %s: %lu committed sends, %lu remote (%.2lf%%).",
+              ispd::services::getServiceTypeName<true>(serviceType),
+              sent.m_Local + sent.m_Remote, sent.m_Remote,
+              100.0 * getRemoteRatio(sent));
+  }
+
+  ispd_info(" Overall: %lu committed sends, %lu remote (%.2lf%%).",
+            overall.m_Local + overall.m_Remote, overall.m_Remote,
+            100.0 * getRemoteRatio(overall));
+
+  /// The heaviest remote entries are the first candidates to be placed
+  /// together by a better partitioning.
+  std::vector<TrafficEntry> heaviest;
+  for (const auto &entry : g_Matrix)
+    if (entry.m_From != entry.m_To)
+      heaviest.push_back(entry);
+
+  const std::size_t reported = std::min(heaviest.size(), REPORTED_ENTRIES);
+  std::partial_sort(heaviest.begin(), heaviest.begin() + reported,
+                    heaviest.end(), [](const auto &a, const auto &b) {
+                      return a.m_Events > b.m_Events;
+                    });
+
+  for (std::size_t i = 0; i < reported; i++)
+    ispd_info("  PE %lu -> PE %lu: %lu events.", heaviest[i].m_From,
+              heaviest[i].m_To, heaviest[i].m_Events);
+
+  ispd_info("");
+}
+
+void write(ispd::report::JsonWriter &json) {
+  json.beginArray("matrix");
+  for (const auto &entry : g_Matrix) {
+    json.beginObject();
+    json.field("from", entry.m_From);
+    json.field("to", entry.m_To);
+    json.field("events", entry.m_Events);
+    json.endObject();
+  }
+  json.endArray();
+
+  json.beginObject("types");
+  for (const auto from : ispd::services::g_ServiceTypes) {
+    const auto fromIndex = static_cast<std::size_t>(from);
+    const auto sent = getSentTraffic(fromIndex);
+
+    json.beginObject(ispd::services::getServiceTypeName(from));
+    json.field("local_events", sent.m_Local);
+    json.field("remote_events", sent.m_Remote);
+    json.field("remote_ratio", getRemoteRatio(sent));
+
+    json.beginObject("to");
+    for (const auto to : ispd::services::g_ServiceTypes) {
+      const auto &traffic =
+          g_ReducedByType[fromIndex][static_cast<std::size_t>(to)];
+
+      if (traffic.m_Local + traffic.m_Remote == 0)
+        continue;
+
+      json.beginObject(ispd::services::getServiceTypeName(to));
+      json.field("local_events", traffic.m_Local);
+      json.field("remote_events", traffic.m_Remote);
+      json.endObject();
+    }
+    json.endObject();
+
+    json.endObject();
+  }
+  json.endObject();
+}
+
+}; // namespace ispd::traffic
@@ -0,0 +1,130 @@
+#include <cmath>
+#include <cinttypes>
+#include <ispd/report/json.hpp>
+
+namespace ispd::report {
+
+void JsonWriter::writeSeparator() {
+  /// The key has already written the separator of a member.
+  if (m_AfterKey) {
+    m_AfterKey = false;
+    return;
+  }
+
+  if (m_HasElements.back())
+    std::fputc(',', m_File);
+
+  if (m_HasElements.size() > 1)
+    std::fprintf(m_File, "\n%*s", static_cast<int>(2 * (m_HasElements.size() - 1)), "");
+
+  m_HasElements.back() = true;
+}
+
+void JsonWriter::writeKey(const std::string_view key) {
+  writeSeparator();
+  writeString(key);
+  std::fputs(": ", m_File);
+  m_AfterKey = true;
+}
+
+void JsonWriter::writeString(const std::string_view value) {
+  std::fputc('"', m_File);
+
+  for (const char c : value) {
+    switch (c) {
+    case '"':
+      std::fputs("\\\"", m_File);
+      break;
+    case '\\':
+      std::fputs("\\\\", m_File);
+      break;
+    case '\n':
+      std::fputs("\\n", m_File);
+      break;
+    case '\t':
+      std::fputs("\\t", m_File);
+      break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20)
+        std::fprintf(m_File, "\\u%04x", c);
+      else
+        std::fputc(c, m_File);
+    }
+  }
+
+  std::fputc('"', m_File);
+}
+
+void JsonWriter::beginObject() {
+  writeSeparator();
+  std::fputc('{', m_File);
+  m_HasElements.push_back(false);
+}
+
+void JsonWriter::beginObject(const std::string_view key) {
+  writeKey(key);
+  beginObject();
+}
+
+void JsonWriter::endObject() {
+  const bool hasElements = m_HasElements.back();
+  m_HasElements.pop_back();
+
+  if (hasElements)
+    std::fprintf(m_File, "\n%*s", static_cast<int>(2 * (m_HasElements.size() - 1)), "");
+
+  std::fputc('}', m_File);
+
+  /// The document is ended with a new line.
+  if (m_HasElements.size() == 1)
+    std::fputc('\n', m_File);
+}
+
+void JsonWriter::beginArray() {
+  writeSeparator();
+  std::fputc('[', m_File);
+  m_HasElements.push_back(false);
+}
+
+void JsonWriter::beginArray(const std::string_view key) {
+  writeKey(key);
+  beginArray();
+}
+
+void JsonWriter::endArray() {
+  const bool hasElements = m_HasElements.back();
+  m_HasElements.pop_back();
+
+  if (hasElements)
+    std::fprintf(m_File, "\n%*s", static_cast<int>(2 * (m_HasElements.size() - 1)), "");
+
+  std::fputc(']', m_File);
+}
+
+void JsonWriter::value(const double value) {
+  writeSeparator();
+
+  /// JSON has no representation for the non-finite numbers, such as the
+  /// averages of metrics without samples.
+  if (std::isfinite(value))
+    std::fprintf(m_File, "%.17g", value);
+  else
+    std::fputs("null", m_File);
+}
+
+void JsonWriter::value(const std::uint64_t value) {
+  writeSeparator();
+  std::fprintf(m_File, "%" PRIu64, value);
+}
+
+void JsonWriter::value(const std::string_view value) {
+  writeSeparator();
+  writeString(value);
+}
+
+void JsonWriter::value(const bool value) {
+  writeSeparator();
+  std::fputs(value ? "true" : "false", m_File);
+}
+
+}; // namespace ispd::report
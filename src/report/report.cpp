@@ -0,0 +1,309 @@
+#include <mpi.h>
+#include <cstdio>
+#include <chrono>
+#include <vector>
+#include <variant>
+#include <sys/resource.h>
+#include <ispd/log/log.hpp>
+#include <ispd/report/report.hpp>
+#include <ispd/metrics/metrics.hpp>
+
+namespace ispd::run_report {
+
+/// \brief The report file format version.
+static constexpr std::uint64_t REPORT_VERSION = 2;
+
+/// \brief A run configuration entry.
+using ConfigurationValue = std::variant<std::string, double, std::uint64_t>;
+
+/// \brief The run configuration, in the order it has been recorded.
+static std::vector<std::pair<std::string, ConfigurationValue>> g_Configuration;
+
+/// \struct Phase
+///
+/// \brief A phase measured at this node.
+struct Phase final {
+  std::string m_Name;           ///< The phase's name.
+  double m_Time;                ///< The wall-clock time (in seconds).
+  std::uint64_t m_PeakRssDelta; ///< The peak RSS' growth (in KiB).
+};
+
+/// \brief The phases, in the order they have begun.
+///
+/// \note Every node must begin the same phases in the same order, since they
+///       are reduced element-wise.
+static std::vector<Phase> g_Phases;
+
+/// \brief The wall-clock time at which the current phase has begun.
+///
+/// \note A steady clock is used instead of `MPI_Wtime`, since the first phase
+///       begins before MPI is initialized.
+static std::chrono::steady_clock::time_point g_PhaseStart;
+
+/// \brief The peak resident set size (in KiB) when the current phase has
+///        begun.
+static std::uint64_t g_PhaseStartRss;
+
+/// \brief Whether there is a current phase.
+static bool g_InPhase = false;
+
+/// \brief The sections appended by other modules.
+static std::vector<std::pair<std::string, ispd::report::ReportSection>>
+    g_Sections;
+
+/// \brief The reduced engine statistics, only kept at the master node.
+static ispd::report::EngineStatistics g_EngineStatistics;
+
+/// \brief The phases' minimum, maximum and total wall-clock times among the
+///        nodes, only kept at the master node.
+static std::vector<double> g_MinPhaseTimes;
+static std::vector<double> g_MaxPhaseTimes;
+static std::vector<double> g_TotalPhaseTimes;
+
+/// \brief The phases' maximum peak RSS' growths among the nodes, only kept at
+///        the master node.
+static std::vector<std::uint64_t> g_MaxPhaseRssDeltas;
+
+/// \brief The maximum and the sum of the nodes' peak resident set sizes (in
+///        KiB), only kept at the master node.
+static std::uint64_t g_MaxPeakRss = 0;
+static std::uint64_t g_TotalPeakRss = 0;
+
+void setConfiguration(const std::string &key, const std::string &value) {
+  g_Configuration.emplace_back(key, value);
+}
+
+void setConfiguration(const std::string &key, const double value) {
+  g_Configuration.emplace_back(key, value);
+}
+
+void setConfiguration(const std::string &key, const std::uint64_t value) {
+  g_Configuration.emplace_back(key, value);
+}
+
+/// \brief Returns this node's peak resident set size (in KiB).
+static std::uint64_t localPeakRss() {
+  struct rusage usage;
+
+  if (getrusage(RUSAGE_SELF, &usage))
+    return 0;
+
+  return static_cast<std::uint64_t>(usage.ru_maxrss);
+}
+
+void beginPhase(const std::string &name) {
+  endPhase();
+
+  g_Phases.push_back(Phase{name, 0.0, 0});
+  g_PhaseStartRss = localPeakRss();
+  g_PhaseStart = std::chrono::steady_clock::now();
+  g_InPhase = true;
+}
+
+void endPhase() {
+  if (!g_InPhase)
+    return;
+
+  const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - g_PhaseStart;
+  g_Phases.back().m_Time = elapsed.count();
+  g_Phases.back().m_PeakRssDelta = localPeakRss() - g_PhaseStartRss;
+  g_InPhase = false;
+}
+
+void addSection(const std::string &key, ispd::report::ReportSection section) {
+  g_Sections.emplace_back(key, std::move(section));
+}
+
+/// \brief Returns this node's engine statistics.
+static ispd::report::EngineStatistics localEngineStatistics() {
+  ispd::report::EngineStatistics stats{};
+
+  /// The events' processing and rollback counters are kept by the kernel
+  /// processes, whereas the network counters are kept by the processing
+  /// element. As in ROSS' own statistics, `s_e_rbs` counts the rolled back
+  /// events, while `s_rb_total` counts the rollbacks, of which the primary
+  /// ones are those that are not secondary.
+  for (tw_kpid i = 0; i < g_tw_nkp; i++) {
+    const tw_kp *const kp = g_tw_kp[i];
+
+    stats.m_ProcessedEvents += kp->s_nevent_processed;
+    stats.m_RolledBackEvents += kp->s_e_rbs;
+    stats.m_PrimaryRollbacks += kp->s_rb_total - kp->s_rb_secondary;
+    stats.m_SecondaryRollbacks += kp->s_rb_secondary;
+  }
+
+  stats.m_NetEvents = stats.m_ProcessedEvents - stats.m_RolledBackEvents;
+  stats.m_RemoteEvents = g_tw_pe->stats.s_nsend_net_remote;
+  stats.m_GvtComputations = g_tw_gvt_done;
+
+  return stats;
+}
+
+void collect() {
+  endPhase();
+
+  const auto stats = localEngineStatistics();
+
+  /// The counters are summed up, except for the GVT computations, which are
+  /// performed by every node together.
+  std::uint64_t summed[] = {stats.m_ProcessedEvents,    stats.m_NetEvents,
+                            stats.m_RolledBackEvents,   stats.m_PrimaryRollbacks,
+                            stats.m_SecondaryRollbacks, stats.m_RemoteEvents};
+  std::uint64_t reduced[std::size(summed)];
+
+  const std::uint64_t peakRss = localPeakRss();
+  std::vector<double> phaseTimes;
+  std::vector<std::uint64_t> phaseRssDeltas;
+  for (const auto &phase : g_Phases) {
+    phaseTimes.push_back(phase.m_Time);
+    phaseRssDeltas.push_back(phase.m_PeakRssDelta);
+  }
+
+  if (g_tw_mynode == 0) {
+    g_MinPhaseTimes.resize(phaseTimes.size());
+    g_MaxPhaseTimes.resize(phaseTimes.size());
+    g_TotalPhaseTimes.resize(phaseTimes.size());
+    g_MaxPhaseRssDeltas.resize(phaseRssDeltas.size());
+  }
+
+  const int phaseCount = static_cast<int>(phaseTimes.size());
+
+  if (MPI_SUCCESS != MPI_Reduce(summed, reduced, std::size(summed),
+                                MPI_UINT64_T, MPI_SUM, 0, MPI_COMM_ROSS) ||
+      MPI_SUCCESS != MPI_Reduce(&peakRss, &g_MaxPeakRss, 1, MPI_UINT64_T,
+                                MPI_MAX, 0, MPI_COMM_ROSS) ||
+      MPI_SUCCESS != MPI_Reduce(&peakRss, &g_TotalPeakRss, 1, MPI_UINT64_T,
+                                MPI_SUM, 0, MPI_COMM_ROSS) ||
+      MPI_SUCCESS != MPI_Reduce(phaseTimes.data(), g_MinPhaseTimes.data(),
+                                phaseCount, MPI_DOUBLE, MPI_MIN, 0,
+                                MPI_COMM_ROSS) ||
+      MPI_SUCCESS != MPI_Reduce(phaseTimes.data(), g_MaxPhaseTimes.data(),
+                                phaseCount, MPI_DOUBLE, MPI_MAX, 0,
+                                MPI_COMM_ROSS) ||
+      MPI_SUCCESS != MPI_Reduce(phaseTimes.data(), g_TotalPhaseTimes.data(),
+                                phaseCount, MPI_DOUBLE, MPI_SUM, 0,
+                                MPI_COMM_ROSS) ||
+      MPI_SUCCESS != MPI_Reduce(phaseRssDeltas.data(),
+                                g_MaxPhaseRssDeltas.data(), phaseCount,
+                                MPI_UINT64_T, MPI_MAX, 0, MPI_COMM_ROSS))
+    ispd_error("Run report could not be collected, exiting...");
+
+  if (g_tw_mynode)
+    return;
+
+  g_EngineStatistics.m_ProcessedEvents = reduced[0];
+  g_EngineStatistics.m_NetEvents = reduced[1];
+  g_EngineStatistics.m_RolledBackEvents = reduced[2];
+  g_EngineStatistics.m_PrimaryRollbacks = reduced[3];
+  g_EngineStatistics.m_SecondaryRollbacks = reduced[4];
+  g_EngineStatistics.m_RemoteEvents = reduced[5];
+  g_EngineStatistics.m_GvtComputations = stats.m_GvtComputations;
+}
+
+/// \brief Returns the maximum wall-clock time of the specified phase among the
+///        nodes, or zero if there is no such phase.
+static double getPhaseTime(const std::string &name) {
+  for (std::size_t i = 0; i < g_Phases.size(); i++)
+    if (g_Phases[i].m_Name == name)
+      return g_MaxPhaseTimes[i];
+
+  return 0.0;
+}
+
+static void writeEngineStatistics(ispd::report::JsonWriter &json) {
+  const auto &stats = g_EngineStatistics;
+  const double netEvents = static_cast<double>(stats.m_NetEvents);
+  const double runTime = getPhaseTime("run");
+
+  json.beginObject("engine");
+  json.field("processed_events", stats.m_ProcessedEvents);
+  json.field("net_events", stats.m_NetEvents);
+  json.field("rolled_back_events", stats.m_RolledBackEvents);
+  json.field("primary_rollbacks", stats.m_PrimaryRollbacks);
+  json.field("secondary_rollbacks", stats.m_SecondaryRollbacks);
+  json.field("remote_events", stats.m_RemoteEvents);
+  json.field("gvt_computations", stats.m_GvtComputations);
+
+  /// The efficiency follows ROSS' definition, that is, the percentage of the
+  /// committed events that have not been rolled back.
+  json.field("efficiency",
+             100.0 * (1.0 - static_cast<double>(stats.m_RolledBackEvents) /
+                                netEvents));
+  json.field("remote_event_ratio",
+             static_cast<double>(stats.m_RemoteEvents) / netEvents);
+  json.field("event_rate", netEvents / runTime);
+  json.endObject();
+}
+
+void report() {
+  if (g_tw_mynode)
+    return;
+
+  ispd_info("Phase Profile (seconds among %u ranks)",
+            static_cast<unsigned>(tw_nnodes()));
+  for (std::size_t i = 0; i < g_Phases.size(); i++)
+    ispd_info("  %-12s min %10.6lf, max %10.6lf, mean %10.6lf, peak RSS "
+              "delta %lu KiB",
+              g_Phases[i].m_Name.c_str(), g_MinPhaseTimes[i],
+              g_MaxPhaseTimes[i], g_TotalPhaseTimes[i] / tw_nnodes(),
+              g_MaxPhaseRssDeltas[i]);
+  ispd_info("");
+}
+
+void write(const std::string &filepath) {
+  if (g_tw_mynode || filepath.empty())
+    return;
+
+  std::FILE *file = std::fopen(filepath.c_str(), "w");
+
+  /// Checks if the report file could not be opened. If so, the program is
+  /// immediately aborted.
+  if (!file)
+    ispd_error("Run report file %s could not be opened.", filepath.c_str());
+
+  ispd::report::JsonWriter json(file);
+  json.beginObject();
+  json.field("version", REPORT_VERSION);
+
+  json.beginObject("configuration");
+  json.field("ranks", static_cast<std::uint64_t>(tw_nnodes()));
+  for (const auto &[key, value] : g_Configuration)
+    std::visit([&json, &key = key](const auto &v) { json.field(key, v); },
+               value);
+  json.endObject();
+
+  json.beginObject("phases");
+  for (std::size_t i = 0; i < g_Phases.size(); i++) {
+    json.beginObject(g_Phases[i].m_Name);
+    json.field("min", g_MinPhaseTimes[i]);
+    json.field("max", g_MaxPhaseTimes[i]);
+    json.field("mean", g_TotalPhaseTimes[i] / tw_nnodes());
+    json.field("peak_rss_delta_kib", g_MaxPhaseRssDeltas[i]);
+    json.endObject();
+  }
+  json.endObject();
+
+  json.beginObject("memory");
+  json.field("max_peak_rss_kib", g_MaxPeakRss);
+  json.field("total_peak_rss_kib", g_TotalPeakRss);
+  json.endObject();
+
+  writeEngineStatistics(json);
+  ispd::global_metrics::writeGlobalMetrics(json);
+
+  for (const auto &[key, section] : g_Sections) {
+    json.beginObject(key);
+    section(json);
+    json.endObject();
+  }
+
+  json.endObject();
+
+  if (std::fclose(file))
+    ispd_error("Run report file %s could not be written.", filepath.c_str());
+
+  ispd_info("Run report has been written to %s.", filepath.c_str());
+}
+
+}; // namespace ispd::run_report
@@ -1,4 +1,5 @@
 #include <ross.h>
+#include <algorithm>
 #include <ispd/routing/routing.hpp>
 
 namespace ispd::routing {
@@ -170,6 +171,20 @@ auto RoutingTable::load(const std::string &filepath) -> void {
   }
 }
 
+auto RoutingTable::registerRoute(const tw_lpid src, const tw_lpid dest,
+                                 const std::vector<tw_lpid> &path) -> void {
+  /// Checks if the route is empty. If so, the program is immediately aborted,
+  /// since a route must contain at least its destination.
+  if (path.empty())
+    ispd_error("The route from %lu to %lu must not be empty.", src, dest);
+
+  std::unique_ptr<tw_lpid *> elements =
+      std::make_unique<tw_lpid *>(new tw_lpid[path.size()]);
+  std::copy(path.begin(), path.end(), *elements);
+
+  addRoute(src, dest, new Route(std::move(elements), path.size()));
+}
+
 auto RoutingTable::getRoute(const tw_lpid src, const tw_lpid dest) const
     -> const Route * {
   return m_Routes.at(szudzik(src, dest))[0];
@@ -199,6 +214,12 @@ auto load(const std::string &filepath) -> void {
   g_RoutingTable->load(filepath);
 }
 
+auto registerRoute(const tw_lpid src, const tw_lpid dest,
+                   const std::vector<tw_lpid> &path) -> void {
+  /// Forward the route registration to the global routing table.
+  g_RoutingTable->registerRoute(src, dest, path);
+}
+
 auto getRoute(const tw_lpid src, const tw_lpid dest)
     -> const ispd::routing::Route * {
   /// Forward the route query to the global routing table.
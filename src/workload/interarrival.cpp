@@ -1,3 +1,4 @@
+#include <cmath>
 #include <ispd/log/log.hpp>
 #include <ispd/workload/interarrival.hpp>
 
@@ -79,7 +80,48 @@ PoissonInterarrivalDistribution::PoissonInterarrivalDistribution(
 
 void PoissonInterarrivalDistribution::generateInterarrival(
     tw_rng_stream *const rng, double &offset) {
-  offset = tw_rand_poisson(rng, m_Lambda);
+  /// The offset is sampled by inversion with a single uniform number, since
+  /// ROSS' `tw_rand_poisson` draws a variable amount of uniform numbers that
+  /// cannot be reversed by the single `tw_rand_reverse_unif` call below.
+  ///
+  /// The outcomes are visited from the mode outwards, always taking the most
+  /// probable of the two neighbors, until their accumulated probability
+  /// reaches the uniform number. The mode's probability is computed in log
+  /// space, so that it does not underflow for large lambdas, and about
+  /// sqrt(lambda) outcomes are visited on average.
+  const double u = tw_rand_unif(rng);
+  const double mode = std::floor(m_Lambda);
+
+  double lower = mode, upper = mode;
+  double lowerProbability = std::exp(mode * std::log(m_Lambda) - m_Lambda -
+                                     std::lgamma(mode + 1.0));
+  double upperProbability = lowerProbability;
+  double cumulative = lowerProbability;
+  double k = mode;
+
+  while (u > cumulative) {
+    const double nextUpper = upperProbability * m_Lambda / (upper + 1.0);
+    const double nextLower =
+        lower > 0.0 ? lowerProbability * lower / m_Lambda : 0.0;
+
+    /// The loop stops if both neighbors' probabilities have underflowed,
+    /// which prevents the rounding of the accumulated probability from
+    /// looping forever.
+    if (nextUpper <= 0.0 && nextLower <= 0.0)
+      break;
+
+    if (nextUpper >= nextLower) {
+      k = ++upper;
+      upperProbability = nextUpper;
+      cumulative += nextUpper;
+    } else {
+      k = --lower;
+      lowerProbability = nextLower;
+      cumulative += nextLower;
+    }
+  }
+
+  offset = k;
 }
 
 void PoissonInterarrivalDistribution::reverseGenerateInterarrival(
@@ -0,0 +1,39 @@
+/// \file failures.hpp
+///
+/// \brief This file implements the failure reporting shared by the tests, which
+/// exit with a non-zero status if any check has failed.
+///
+#ifndef ISPD_TESTS_FAILURES_HPP
+#define ISPD_TESTS_FAILURES_HPP
+
+#include <cstdarg>
+#include <cstdio>
+
+namespace ispd::test {
+
+/// \brief The amount of failed checks.
+inline unsigned g_Failures = 0;
+
+/// \brief The maximum amount of failures to be printed.
+inline constexpr unsigned MAX_PRINTED_FAILURES = 20;
+
+/// \brief Reports a failed check, whose description is given as a printf-like
+///        format and its arguments.
+///
+/// Only the first failures are printed, since a broken handler usually fails
+/// every trial.
+inline void fail(const char *fmt, ...) {
+  if (g_Failures++ >= MAX_PRINTED_FAILURES)
+    return;
+
+  va_list args;
+  va_start(args, fmt);
+  std::fputs("FAILED ", stdout);
+  std::vprintf(fmt, args);
+  std::fputc('\n', stdout);
+  va_end(args);
+}
+
+}; // namespace ispd::test
+
+#endif // ISPD_TESTS_FAILURES_HPP
@@ -0,0 +1,86 @@
+#include <ross.h>
+
+tw_stime g_tw_lookahead = 0.0;
+tw_peid g_tw_mynode = 0;
+tw_lpid g_tw_nlp = 0;
+unsigned long long g_tw_gvt_done = 0;
+
+namespace ispd::mock {
+
+tw_stime g_Now = 0.0;
+std::deque<tw_event> g_Events;
+unsigned g_InvalidOffsets = 0;
+
+void reset() {
+  g_Events.clear();
+  g_InvalidOffsets = 0;
+}
+
+}; // namespace ispd::mock
+
+tw_peid tw_nnodes(void) { return 1; }
+
+tw_stime tw_now(const tw_lp *lp) { return ispd::mock::g_Now; }
+
+tw_event *tw_event_new(const tw_lpid dest, const tw_stime offset,
+                       tw_lp *sender) {
+  /// ROSS aborts on these offsets, which are counted instead so that the
+  /// tests can report them.
+  if (!std::isfinite(offset) || offset < g_tw_lookahead)
+    ispd::mock::g_InvalidOffsets++;
+
+  tw_event &event = ispd::mock::g_Events.emplace_back();
+  event.m_Dest = dest;
+  event.m_Offset = offset;
+  event.m_Sent = false;
+
+  /// The events' data is not cleared by ROSS either.
+  std::memset(event.m_Data, 0xA5, sizeof(event.m_Data));
+  return &event;
+}
+
+void *tw_event_data(tw_event *event) { return event->m_Data; }
+
+void tw_event_send(tw_event *event) { event->m_Sent = true; }
+
+/// \brief Returns the number at the specified position of a stream, in (0, 1).
+static double numberAt(const tw_rng_stream *g, std::uint64_t position) {
+  /// SplitMix64's finalizer of the seed and of the position.
+  std::uint64_t z = g->m_Seed + (position + 1) * 0x9E3779B97F4A7C15ull;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  z = z ^ (z >> 31);
+
+  return (static_cast<double>(z >> 11) + 0.5) * 0x1.0p-53;
+}
+
+double tw_rand_unif(tw_rng_stream *g) { return numberAt(g, g->m_Count++); }
+
+double tw_rand_reverse_unif(tw_rng_stream *g) {
+  return numberAt(g, --g->m_Count);
+}
+
+/// The distributions draw as many uniform numbers as ROSS' implementations.
+
+double tw_rand_exponential(tw_rng_stream *g, const double mean) {
+  return -mean * std::log(tw_rand_unif(g));
+}
+
+long tw_rand_poisson(tw_rng_stream *g, const double lambda) {
+  const double limit = std::exp(-lambda);
+  double product = tw_rand_unif(g);
+  long count = 0;
+
+  while (product >= limit) {
+    product *= tw_rand_unif(g);
+    count++;
+  }
+
+  return count;
+}
+
+double tw_rand_weibull(tw_rng_stream *g, const double mean,
+                       const double shape) {
+  const double scale = mean / std::tgamma(1.0 + 1.0 / shape);
+  return scale * std::pow(-std::log(tw_rand_unif(g)), 1.0 / shape);
+}
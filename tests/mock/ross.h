@@ -0,0 +1,110 @@
+/// \file ross.h
+///
+/// \brief This file mocks the subset of ROSS used by the service handlers, so
+/// that the handlers can be driven directly by the tests, without MPI and
+/// without an event loop.
+///
+/// The mock replaces ROSS' header when `tests/mock` precedes ROSS' include
+/// directories. The sent events are kept by the mock, the current virtual time
+/// is set by the tests and the random number streams are counter-based, so
+/// that their position can be compared after a rollback.
+///
+#ifndef ISPD_TESTS_MOCK_ROSS_H
+#define ISPD_TESTS_MOCK_ROSS_H
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+#include <deque>
+#include <iostream>
+
+typedef std::uint64_t tw_lpid;
+typedef unsigned long tw_peid;
+typedef unsigned long tw_kpid;
+typedef double tw_stime;
+typedef unsigned long long tw_stat;
+
+/// \brief The bit field given to the forward and the reverse handlers.
+typedef struct {
+  unsigned int c0 : 1, c1 : 1, c2 : 1, c3 : 1, c4 : 1, c5 : 1, c6 : 1, c7 : 1;
+  unsigned int c8 : 1, c9 : 1, c10 : 1, c11 : 1, c12 : 1, c13 : 1, c14 : 1,
+      c15 : 1;
+  unsigned int c16 : 1, c17 : 1, c18 : 1, c19 : 1, c20 : 1, c21 : 1, c22 : 1,
+      c23 : 1;
+  unsigned int c24 : 1, c25 : 1, c26 : 1, c27 : 1, c28 : 1, c29 : 1, c30 : 1,
+      c31 : 1;
+} tw_bf;
+
+/// \brief A counter-based random number stream, whose position is the amount
+///        of numbers drawn minus the amount of numbers reversed.
+struct tw_rng_stream {
+  std::uint64_t m_Seed;
+  std::uint64_t m_Count;
+};
+
+struct tw_pe;
+struct tw_kp;
+struct tw_lptype;
+
+struct tw_lp {
+  tw_lpid id;
+  tw_lpid gid;
+  tw_pe *pe;
+  tw_kp *kp;
+  void *cur_state;
+  const tw_lptype *type;
+  tw_rng_stream *rng;
+};
+
+/// \brief The maximum size of an event's message.
+#define ISPD_MOCK_MESSAGE_SIZE 512
+
+struct tw_event {
+  tw_lpid m_Dest;     ///< The receiver's GID.
+  tw_stime m_Offset;  ///< The offset from the sender's virtual time.
+  bool m_Sent;        ///< Whether the event has been sent.
+  alignas(std::max_align_t) unsigned char m_Data[ISPD_MOCK_MESSAGE_SIZE];
+};
+
+extern tw_stime g_tw_lookahead;
+extern tw_peid g_tw_mynode;
+extern tw_lpid g_tw_nlp;
+extern unsigned long long g_tw_gvt_done;
+
+#define ROSS_MAX(a, b) ((a) > (b) ? (a) : (b))
+#define ROSS_MIN(a, b) ((a) < (b) ? (a) : (b))
+
+tw_peid tw_nnodes(void);
+tw_stime tw_now(const tw_lp *lp);
+
+tw_event *tw_event_new(tw_lpid dest, tw_stime offset, tw_lp *sender);
+void *tw_event_data(tw_event *event);
+void tw_event_send(tw_event *event);
+
+double tw_rand_unif(tw_rng_stream *g);
+double tw_rand_reverse_unif(tw_rng_stream *g);
+double tw_rand_exponential(tw_rng_stream *g, double mean);
+long tw_rand_poisson(tw_rng_stream *g, double lambda);
+double tw_rand_weibull(tw_rng_stream *g, double mean, double shape);
+
+namespace ispd::mock {
+
+/// \brief The virtual time returned by `tw_now`.
+extern tw_stime g_Now;
+
+/// \brief The events created by the handlers, in creation order.
+extern std::deque<tw_event> g_Events;
+
+/// \brief The amount of events created with an invalid offset, that is, a
+///        negative, non-finite or smaller than the lookahead offset.
+extern unsigned g_InvalidOffsets;
+
+/// \brief Forgets the created events.
+void reset();
+
+}; // namespace ispd::mock
+
+#endif // ISPD_TESTS_MOCK_ROSS_H
@@ -0,0 +1,539 @@
+/// \file reverse_handlers.cpp
+///
+/// \brief This file implements the reverse computation property tests, which
+/// drive the services' forward and reverse handlers against a mocked ROSS.
+///
+/// Each trial starts a logical process with a randomized state and random
+/// number stream, handles a random sequence of randomized messages forward and
+/// then rolls them back, in reverse order, as Time Warp would. The following
+/// properties are checked:
+///
+/// - Every reverse handler restores its logical process' state, byte by byte,
+///   including the position of its random number stream.
+/// - Every event is sent with a valid offset.
+/// - Handling the rolled back messages forward again sends the same events.
+///
+/// The tests run in milliseconds and need neither MPI nor ROSS.
+///
+#include <ross.h>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include <functional>
+#include <type_traits>
+#include <ispd/log/log.hpp>
+#include <ispd/model/builder.hpp>
+#include <ispd/routing/routing.hpp>
+#include <ispd/message/message.hpp>
+#include <ispd/services/link.hpp>
+#include <ispd/services/master.hpp>
+#include <ispd/services/switch.hpp>
+#include <ispd/services/machine.hpp>
+#include <ispd/scheduler/round_robin.hpp>
+#include <ispd/workload/workload.hpp>
+#include <ispd/workload/interarrival.hpp>
+#include "failures.hpp"
+
+static_assert(sizeof(ispd_message) <= ISPD_MOCK_MESSAGE_SIZE);
+
+namespace {
+
+/// \brief The amount of trials of each handler.
+constexpr unsigned TRIALS = 200;
+
+/// \brief The maximum amount of messages handled by each trial.
+constexpr unsigned MAX_MESSAGES = 16;
+
+/// \brief The services' GIDs, which are wired by the routes registered below.
+constexpr tw_lpid MASTER = 100;
+constexpr tw_lpid FIRST_SLAVE = 101;
+constexpr tw_lpid MAX_SLAVES = 4;
+constexpr tw_lpid LINK = 10;
+constexpr tw_lpid SWITCH = 11;
+constexpr tw_lpid SWITCH_LINK = 12;
+constexpr tw_lpid MACHINE = FIRST_SLAVE;
+
+/// \brief The origin and the destination of the tasks that are forwarded by
+///        the machine and the switch, whose route is `g_ForwardingPath`.
+///
+/// As every route, it alternates links and nodes. The route offset of the
+/// messages received by a node is the node's index within the route.
+constexpr tw_lpid FORWARDING_ORIGIN = 200;
+constexpr tw_lpid FORWARDING_DEST = 201;
+constexpr int FORWARDING_MACHINE_INDEX = 1;
+constexpr int FORWARDING_SWITCH_INDEX = 3;
+const std::vector<tw_lpid> g_ForwardingPath = {LINK, MACHINE, SWITCH_LINK,
+                                               SWITCH, 20, FORWARDING_DEST};
+
+std::mt19937_64 g_Random(0x15BDu);
+using ispd::test::fail;
+using ispd::test::g_Failures;
+
+double uniform(const double min, const double max) {
+  return std::uniform_real_distribution<double>(min, max)(g_Random);
+}
+
+unsigned uniformInt(const unsigned min, const unsigned max) {
+  return std::uniform_int_distribution<unsigned>(min, max)(g_Random);
+}
+
+/// \brief Returns the bytes of a trivially copyable value.
+template <typename T> std::string bytesOf(const T &value) {
+  static_assert(std::is_trivially_copyable_v<T>);
+  return std::string(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+/// \brief Returns the bytes of a vector's elements.
+template <typename T> std::string bytesOf(const std::vector<T> &values) {
+  static_assert(std::is_trivially_copyable_v<T>);
+  return std::string(reinterpret_cast<const char *>(values.data()),
+                     values.size() * sizeof(T));
+}
+
+/// \brief Returns the bytes of a polymorphic object, such as a scheduler.
+std::string rawBytesOf(const void *object, const std::size_t size) {
+  return std::string(static_cast<const char *>(object), size);
+}
+
+/// \brief Returns a randomized message, whose task is bound to the specified
+///        origin and destination.
+ispd_message randomMessage(const tw_lpid origin, const tw_lpid dest) {
+  ispd_message msg;
+  std::memset(&msg, 0xA5, sizeof(msg));
+
+  msg.type = message_type::ARRIVAL;
+  msg.task.m_ProcSize = uniform(0.0, 1000.0);
+  msg.task.m_CommSize = uniform(0.0, 100.0);
+  msg.task.m_Offload = uniform(0.0, 1.0);
+  msg.task.m_Origin = origin;
+  msg.task.m_Dest = dest;
+  msg.task.m_SubmitTime = uniform(0.0, 10.0);
+  msg.task.m_EndTime = 0.0;
+  msg.task.m_Owner = 0;
+  msg.latency = ispd::customer::TaskLatency{};
+  msg.downward_direction = uniformInt(0, 1);
+  msg.task_processed = 0;
+  return msg;
+}
+
+/// \brief A random number stream at a random position.
+tw_rng_stream randomStream() {
+  return tw_rng_stream{g_Random(), uniformInt(0, 1u << 20)};
+}
+
+/// \brief The events sent since the specified event, as bytes.
+///
+/// Only the message fields read by the receivers are compared, since the
+/// saved fields are the receivers' scratch space.
+std::string sentSince(const std::size_t first) {
+  std::string sent;
+
+  for (std::size_t i = first; i < ispd::mock::g_Events.size(); i++) {
+    const tw_event &event = ispd::mock::g_Events[i];
+    const auto *const msg = reinterpret_cast<const ispd_message *>(event.m_Data);
+
+    if (!event.m_Sent)
+      fail("An event to %lu has been created but not sent.", event.m_Dest);
+
+    sent += bytesOf(event.m_Dest) + bytesOf(event.m_Offset) +
+            bytesOf(msg->type) + bytesOf(msg->task) + bytesOf(msg->latency) +
+            bytesOf(msg->route_offset) + bytesOf(msg->previous_service_id) +
+            static_cast<char>(msg->downward_direction) +
+            static_cast<char>(msg->task_processed);
+  }
+
+  return sent;
+}
+
+/// \brief Checks the reverse computation properties of a service.
+///
+/// The subject is constructed with a randomized state for each trial and it
+/// provides its logical process (`m_Lp`), the randomized messages that it
+/// handles (`nextMessage`), its state's bytes (`snapshot`) and its handlers
+/// (`forward` and `reverse`).
+template <typename Subject> void checkRollbacks(const char *name) {
+  const unsigned failures = g_Failures;
+
+  for (unsigned trial = 0; trial < TRIALS; trial++) {
+    Subject subject;
+    ispd::mock::reset();
+    ispd::mock::g_Now = uniform(0.0, 100.0);
+
+    const unsigned count = uniformInt(1, MAX_MESSAGES);
+    std::vector<ispd_message> msgs;
+    std::vector<tw_bf> bfs(count);
+    std::vector<double> times;
+    std::vector<std::string> states, sends;
+
+    for (unsigned i = 0; i < count; i++) {
+      ispd::mock::g_Now += uniform(0.0, 2.0);
+      times.push_back(ispd::mock::g_Now);
+      states.push_back(subject.snapshot());
+      msgs.push_back(subject.nextMessage());
+
+      /// ROSS clears the bit field before handling each event.
+      std::memset(&bfs[i], 0, sizeof(tw_bf));
+
+      const std::size_t first = ispd::mock::g_Events.size();
+      subject.forward(&bfs[i], &msgs[i]);
+      sends.push_back(sentSince(first));
+    }
+
+    for (unsigned i = count; i-- > 0;) {
+      ispd::mock::g_Now = times[i];
+      subject.reverse(&bfs[i], &msgs[i]);
+
+      if (subject.snapshot() != states[i]) {
+        fail("%s (trial %u): rolling back message %u of %u has not restored "
+             "the state.",
+             name, trial, i + 1, count);
+        break;
+      }
+    }
+
+    /// The rolled back messages, which may have been changed by the handlers,
+    /// are handled forward again.
+    for (unsigned i = 0; i < count; i++) {
+      ispd::mock::g_Now = times[i];
+      std::memset(&bfs[i], 0, sizeof(tw_bf));
+
+      const std::size_t first = ispd::mock::g_Events.size();
+      subject.forward(&bfs[i], &msgs[i]);
+
+      if (sentSince(first) != sends[i]) {
+        fail("%s (trial %u): handling message %u of %u again has sent "
+             "different events.",
+             name, trial, i + 1, count);
+        break;
+      }
+    }
+
+    if (ispd::mock::g_InvalidOffsets) {
+      fail("%s (trial %u): %u events have been sent with an invalid offset.",
+           name, trial, ispd::mock::g_InvalidOffsets);
+    }
+  }
+
+  std::printf("%-32s %s\n", name, failures == g_Failures ? "ok" : "FAILED");
+}
+
+struct LinkSubject {
+  tw_rng_stream m_Rng = randomStream();
+  tw_lp m_Lp = {LINK, LINK, nullptr, nullptr, nullptr, nullptr, &m_Rng};
+  ispd::services::link_state m_State = {
+      MASTER,
+      FIRST_SLAVE,
+      ispd::configuration::LinkConfiguration(
+          uniform(10.0, 1000.0), uniform(0.0, 0.9), uniform(0.0, 0.01)),
+      ispd::services::link_metrics{},
+      uniform(0.0, 120.0),
+      uniform(0.0, 120.0)};
+
+  ispd_message nextMessage() {
+    ispd_message msg = randomMessage(MASTER, FIRST_SLAVE);
+    msg.previous_service_id = msg.downward_direction ? MASTER : FIRST_SLAVE;
+    return msg;
+  }
+
+  std::string snapshot() const { return bytesOf(m_State) + bytesOf(m_Rng); }
+
+  void forward(tw_bf *bf, ispd_message *msg) {
+    ispd::services::link::forward(&m_State, bf, msg, &m_Lp);
+  }
+
+  void reverse(tw_bf *bf, ispd_message *msg) {
+    ispd::services::link::reverse(&m_State, bf, msg, &m_Lp);
+  }
+};
+
+struct SwitchSubject {
+  tw_rng_stream m_Rng = randomStream();
+  tw_lp m_Lp = {SWITCH, SWITCH, nullptr, nullptr, nullptr, nullptr, &m_Rng};
+  ispd::services::SwitchState m_State = {
+      ispd::configuration::SwitchConfiguration(
+          uniform(10.0, 1000.0), uniform(0.0, 0.9), uniform(0.0, 0.01)),
+      ispd::services::SwitchMetrics{}};
+
+  ispd_message nextMessage() {
+    ispd_message msg = randomMessage(FORWARDING_ORIGIN, FORWARDING_DEST);
+    msg.route_offset = FORWARDING_SWITCH_INDEX;
+    msg.previous_service_id =
+        g_ForwardingPath[FORWARDING_SWITCH_INDEX +
+                         (msg.downward_direction ? -1 : 1)];
+    return msg;
+  }
+
+  std::string snapshot() const { return bytesOf(m_State) + bytesOf(m_Rng); }
+
+  void forward(tw_bf *bf, ispd_message *msg) {
+    ispd::services::Switch::forward(&m_State, bf, msg, &m_Lp);
+  }
+
+  void reverse(tw_bf *bf, ispd_message *msg) {
+    ispd::services::Switch::reverse(&m_State, bf, msg, &m_Lp);
+  }
+};
+
+struct MachineSubject {
+  tw_rng_stream m_Rng = randomStream();
+  tw_lp m_Lp = {MACHINE, MACHINE, nullptr, nullptr, nullptr, nullptr, &m_Rng};
+  ispd::services::machine_state m_State = {
+      ispd::configuration::MachineConfiguration(
+          uniform(100.0, 10000.0), uniform(0.0, 0.9), uniformInt(1, 16),
+          uniform(100.0, 10000.0), uniformInt(1, 64), uniform(1.0, 32.0),
+          uniform(10.0, 100.0), uniform(100.0, 300.0)),
+      ispd::metrics::MachineMetrics{},
+      {},
+      0};
+
+  MachineSubject() {
+    m_State.cores_free_time.resize(m_State.conf.getCoreCount());
+    for (auto &freeTime : m_State.cores_free_time)
+      freeTime = uniform(0.0, 120.0);
+  }
+
+  ispd_message nextMessage() {
+    /// Most tasks are processed by this machine, while the others are only
+    /// forwarded by it.
+    if (uniformInt(0, 3)) {
+      ispd_message msg = randomMessage(MASTER, MACHINE);
+      msg.downward_direction = 1;
+      msg.route_offset = 3;
+      msg.previous_service_id = SWITCH_LINK;
+      return msg;
+    }
+
+    ispd_message msg = randomMessage(FORWARDING_ORIGIN, FORWARDING_DEST);
+    msg.route_offset = FORWARDING_MACHINE_INDEX;
+    msg.previous_service_id =
+        g_ForwardingPath[FORWARDING_MACHINE_INDEX +
+                         (msg.downward_direction ? -1 : 1)];
+    return msg;
+  }
+
+  std::string snapshot() const {
+    return bytesOf(m_State.conf) + bytesOf(m_State.m_Metrics) +
+           bytesOf(m_State.cores_free_time) + bytesOf(m_State.series_slot) +
+           bytesOf(m_Rng);
+  }
+
+  void forward(tw_bf *bf, ispd_message *msg) {
+    ispd::services::machine::forward(&m_State, bf, msg, &m_Lp);
+  }
+
+  void reverse(tw_bf *bf, ispd_message *msg) {
+    ispd::services::machine::reverse(&m_State, bf, msg, &m_Lp);
+  }
+};
+
+/// \brief Creates a workload with the specified remaining tasks and
+///        interarrival distribution.
+using WorkloadFactory = std::function<ispd::workload::Workload *(
+    unsigned, std::unique_ptr<ispd::workload::InterarrivalDistribution>)>;
+
+/// \brief Creates an interarrival distribution.
+using InterarrivalFactory =
+    std::function<std::unique_ptr<ispd::workload::InterarrivalDistribution>()>;
+
+/// \brief The master's workload and interarrival distribution, which are set
+///        before checking each combination.
+WorkloadFactory g_MasterWorkload;
+std::size_t g_MasterWorkloadSize;
+InterarrivalFactory g_MasterInterarrival;
+
+struct MasterSubject {
+  tw_rng_stream m_Rng = randomStream();
+  tw_lp m_Lp = {MASTER, MASTER, nullptr, nullptr, nullptr, nullptr, &m_Rng};
+  std::unique_ptr<ispd::scheduler::RoundRobin> m_Scheduler =
+      std::make_unique<ispd::scheduler::RoundRobin>();
+
+  /// The workload has few tasks, so that some trials exhaust it.
+  std::unique_ptr<ispd::workload::Workload> m_Workload{
+      g_MasterWorkload(uniformInt(1, MAX_MESSAGES), g_MasterInterarrival())};
+
+  ispd::services::master_state m_State;
+
+  MasterSubject() {
+    for (tw_lpid slave = 0, slaves = uniformInt(1, MAX_SLAVES); slave < slaves;
+         slave++)
+      m_State.slaves.push_back(FIRST_SLAVE + slave);
+
+    m_State.scheduler = m_Scheduler.get();
+    m_State.workload = m_Workload.get();
+    m_State.metrics = ispd::services::master_metrics{};
+    m_Scheduler->initScheduler();
+
+    /// The scheduler starts at a random slave.
+    for (unsigned i = uniformInt(0, MAX_SLAVES); i > 0; i--) {
+      tw_bf bf;
+      ispd_message msg;
+      [[maybe_unused]] const tw_lpid slave =
+          m_Scheduler->forwardSchedule(m_State.slaves, &bf, &msg, &m_Lp);
+    }
+  }
+
+  ispd_message nextMessage() {
+    /// A generate message is only received while there are remaining tasks.
+    if (m_Workload->getRemainingTasks() > 0 && uniformInt(0, 2)) {
+      ispd_message msg;
+      std::memset(&msg, 0xA5, sizeof(msg));
+      msg.type = message_type::GENERATE;
+      msg.previous_service_id = MASTER;
+      return msg;
+    }
+
+    ispd_message msg = randomMessage(MASTER, FIRST_SLAVE);
+    msg.downward_direction = 0;
+    msg.task_processed = 1;
+    msg.previous_service_id = LINK;
+    return msg;
+  }
+
+  std::string snapshot() const {
+    return bytesOf(m_State.slaves) + bytesOf(m_State.metrics) +
+           rawBytesOf(m_Scheduler.get(), sizeof(ispd::scheduler::RoundRobin)) +
+           rawBytesOf(m_Workload.get(), g_MasterWorkloadSize) + bytesOf(m_Rng);
+  }
+
+  void forward(tw_bf *bf, ispd_message *msg) {
+    ispd::services::master::forward(&m_State, bf, msg, &m_Lp);
+  }
+
+  void reverse(tw_bf *bf, ispd_message *msg) {
+    ispd::services::master::reverse(&m_State, bf, msg, &m_Lp);
+  }
+};
+
+/// \brief Checks the master with each workload and interarrival distribution.
+void checkMasterRollbacks() {
+  using namespace ispd::workload;
+
+  const std::pair<const char *, InterarrivalFactory> interarrivals[] = {
+      {"fixed", [] { return std::make_unique<FixedInterarrivalDistribution>(
+                         uniform(0.1, 2.0)); }},
+      {"exponential",
+       [] {
+         return std::make_unique<ExponentialInterarrivalDistribution>(
+             uniform(0.1, 2.0));
+       }},
+      {"poisson_1",
+       [] { return std::make_unique<PoissonInterarrivalDistribution>(1.0); }},
+      {"poisson_50",
+       [] { return std::make_unique<PoissonInterarrivalDistribution>(50.0); }},
+      {"poisson_1000",
+       [] {
+         return std::make_unique<PoissonInterarrivalDistribution>(1000.0);
+       }},
+      {"weibull",
+       [] {
+         return std::make_unique<WeibullInterarrivalDistribution>(
+             uniform(0.5, 2.0), uniform(0.5, 3.0));
+       }},
+  };
+
+  const std::tuple<const char *, WorkloadFactory, std::size_t> workloads[] = {
+      {"constant",
+       [](unsigned tasks, auto interarrival) -> Workload * {
+         return constant("User1", tasks, uniform(1.0, 1000.0),
+                         uniform(1.0, 100.0), uniform(0.0, 1.0),
+                         std::move(interarrival));
+       },
+       sizeof(ConstantWorkload)},
+      {"uniform",
+       [](unsigned tasks, auto interarrival) -> Workload * {
+         return uniform("User1", tasks, 1.0, 500.0, 1.0, 50.0,
+                        uniform(0.0, 1.0), std::move(interarrival));
+       },
+       sizeof(UniformWorkload)},
+      {"two_stage",
+       [](unsigned tasks, auto interarrival) -> Workload * {
+         return twoStage("User1", tasks, uniform(0.0, 1.0),
+                         {1.0, 100.0, 500.0, uniform(0.0, 1.0)},
+                         {1.0, 10.0, 50.0, uniform(0.0, 1.0)},
+                         std::move(interarrival));
+       },
+       sizeof(TwoStageUniformWorkload)},
+  };
+
+  for (const auto &[workloadName, workload, size] : workloads) {
+    for (const auto &[interarrivalName, interarrival] : interarrivals) {
+      g_MasterWorkload = workload;
+      g_MasterWorkloadSize = size;
+      g_MasterInterarrival = interarrival;
+
+      const std::string name =
+          std::string("master/") + workloadName + "/" + interarrivalName;
+      checkRollbacks<MasterSubject>(name.c_str());
+    }
+  }
+}
+
+/// \brief Checks that the interarrival distribution's sample mean is within
+///        five standard errors of the expected mean.
+void checkSampleMean(const char *name,
+                     ispd::workload::InterarrivalDistribution &distribution,
+                     const double mean, const double variance) {
+  constexpr unsigned SAMPLES = 20000;
+  tw_rng_stream rng = randomStream();
+  double sum = 0.0;
+
+  for (unsigned i = 0; i < SAMPLES; i++) {
+    double offset;
+    distribution.generateInterarrival(&rng, offset);
+    sum += offset;
+  }
+
+  const double sampleMean = sum / SAMPLES;
+  const double tolerance = 5.0 * std::sqrt(variance / SAMPLES);
+
+  if (std::fabs(sampleMean - mean) > tolerance)
+    fail("%s: the sample mean is %lf, but %lf +/- %lf was expected.", name,
+         sampleMean, mean, tolerance);
+
+  std::printf("%-32s %s\n", name,
+              std::fabs(sampleMean - mean) > tolerance ? "FAILED" : "ok");
+}
+
+/// \brief Checks the Poisson interarrival's sample mean, whose variance is
+///        its mean.
+void checkPoissonMeans() {
+  for (const double lambda : {1.0, 50.0, 1000.0}) {
+    ispd::workload::PoissonInterarrivalDistribution distribution(lambda);
+    const std::string name = "poisson/mean/" + std::to_string(int(lambda));
+
+    checkSampleMean(name.c_str(), distribution, lambda, lambda);
+  }
+}
+
+}; // namespace
+
+int main() {
+  ispd::log::setOutputFile(nullptr);
+
+  /// The master's workloads must be owned by a registered user.
+  ispd::this_model::registerUser("User1", 0.0);
+
+  /// The master reaches each slave through the switch, while the machine and
+  /// the switch forward the tasks of the forwarding route.
+  for (tw_lpid slave = 0; slave < MAX_SLAVES; slave++)
+    ispd::routing_table::registerRoute(
+        MASTER, FIRST_SLAVE + slave,
+        {LINK, SWITCH, SWITCH_LINK, FIRST_SLAVE + slave});
+  ispd::routing_table::registerRoute(FORWARDING_ORIGIN, FORWARDING_DEST,
+                                     g_ForwardingPath);
+
+  /// The conservative lookahead is added to every delay.
+  g_tw_lookahead = 0.5;
+
+  checkRollbacks<LinkSubject>("link");
+  checkRollbacks<SwitchSubject>("switch");
+  checkRollbacks<MachineSubject>("machine");
+  checkMasterRollbacks();
+  checkPoissonMeans();
+
+  if (g_Failures)
+    std::printf("%u checks have failed.\n", g_Failures);
+
+  return g_Failures ? 1 : 0;
+}
@@ -0,0 +1,242 @@
+/// \file topology_routes.cpp
+///
+/// \brief This file implements the route walk tests of the generated
+/// topologies, which drive the services' forward handlers against a mocked
+/// ROSS.
+///
+/// The master generates a task for each of its slaves and every sent event is
+/// delivered to its receiver's forward handler, until the task's results
+/// arrive back at the master. The following properties are checked:
+///
+/// - No service sends a packet to itself.
+/// - The packets visit the route's services in order, down to the slave, and
+///   then back in reverse order, up to the master.
+///
+/// The tests need neither MPI nor ROSS. The topology is given by the command
+/// line, as `star <machines>` or `tree <fanout> <depth>`.
+///
+#include <ross.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <ispd/log/log.hpp>
+#include <ispd/model/builder.hpp>
+#include <ispd/model/topology.hpp>
+#include <ispd/routing/routing.hpp>
+#include <ispd/message/message.hpp>
+#include <ispd/services/link.hpp>
+#include <ispd/services/master.hpp>
+#include <ispd/services/switch.hpp>
+#include <ispd/services/machine.hpp>
+#include "failures.hpp"
+
+namespace {
+
+using ispd::services::ServiceType;
+
+using ispd::test::fail;
+using ispd::test::g_Failures;
+
+/// \brief The generated topologies' master GID.
+constexpr tw_lpid MASTER = 0;
+
+/// \brief The states of the generated services, which are initialized by
+///        their service initializers as ROSS would.
+struct Services {
+  ispd::services::master_state m_Master{};
+  std::unordered_map<tw_lpid, ispd::services::link_state> m_Links;
+  std::unordered_map<tw_lpid, ispd::services::SwitchState> m_Switches;
+  std::unordered_map<tw_lpid, ispd::services::machine_state> m_Machines;
+  std::unordered_map<tw_lpid, tw_lp> m_Lps;
+  tw_rng_stream m_Rng{0x15BDu, 0};
+
+  tw_lp *lp(const tw_lpid gid) {
+    return &m_Lps.try_emplace(gid, tw_lp{gid, gid, nullptr, nullptr, nullptr,
+                                         nullptr, &m_Rng})
+                .first->second;
+  }
+
+  void init(const tw_lpid gid) {
+    const auto &initializer = ispd::this_model::getServiceInitializer(gid);
+
+    switch (ispd::this_model::getServiceType(gid)) {
+    case ServiceType::MASTER:
+      initializer(&m_Master);
+      m_Master.scheduler->initScheduler();
+      break;
+    case ServiceType::LINK:
+      initializer(&m_Links
+                       .try_emplace(gid, ispd::services::link_state{
+                                             0, 0,
+                                             ispd::configuration::LinkConfiguration(
+                                                 1.0, 0.0, 0.0)})
+                       .first->second);
+      break;
+    case ServiceType::SWITCH:
+      initializer(&m_Switches
+                       .try_emplace(gid, ispd::services::SwitchState{
+                                             ispd::configuration::SwitchConfiguration(
+                                                 1.0, 0.0, 0.0)})
+                       .first->second);
+      break;
+    case ServiceType::MACHINE:
+      initializer(&m_Machines
+                       .try_emplace(gid, ispd::services::machine_state{
+                                             ispd::configuration::MachineConfiguration(
+                                                 1.0, 0.0, 1, 1.0, 1, 1.0, 0.0, 0.0)})
+                       .first->second);
+      break;
+    }
+  }
+
+  /// \brief Delivers a message to its receiver's forward handler.
+  void deliver(const tw_lpid gid, ispd_message *msg) {
+    tw_bf bf{};
+
+    switch (ispd::this_model::getServiceType(gid)) {
+    case ServiceType::MASTER:
+      ispd::services::master::forward(&m_Master, &bf, msg, lp(gid));
+      break;
+    case ServiceType::LINK:
+      ispd::services::link::forward(&m_Links.at(gid), &bf, msg, lp(gid));
+      break;
+    case ServiceType::SWITCH:
+      ispd::services::Switch::forward(&m_Switches.at(gid), &bf, msg, lp(gid));
+      break;
+    case ServiceType::MACHINE:
+      ispd::services::machine::forward(&m_Machines.at(gid), &bf, msg, lp(gid));
+      break;
+    }
+  }
+};
+
+/// \brief Returns the receiver and the message of the only task's packet sent
+///        since the specified event, ignoring the master's generate messages.
+const tw_event *sentPacket(const std::size_t first) {
+  const tw_event *packet = nullptr;
+
+  for (std::size_t i = first; i < ispd::mock::g_Events.size(); i++) {
+    const tw_event &event = ispd::mock::g_Events[i];
+    const auto *const msg = reinterpret_cast<const ispd_message *>(event.m_Data);
+
+    if (msg->type == message_type::GENERATE)
+      continue;
+
+    if (packet)
+      fail("More than one packet has been sent by a hop.");
+    packet = &event;
+  }
+
+  return packet;
+}
+
+/// \brief Walks the task generated by the master, down to its slave and back,
+///        and checks its hops against the route.
+void walk(Services &services) {
+  ispd_message generate;
+  std::memset(&generate, 0, sizeof(generate));
+  generate.type = message_type::GENERATE;
+  generate.previous_service_id = MASTER;
+
+  std::size_t first = ispd::mock::g_Events.size();
+  services.deliver(MASTER, &generate);
+
+  const tw_event *packet = sentPacket(first);
+  if (!packet) {
+    fail("The master has not sent a task.");
+    return;
+  }
+
+  ispd_message msg = *reinterpret_cast<const ispd_message *>(packet->m_Data);
+  const tw_lpid slave = msg.task.m_Dest;
+  const ispd::routing::Route *route =
+      ispd::routing_table::getRoute(MASTER, slave);
+
+  /// The expected visits are the route's services, down to the slave, and
+  /// the route's services back, up to the master.
+  std::vector<tw_lpid> expected;
+  for (std::size_t i = 0; i < route->getLength(); i++)
+    expected.push_back(route->get(i));
+  for (std::size_t i = route->getLength() - 1; i-- > 0;)
+    expected.push_back(route->get(i));
+  expected.push_back(MASTER);
+
+  std::vector<tw_lpid> visits;
+  tw_lpid sender = MASTER;
+  tw_lpid receiver = packet->m_Dest;
+
+  /// The walk is bounded, so that a routing loop is reported as a failure.
+  while (visits.size() <= 2 * expected.size()) {
+    visits.push_back(receiver);
+
+    if (receiver == sender) {
+      fail("The service %lu has sent a packet of the task to %lu to itself.",
+           sender, slave);
+      return;
+    }
+
+    if (receiver == MASTER)
+      break;
+
+    first = ispd::mock::g_Events.size();
+    services.deliver(receiver, &msg);
+
+    if (!(packet = sentPacket(first))) {
+      fail("The service %lu has not forwarded the task to %lu.", receiver,
+           slave);
+      return;
+    }
+
+    msg = *reinterpret_cast<const ispd_message *>(packet->m_Data);
+    sender = receiver;
+    receiver = packet->m_Dest;
+  }
+
+  if (visits != expected) {
+    std::string text;
+    for (const tw_lpid gid : visits)
+      text += " " + std::to_string(gid);
+
+    fail("The task to %lu has visited%s.", slave, text.c_str());
+  }
+}
+
+}; // namespace
+
+int main(int argc, char **argv) {
+  ispd::log::setOutputFile(nullptr);
+  ispd::this_model::registerUser("User1", 100.0);
+
+  const std::string topology = argc > 1 ? argv[1] : "tree";
+  unsigned slaveCount;
+
+  if (topology == "star" && argc == 3) {
+    slaveCount = std::stoul(argv[2]);
+    ispd::topology::star("User1", slaveCount, slaveCount + 1);
+  } else if (topology == "tree" && argc == 4) {
+    const unsigned fanout = std::stoul(argv[2]);
+    const unsigned depth = std::stoul(argv[3]);
+
+    slaveCount = 1;
+    for (unsigned i = 0; i < depth; i++)
+      slaveCount *= fanout;
+    ispd::topology::tree("User1", fanout, depth, slaveCount + 1);
+  } else {
+    std::fprintf(stderr,
+                 "Usage: %s star <machines> | tree <fanout> <depth>\n",
+                 argv[0]);
+    return 2;
+  }
+
+  Services services;
+  for (tw_lpid gid = 0; gid < ispd::this_model::getServiceCount(); gid++)
+    services.init(gid);
+
+  /// The round robin scheduler gives a task to each slave in turn.
+  for (unsigned i = 0; i < slaveCount; i++)
+    walk(services);
+
+  std::printf("%s: %u routes walked, %u failures.\n", topology.c_str(),
+              slaveCount, g_Failures);
+  return g_Failures ? 1 : 0;
+}
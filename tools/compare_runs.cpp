@@ -0,0 +1,404 @@
+/// \file compare_runs.cpp
+///
+/// \brief This file implements the `ispd_compare` tool, which checks that two
+/// runs of the same model have committed the same metrics.
+///
+/// Usage: ispd_compare [--rtol=1e-9] [--atol=1e-12] <expected-report.json>
+///        <expected-lp-metrics.bin> <actual-report.json>
+///        <actual-lp-metrics.bin>
+///
+/// The global and the user metrics are read from the `metrics` section of the
+/// run reports and the per-LP metrics from the per-LP metrics files. The
+/// counters, that is, the integers of the run reports and the per-LP task and
+/// packet counts, must match exactly. The remaining metrics are sums of
+/// floating-point values, which may be reduced in a different order by each
+/// synchronization protocol and PE count, and must match within tolerance.
+///
+/// The tool exits with 0 if the runs match and with 1 otherwise.
+///
+#include <cmath>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <ispd/metrics/lp_metrics.hpp>
+
+namespace {
+
+/// \brief A scalar of a run report.
+struct JsonScalar {
+  enum class Kind { NUMBER, INTEGER, STRING, BOOLEAN, NULL_VALUE } m_Kind;
+  double m_Number = 0.0;
+  std::string m_Text;
+};
+
+bool isNumeric(const JsonScalar &scalar) {
+  return scalar.m_Kind == JsonScalar::Kind::NUMBER ||
+         scalar.m_Kind == JsonScalar::Kind::INTEGER;
+}
+
+/// \brief The scalars of a run report, indexed by their path, such as
+///        `metrics.users[0].issued_tasks`.
+using FlatJson = std::map<std::string, JsonScalar>;
+
+/// \class JsonFlattener
+///
+/// \brief Parses a run report into its scalars.
+class JsonFlattener {
+public:
+  explicit JsonFlattener(const std::string &text) : m_Text(text) {}
+
+  bool parse(FlatJson &out) {
+    m_Out = &out;
+    const bool valid = parseValue("");
+    skipSpaces();
+    return valid && m_Pos == m_Text.size();
+  }
+
+private:
+  void skipSpaces() {
+    while (m_Pos < m_Text.size() && std::isspace(m_Text[m_Pos]))
+      m_Pos++;
+  }
+
+  bool consume(const char c) {
+    skipSpaces();
+    if (m_Pos < m_Text.size() && m_Text[m_Pos] == c) {
+      m_Pos++;
+      return true;
+    }
+    return false;
+  }
+
+  bool consumeWord(const char *word) {
+    const std::size_t length = std::strlen(word);
+    if (m_Text.compare(m_Pos, length, word) != 0)
+      return false;
+    m_Pos += length;
+    return true;
+  }
+
+  bool parseString(std::string &out) {
+    if (!consume('"'))
+      return false;
+
+    for (; m_Pos < m_Text.size() && m_Text[m_Pos] != '"'; m_Pos++) {
+      /// The run reports only escape quotes, backslashes and control
+      /// characters, which are kept escaped since they are only compared.
+      if (m_Text[m_Pos] == '\\' && m_Pos + 1 < m_Text.size())
+        out += m_Text[m_Pos++];
+      out += m_Text[m_Pos];
+    }
+
+    return consume('"');
+  }
+
+  bool parseValue(const std::string &path) {
+    skipSpaces();
+    if (m_Pos >= m_Text.size())
+      return false;
+
+    const char c = m_Text[m_Pos];
+    JsonScalar scalar;
+
+    if (c == '{') {
+      m_Pos++;
+      if (consume('}'))
+        return true;
+
+      do {
+        std::string key;
+        if (!parseString(key) || !consume(':') ||
+            !parseValue(path.empty() ? key : path + "." + key))
+          return false;
+      } while (consume(','));
+
+      return consume('}');
+    } else if (c == '[') {
+      m_Pos++;
+      if (consume(']'))
+        return true;
+
+      std::size_t index = 0;
+      do {
+        if (!parseValue(path + "[" + std::to_string(index++) + "]"))
+          return false;
+      } while (consume(','));
+
+      return consume(']');
+    } else if (c == '"') {
+      scalar.m_Kind = JsonScalar::Kind::STRING;
+      if (!parseString(scalar.m_Text))
+        return false;
+    } else if (consumeWord("true") || consumeWord("false")) {
+      scalar.m_Kind = JsonScalar::Kind::BOOLEAN;
+      scalar.m_Text = c == 't' ? "true" : "false";
+    } else if (consumeWord("null")) {
+      scalar.m_Kind = JsonScalar::Kind::NULL_VALUE;
+      scalar.m_Text = "null";
+    } else {
+      char *end;
+      scalar.m_Number = std::strtod(m_Text.c_str() + m_Pos, &end);
+      const std::size_t length = end - (m_Text.c_str() + m_Pos);
+      if (length == 0)
+        return false;
+
+      /// The integers are written without a fraction nor an exponent.
+      const std::string literal = m_Text.substr(m_Pos, length);
+      scalar.m_Kind = literal.find_first_of(".eE") == std::string::npos
+                          ? JsonScalar::Kind::INTEGER
+                          : JsonScalar::Kind::NUMBER;
+      m_Pos += length;
+    }
+
+    (*m_Out)[path] = scalar;
+    return true;
+  }
+
+  const std::string &m_Text;
+  std::size_t m_Pos = 0;
+  FlatJson *m_Out = nullptr;
+};
+
+/// \brief The per-LP metrics records, indexed by GID.
+using LpRecords = std::map<std::uint64_t, ispd::metrics::LpMetricsRecord>;
+
+/// \brief The comparison's tolerance and its mismatches.
+struct Comparison {
+  double m_RelativeTolerance = 1e-9;
+  double m_AbsoluteTolerance = 1e-12;
+  std::size_t m_Compared = 0;
+  std::size_t m_Mismatches = 0;
+
+  /// \brief Reports a mismatch, of which only the first ones are printed.
+  void mismatch(const std::string &what, const std::string &expected,
+                const std::string &actual) {
+    if (m_Mismatches++ < 50)
+      std::printf("MISMATCH %s: expected %s, actual %s\n", what.c_str(),
+                  expected.c_str(), actual.c_str());
+  }
+
+  /// \brief Compares two values, exactly or within tolerance.
+  void compare(const std::string &what, const double expected,
+               const double actual, const bool exact) {
+    m_Compared++;
+
+    const double tolerance =
+        m_AbsoluteTolerance +
+        m_RelativeTolerance * std::max(std::fabs(expected), std::fabs(actual));
+    const bool equal = exact ? expected == actual
+                             : std::fabs(expected - actual) <= tolerance;
+
+    if (!equal) {
+      char e[64], a[64];
+      std::snprintf(e, sizeof(e), "%.17g", expected);
+      std::snprintf(a, sizeof(a), "%.17g", actual);
+      mismatch(what, e, a);
+    }
+  }
+};
+
+bool readFile(const char *filepath, std::string &out) {
+  std::FILE *file = std::fopen(filepath, "rb");
+  if (!file)
+    return false;
+
+  char buffer[1 << 16];
+  for (std::size_t read; (read = std::fread(buffer, 1, sizeof(buffer), file));)
+    out.append(buffer, read);
+
+  std::fclose(file);
+  return true;
+}
+
+bool readReport(const char *filepath, FlatJson &out) {
+  std::string text;
+  if (!readFile(filepath, text)) {
+    std::fprintf(stderr, "Run report %s could not be opened.\n", filepath);
+    return false;
+  }
+
+  if (!JsonFlattener(text).parse(out)) {
+    std::fprintf(stderr, "%s is not a valid run report.\n", filepath);
+    return false;
+  }
+
+  return true;
+}
+
+bool readLpMetrics(const char *filepath, ispd::metrics::LpMetricsHeader &header,
+                   LpRecords &out) {
+  std::FILE *input = std::fopen(filepath, "rb");
+  if (!input) {
+    std::fprintf(stderr, "LP metrics file %s could not be opened.\n",
+                 filepath);
+    return false;
+  }
+
+  if (std::fread(&header, sizeof(header), 1, input) != 1 ||
+      std::memcmp(header.m_Magic, "ISPDLPM", 8) != 0 ||
+      header.m_Version != ispd::metrics::LP_METRICS_VERSION ||
+      header.m_RecordSize != sizeof(ispd::metrics::LpMetricsRecord)) {
+    std::fprintf(stderr, "%s is not a supported LP metrics file.\n", filepath);
+    std::fclose(input);
+    return false;
+  }
+
+  /// The records are written in the order of the ranks, which depends on the
+  /// partitioning, and are therefore indexed by GID.
+  ispd::metrics::LpMetricsRecord record;
+  for (std::uint64_t i = 0; i < header.m_Count; i++) {
+    if (std::fread(&record, sizeof(record), 1, input) != 1) {
+      std::fprintf(stderr, "%s is truncated.\n", filepath);
+      std::fclose(input);
+      return false;
+    }
+    out[record.m_Gid] = record;
+  }
+
+  std::fclose(input);
+  return true;
+}
+
+/// \brief Returns whether a per-LP metric is a counter.
+bool isLpCounter(const char *name) {
+  const std::string column(
+      name, strnlen(name, ispd::metrics::LP_METRICS_COLUMN_NAME));
+  const auto endsWith = [&column](const std::string &suffix) {
+    return column.size() >= suffix.size() &&
+           column.compare(column.size() - suffix.size(), suffix.size(),
+                          suffix) == 0;
+  };
+
+  return endsWith("_tasks") || endsWith("_packets");
+}
+
+void compareReports(Comparison &comparison, const FlatJson &expected,
+                    const FlatJson &actual) {
+  /// Only the model's metrics are compared, since the remaining sections
+  /// describe the engine's execution, which differs on purpose.
+  const auto isMetric = [](const std::string &path) {
+    return path.compare(0, 8, "metrics.") == 0;
+  };
+
+  for (const auto &[path, e] : expected) {
+    if (!isMetric(path))
+      continue;
+
+    const auto it = actual.find(path);
+    if (it == actual.end()) {
+      comparison.mismatch(path, "a value", "nothing");
+      continue;
+    }
+
+    const JsonScalar &a = it->second;
+    if (isNumeric(e) && isNumeric(a)) {
+      comparison.compare(path, e.m_Number, a.m_Number,
+                         e.m_Kind == JsonScalar::Kind::INTEGER &&
+                             a.m_Kind == JsonScalar::Kind::INTEGER);
+    } else {
+      comparison.m_Compared++;
+      if (e.m_Kind != a.m_Kind || e.m_Text != a.m_Text)
+        comparison.mismatch(path, isNumeric(e) ? "a number" : e.m_Text,
+                            isNumeric(a) ? "a number" : a.m_Text);
+    }
+  }
+
+  for (const auto &[path, a] : actual)
+    if (isMetric(path) && expected.find(path) == expected.end())
+      comparison.mismatch(path, "nothing", "a value");
+}
+
+void compareLpMetrics(Comparison &comparison,
+                      const ispd::metrics::LpMetricsHeader &header,
+                      const LpRecords &expected, const LpRecords &actual) {
+  if (expected.size() != actual.size())
+    comparison.mismatch("LP count", std::to_string(expected.size()),
+                        std::to_string(actual.size()));
+
+  for (const auto &[gid, e] : expected) {
+    const std::string lp = "LP " + std::to_string(gid);
+    const auto it = actual.find(gid);
+
+    if (it == actual.end()) {
+      comparison.mismatch(lp, "a record", "nothing");
+      continue;
+    }
+
+    const auto &a = it->second;
+    if (e.m_Type != a.m_Type || e.m_ColumnCount != a.m_ColumnCount ||
+        e.m_Type >= header.m_TypeCount) {
+      comparison.mismatch(lp + " type", std::to_string(e.m_Type),
+                          std::to_string(a.m_Type));
+      continue;
+    }
+
+    for (std::uint32_t column = 0; column < e.m_ColumnCount; column++) {
+      const char *name = header.m_Columns[e.m_Type][column];
+
+      /// The metrics without samples, such as averages, are NaN in both.
+      if (std::isnan(e.m_Values[column]) && std::isnan(a.m_Values[column])) {
+        comparison.m_Compared++;
+        continue;
+      }
+
+      comparison.compare(lp + " " +
+                             std::string(name, strnlen(
+                                 name, ispd::metrics::LP_METRICS_COLUMN_NAME)),
+                         e.m_Values[column], a.m_Values[column],
+                         isLpCounter(name));
+    }
+  }
+}
+
+}; // namespace
+
+int main(int argc, char **argv) {
+  Comparison comparison;
+  std::vector<const char *> files;
+
+  for (int i = 1; i < argc; i++) {
+    if (std::strncmp(argv[i], "--rtol=", 7) == 0)
+      comparison.m_RelativeTolerance = std::atof(argv[i] + 7);
+    else if (std::strncmp(argv[i], "--atol=", 7) == 0)
+      comparison.m_AbsoluteTolerance = std::atof(argv[i] + 7);
+    else
+      files.push_back(argv[i]);
+  }
+
+  if (files.size() != 4) {
+    std::fprintf(stderr,
+                 "Usage: %s [--rtol=1e-9] [--atol=1e-12] "
+                 "<expected-report.json> <expected-lp-metrics.bin> "
+                 "<actual-report.json> <actual-lp-metrics.bin>\n",
+                 argv[0]);
+    return 1;
+  }
+
+  FlatJson expectedReport, actualReport;
+  ispd::metrics::LpMetricsHeader expectedHeader, actualHeader;
+  LpRecords expectedLps, actualLps;
+
+  if (!readReport(files[0], expectedReport) ||
+      !readLpMetrics(files[1], expectedHeader, expectedLps) ||
+      !readReport(files[2], actualReport) ||
+      !readLpMetrics(files[3], actualHeader, actualLps))
+    return 1;
+
+  if (std::memcmp(expectedHeader.m_Columns, actualHeader.m_Columns,
+                  sizeof(expectedHeader.m_Columns)) != 0) {
+    std::fprintf(stderr, "The LP metrics files have different schemas.\n");
+    return 1;
+  }
+
+  compareReports(comparison, expectedReport, actualReport);
+  compareLpMetrics(comparison, expectedHeader, expectedLps, actualLps);
+
+  std::printf("%zu metrics compared, %zu mismatches.\n", comparison.m_Compared,
+              comparison.m_Mismatches);
+  return comparison.m_Mismatches ? 1 : 0;
+}
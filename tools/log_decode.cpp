@@ -0,0 +1,248 @@
+/// \file log_decode.cpp
+///
+/// \brief This file implements the `ispd_log_decode` tool, which renders a
+/// binary log written by `ispd` as text.
+///
+/// Usage: ispd_log_decode <prefix.rank.log> [output.txt]
+///
+/// Each message is rendered as a line with the seconds elapsed since the log
+/// has been opened, its log level, its call site and its formatted text. The
+/// messages are formatted here, using the format strings of their call sites,
+/// instead of by the simulation.
+///
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <unordered_map>
+#include <ispd/log/log.hpp>
+#include <ispd/log/binary_log.hpp>
+
+using ispd::log::LogArgument;
+using ispd::log::LogArgumentTag;
+
+namespace {
+
+/// \brief A call site's definition.
+struct Site {
+  std::uint8_t m_Level;
+  std::uint32_t m_Line;
+  std::string m_File;
+  std::string m_Format;
+};
+
+/// \brief A decoded argument, whose string (if any) is owned.
+struct Argument {
+  LogArgument m_Raw;
+  std::string m_String;
+};
+
+template <typename T> bool read(std::FILE *input, T &value) {
+  return std::fread(&value, sizeof(T), 1, input) == 1;
+}
+
+bool readString(std::FILE *input, std::string &string) {
+  std::uint16_t length;
+  if (!read(input, length))
+    return false;
+
+  string.resize(length);
+  return std::fread(string.data(), 1, length, input) == length;
+}
+
+/// \brief Formats a single conversion, whose specification has no length
+///        modifier, with the specified argument.
+void formatConversion(std::string &out, const std::string &spec,
+                      const char conversion, const Argument *arg) {
+  char buffer[2048];
+
+  if (!arg) {
+    out += "<missing>";
+    return;
+  }
+
+  const auto &raw = arg->m_Raw;
+  const bool isDouble = raw.m_Tag == LogArgumentTag::DOUBLE;
+
+  switch (conversion) {
+  case 'd':
+  case 'i':
+    std::snprintf(buffer, sizeof(buffer), (spec + "lld").c_str(),
+                  isDouble ? static_cast<long long>(raw.m_Double)
+                           : static_cast<long long>(raw.m_Signed));
+    break;
+  case 'u':
+  case 'o':
+  case 'x':
+  case 'X':
+    std::snprintf(buffer, sizeof(buffer), (spec + "ll" + conversion).c_str(),
+                  isDouble ? static_cast<unsigned long long>(raw.m_Double)
+                           : static_cast<unsigned long long>(raw.m_Unsigned));
+    break;
+  case 'c':
+    std::snprintf(buffer, sizeof(buffer), (spec + "c").c_str(),
+                  static_cast<int>(raw.m_Signed));
+    break;
+  case 's':
+    std::snprintf(buffer, sizeof(buffer), (spec + "s").c_str(),
+                  raw.m_Tag == LogArgumentTag::STRING ? arg->m_String.c_str()
+                                                      : "<not a string>");
+    break;
+  case 'p':
+    std::snprintf(buffer, sizeof(buffer), (spec + "p").c_str(),
+                  raw.m_Pointer);
+    break;
+  default:
+    /// The remaining conversions are the floating-point ones.
+    std::snprintf(buffer, sizeof(buffer), (spec + conversion).c_str(),
+                  isDouble ? raw.m_Double
+                           : static_cast<double>(raw.m_Signed));
+    break;
+  }
+
+  out += buffer;
+}
+
+/// \brief Formats a message as `printf` would have formatted it.
+std::string format(const std::string &fmt, const std::vector<Argument> &args) {
+  std::string out;
+  std::size_t next = 0;
+
+  const auto nextArgument = [&]() -> const Argument * {
+    return next < args.size() ? &args[next++] : nullptr;
+  };
+
+  for (std::size_t i = 0; i < fmt.size(); i++) {
+    if (fmt[i] != '%') {
+      out += fmt[i];
+      continue;
+    }
+
+    if (i + 1 < fmt.size() && fmt[i + 1] == '%') {
+      out += '%';
+      i++;
+      continue;
+    }
+
+    /// Copies the flags, the width and the precision, replacing the `*` by the
+    /// arguments that they consume, and skips the length modifiers.
+    std::string spec = "%";
+    for (i++; i < fmt.size(); i++) {
+      const char c = fmt[i];
+
+      if (c == '*') {
+        const Argument *arg = nextArgument();
+        spec += std::to_string(arg ? arg->m_Raw.m_Signed : 0);
+      } else if (std::strchr("-+ #0123456789.", c)) {
+        spec += c;
+      } else if (!std::strchr("hlLqjzt", c)) {
+        break;
+      }
+    }
+
+    if (i >= fmt.size())
+      break;
+
+    formatConversion(out, spec, fmt[i], nextArgument());
+  }
+
+  return out;
+}
+
+}; // namespace
+
+int main(int argc, char **argv) {
+  if (argc < 2 || argc > 3) {
+    std::fprintf(stderr, "Usage: %s <prefix.rank.log> [output.txt]\n",
+                 argv[0]);
+    return 1;
+  }
+
+  std::FILE *input = std::fopen(argv[1], "rb");
+  if (!input) {
+    std::fprintf(stderr, "Binary log %s could not be opened.\n", argv[1]);
+    return 1;
+  }
+
+  ispd::log::BinaryLogHeader header;
+  if (std::fread(&header, sizeof(header), 1, input) != 1 ||
+      std::memcmp(header.m_Magic, "ISPDLOG", 8) != 0) {
+    std::fprintf(stderr, "%s is not a valid binary log.\n", argv[1]);
+    return 1;
+  }
+
+  if (header.m_Version != ispd::log::BINARY_LOG_VERSION) {
+    std::fprintf(stderr, "%s has version %u but version %u is expected.\n",
+                 argv[1], header.m_Version, ispd::log::BINARY_LOG_VERSION);
+    return 1;
+  }
+
+  std::FILE *output = argc == 3 ? std::fopen(argv[2], "w") : stdout;
+  if (!output) {
+    std::fprintf(stderr, "Text file %s could not be opened.\n", argv[2]);
+    return 1;
+  }
+
+  std::unordered_map<std::uint32_t, Site> sites;
+  std::vector<Argument> args;
+  ispd::log::BinaryLogRecord kind;
+
+  while (read(input, kind)) {
+    std::uint32_t id;
+    bool valid = read(input, id);
+
+    if (valid && kind == ispd::log::BinaryLogRecord::SITE) {
+      Site &site = sites[id];
+      valid = read(input, site.m_Level) && read(input, site.m_Line) &&
+              readString(input, site.m_File) &&
+              readString(input, site.m_Format) &&
+              site.m_Level < std::size(ispd::log::levels);
+    } else if (valid && kind == ispd::log::BinaryLogRecord::MESSAGE) {
+      std::uint64_t elapsed;
+      std::uint8_t count;
+      valid = read(input, elapsed) && read(input, count);
+
+      args.resize(count);
+      for (std::uint8_t i = 0; valid && i < count; i++) {
+        valid = read(input, args[i].m_Raw.m_Tag);
+
+        if (valid && args[i].m_Raw.m_Tag == LogArgumentTag::STRING)
+          valid = readString(input, args[i].m_String);
+        else if (valid)
+          valid = read(input, args[i].m_Raw.m_Unsigned);
+      }
+
+      const auto it = sites.find(id);
+      if (valid && it == sites.end()) {
+        std::fprintf(stderr, "%s has a message of the undefined site %u.\n",
+                     argv[1], id);
+        return 1;
+      }
+
+      if (valid) {
+        const Site &site = it->second;
+        std::fprintf(output, "[%.9f] %-5s %s:%u: %s\n", elapsed * 1e-9,
+                     ispd::log::levels[site.m_Level].name,
+                     site.m_File.c_str(), site.m_Line,
+                     format(site.m_Format, args).c_str());
+      }
+    } else {
+      valid = false;
+    }
+
+    /// A log whose writer has been killed may end with a partial record,
+    /// which is reported and ignored.
+    if (!valid) {
+      std::fprintf(stderr, "%s ends with a truncated or invalid record.\n",
+                   argv[1]);
+      break;
+    }
+  }
+
+  std::fclose(input);
+  if (output != stdout)
+    std::fclose(output);
+
+  return 0;
+}
@@ -0,0 +1,123 @@
+/// \file lp_metrics.cpp
+///
+/// \brief This file implements the `ispd_lp_metrics` tool, which converts a
+/// per-LP metrics file written by `ispd` to CSV.
+///
+/// Usage: ispd_lp_metrics <lp-metrics.bin> [output.csv]
+///
+/// The CSV has a `gid` and a `type` column, followed by the union of the
+/// column names of every service type in the file's schema. The columns that
+/// do not apply to a logical process' service type are left empty.
+///
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <ispd/metrics/lp_metrics.hpp>
+
+int main(int argc, char **argv) {
+  if (argc < 2 || argc > 3) {
+    std::fprintf(stderr, "Usage: %s <lp-metrics.bin> [output.csv]\n", argv[0]);
+    return 1;
+  }
+
+  std::FILE *input = std::fopen(argv[1], "rb");
+  if (!input) {
+    std::fprintf(stderr, "LP metrics file %s could not be opened.\n", argv[1]);
+    return 1;
+  }
+
+  ispd::metrics::LpMetricsHeader header;
+  if (std::fread(&header, sizeof(header), 1, input) != 1 ||
+      std::memcmp(header.m_Magic, "ISPDLPM", 8) != 0) {
+    std::fprintf(stderr, "%s is not a valid LP metrics file.\n", argv[1]);
+    return 1;
+  }
+
+  if (header.m_Version != ispd::metrics::LP_METRICS_VERSION ||
+      header.m_RecordSize != sizeof(ispd::metrics::LpMetricsRecord) ||
+      header.m_TypeCount != ispd::metrics::LP_METRICS_TYPES ||
+      header.m_ColumnCount != ispd::metrics::LP_METRICS_COLUMNS) {
+    std::fprintf(stderr,
+                 "%s has version %u and a schema that this tool does not "
+                 "support (version %u is expected).\n",
+                 argv[1], header.m_Version, ispd::metrics::LP_METRICS_VERSION);
+    return 1;
+  }
+
+  std::FILE *output = argc == 3 ? std::fopen(argv[2], "w") : stdout;
+  if (!output) {
+    std::fprintf(stderr, "CSV file %s could not be opened.\n", argv[2]);
+    return 1;
+  }
+
+  /// Build the union of the column names and where each service type's
+  /// column is placed in it.
+  std::vector<std::string> columns;
+  std::size_t placement[ispd::metrics::LP_METRICS_TYPES]
+                       [ispd::metrics::LP_METRICS_COLUMNS];
+
+  for (std::size_t type = 0; type < header.m_TypeCount; type++) {
+    for (std::size_t column = 0; column < header.m_ColumnCount; column++) {
+      const std::string name(header.m_Columns[type][column],
+                             strnlen(header.m_Columns[type][column],
+                                     ispd::metrics::LP_METRICS_COLUMN_NAME));
+
+      if (name.empty())
+        continue;
+
+      const auto it = std::find(columns.begin(), columns.end(), name);
+      placement[type][column] = it - columns.begin();
+
+      if (it == columns.end())
+        columns.push_back(name);
+    }
+  }
+
+  std::fprintf(output, "gid,type");
+  for (const auto &column : columns)
+    std::fprintf(output, ",%s", column.c_str());
+  std::fprintf(output, "\n");
+
+  std::vector<const double *> row(columns.size());
+  ispd::metrics::LpMetricsRecord record;
+
+  for (std::uint64_t i = 0; i < header.m_Count; i++) {
+    if (std::fread(&record, sizeof(record), 1, input) != 1) {
+      std::fprintf(stderr, "%s is truncated (%lu of %lu records).\n", argv[1],
+                   static_cast<unsigned long>(i),
+                   static_cast<unsigned long>(header.m_Count));
+      return 1;
+    }
+
+    if (record.m_Type >= header.m_TypeCount ||
+        record.m_ColumnCount > header.m_ColumnCount) {
+      std::fprintf(stderr, "LP %lu has an invalid record.\n",
+                   static_cast<unsigned long>(record.m_Gid));
+      return 1;
+    }
+
+    std::fill(row.begin(), row.end(), nullptr);
+    for (std::size_t column = 0; column < record.m_ColumnCount; column++)
+      row[placement[record.m_Type][column]] = &record.m_Values[column];
+
+    std::fprintf(output, "%lu,%s", static_cast<unsigned long>(record.m_Gid),
+                 ispd::services::getServiceTypeName(
+                     static_cast<ispd::services::ServiceType>(record.m_Type)));
+
+    for (const double *value : row) {
+      if (value)
+        std::fprintf(output, ",%.17g", *value);
+      else
+        std::fprintf(output, ",");
+    }
+    std::fprintf(output, "\n");
+  }
+
+  std::fclose(input);
+  if (output != stdout)
+    std::fclose(output);
+
+  return 0;
+}